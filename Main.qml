@@ -23,14 +23,21 @@ ApplicationWindow {
         property int defaultReps: 10
     }
 
-    // 1. Instancia los objetos directamente en QML
+    // 1. Instancia los objetos directamente en QML (la carga de datos se hace en segundo plano)
     DataCenter {
         id: dataCenter
-        onDataChanged: exerciseModel.loadFromJson(data)
+        onReadyChanged: {
+            if (ready) {
+                StartupProfiler.mark("dataReady")
+                stackView.initialize()
+            }
+        }
     }
 
+    // El modelo lee directamente del almacén de dataCenter y recibe los cambios por ejercicio
     ExerciseModel {
         id: exerciseModel
+        dataCenter: dataCenter
     }
 
     MessagePopup {
@@ -45,6 +52,19 @@ ApplicationWindow {
         }
     }
 
+    // Deshacer/rehacer cualquier cambio de datos desde cualquier página
+    Shortcut {
+        sequence: StandardKey.Undo
+        enabled: dataCenter.canUndo
+        onActivated: dataCenter.undo()
+    }
+
+    Shortcut {
+        sequence: StandardKey.Redo
+        enabled: dataCenter.canRedo
+        onActivated: dataCenter.redo()
+    }
+
     // 2. StackView para la carga de paginas
     StackView {
         id: stackView
@@ -92,6 +112,8 @@ ApplicationWindow {
         }
 
         function initialize() {
+             if (stackView.depth > 0)
+                 return
              stackView.push("qml/MenuPage.qml", {
                  exerciseModel: exerciseModel,
                  dataCenter: dataCenter
@@ -125,16 +147,14 @@ ApplicationWindow {
     }
 
     Component.onCompleted: {
-
-        // Carga inicial de los datos
-        exerciseModel.loadFromJson(dataCenter.data)
-
-        // Inicializar la primera página con propiedades
-        stackView.initialize()
+        // La primera página se crea cuando los datos están listos
+        if (dataCenter.ready)
+            stackView.initialize()
     }
 
     Splash {
         id: splash
+        ready: dataCenter.ready
         Component.onDestruction: {
             console.log("Splash destruida")
             started = true
@@ -0,0 +1,845 @@
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QSettings>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+#include <cmath>
+#include "binarysnapshot.h"
+#include "datacenter.h"
+#include "datasetgenerator.h"
+#include "exercisecatalog.h"
+#include "exerciseexporter.h"
+#include "exercisefiltermodel.h"
+#include "exerciseimporter.h"
+#include "exercisemodel.h"
+#include "exerciseprovider.h"
+#include "exercisesearchmodel.h"
+#include "historyanalytics.h"
+#include "historylistmodel.h"
+#include "historyseriesmodel.h"
+#include "seriesdownsampler.h"
+#include "storagebackend.h"
+
+// Rendimiento de la capa de datos con conjuntos sintéticos de distinto tamaño.
+// Los datos se escriben en el directorio de pruebas de QStandardPaths, así que
+// nunca se toca el de la app real. BENCH_STORAGE_BACKEND=sqlite repite la suite
+// con el motor SQLite en vez del binario.
+class BenchDataCenter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void generatorIsDeterministic();
+
+    void load_data() { datasets(); }
+    void load();
+    void legacyJson_data() { datasets(); }
+    void legacyJson();
+    void save_data() { datasets(); }
+    void save();
+    void updateExercise_data() { datasets(); }
+    void updateExercise();
+    void removeHistoryEntry_data() { datasets(); }
+    void removeHistoryEntry();
+    void storageRoundTrip_data() { datasets(); }
+    void storageRoundTrip();
+    void undoRedo_data() { datasets(); }
+    void undoRedo();
+    void batch_data();
+    void batch();
+    void historyDetailed_data() { datasets(); }
+    void historyDetailed();
+    void historySeries_data() { datasets(); }
+    void historySeries();
+    void exerciseStats_data() { datasets(); }
+    void exerciseStats();
+    void analytics_data() { datasets(); }
+    void analytics();
+    void rollup_data() { datasets(); }
+    void rollup();
+    void importJson_data() { datasets(); }
+    void importJson();
+    void importCsv();
+    void exportData_data() { datasets(); }
+    void exportData();
+    void downsample_data();
+    void downsample();
+
+    void modelData_data() { datasets(); }
+    void modelData();
+    void modelHistoryRole_data() { datasets(); }
+    void modelHistoryRole();
+    void filterSearch_data() { datasets(); }
+    void filterSearch();
+
+    void catalogIsSortedAndUnique();
+    void providerConstruction();
+    void searchMatchesAliases();
+    void search();
+
+private:
+    QHash<QString, ExerciseStore> m_stores;
+    StorageBackend::Kind m_backend = StorageBackend::Binary;
+
+    void datasets();
+    const ExerciseStore& dataset();
+    static bool waitForReady(DataCenter& dataCenter);
+    static QMap<QString, QList<double>> monthlyRollup(const ExerciseStore& store);
+};
+
+void BenchDataCenter::initTestCase() {
+    QStandardPaths::setTestModeEnabled(true);
+    QCoreApplication::setOrganizationName("dreSoft");
+    QCoreApplication::setApplicationName("Weight & See Benchmarks");
+
+    // QSettings también en el directorio de pruebas: ahí se elige el motor
+    QSettings::setDefaultFormat(QSettings::IniFormat);
+    QSettings::setPath(QSettings::IniFormat, QSettings::UserScope,
+                       QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation));
+    m_backend = StorageBackend::kindFromName(qEnvironmentVariable("BENCH_STORAGE_BACKEND"));
+    QSettings().setValue(StorageBackend::kSettingsKey, StorageBackend::kindName(m_backend));
+    qInfo() << "Motor de almacenamiento:" << StorageBackend::kindName(m_backend);
+}
+
+void BenchDataCenter::cleanupTestCase() {
+    QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).removeRecursively();
+}
+
+void BenchDataCenter::datasets() {
+    QTest::addColumn<int>("exercises");
+    QTest::addColumn<int>("records");
+
+    QTest::newRow("50x5k") << 50 << 5000;
+    QTest::newRow("200x20k") << 200 << 20000;
+    QTest::newRow("1kx100k") << 1000 << 100000;
+}
+
+const ExerciseStore& BenchDataCenter::dataset() {
+    QFETCH(int, exercises);
+    QFETCH(int, records);
+
+    // Se genera una vez por tamaño y se reinstala antes de cada prueba
+    const QString key = QString::fromLatin1(QTest::currentDataTag());
+    if (!m_stores.contains(key))
+        m_stores.insert(key, DatasetGenerator::generate(exercises, records));
+
+    const ExerciseStore& store = m_stores[key];
+    if (!DatasetGenerator::install(store, m_backend))
+        qFatal("No se pudo escribir el conjunto de datos de prueba");
+    return store;
+}
+
+bool BenchDataCenter::waitForReady(DataCenter& dataCenter) {
+    QSignalSpy spy(&dataCenter, &DataCenter::loadingChanged);
+    while (dataCenter.isLoading()) {
+        if (!spy.wait(60000))
+            return false;
+    }
+    return dataCenter.isReady();
+}
+
+void BenchDataCenter::generatorIsDeterministic() {
+    const ExerciseStore a = DatasetGenerator::generate(20, 2000, 7);
+    const ExerciseStore b = DatasetGenerator::generate(20, 2000, 7);
+    QCOMPARE(a.count(), 20);
+    QCOMPARE(QJsonDocument(a.toJson()).toJson(), QJsonDocument(b.toJson()).toJson());
+
+    int total = 0;
+    for (int i = 0; i < a.count(); ++i)
+        total += a.at(i).history.size();
+    QCOMPARE(total, 2000);
+
+    // Más ejercicios que nombres en el catálogo: se numeran
+    const int catalogSize = ExerciseCatalog::kCount;
+    QCOMPARE(DatasetGenerator::generate(catalogSize + 1, 0).count(), catalogSize + 1);
+}
+
+void BenchDataCenter::load() {
+    const ExerciseStore& store = dataset();
+
+    QBENCHMARK {
+        DataCenter dataCenter;
+        QVERIFY(waitForReady(dataCenter));
+        QCOMPARE(dataCenter.store().count(), store.count());
+    }
+}
+
+void BenchDataCenter::legacyJson() {
+    // Formato antiguo: sólo se lee al migrar o importar
+    const QJsonObject root = dataset().toJson();
+    QBENCHMARK {
+        const ExerciseStore store = ExerciseStore::fromJson(root);
+        QVERIFY(store.count() > 0);
+    }
+}
+
+void BenchDataCenter::save() {
+    dataset();
+    DataCenter dataCenter;
+    QVERIFY(waitForReady(dataCenter));
+
+    QBENCHMARK {
+        dataCenter.save();
+    }
+}
+
+void BenchDataCenter::updateExercise() {
+    const ExerciseStore& store = dataset();
+    DataCenter dataCenter;
+    QVERIFY(waitForReady(dataCenter));
+    dataCenter.setSaveDelay(std::numeric_limits<int>::max());
+
+    int row = 0;
+    QBENCHMARK {
+        const ExerciseStore::Exercise& exercise = store.at(row++ % store.count());
+        dataCenter.updateExercise(exercise.name, exercise.currentValue + 2.5, "kg", 4, 8);
+    }
+
+    // Lo que no cabe en las columnas del historial se rechaza, no se trunca
+    ExerciseStore copy = store;
+    const QString name = copy.at(0).name;
+    const int size = copy.at(0).history.size();
+    ExerciseStore::Record record;
+    record.timestamp = 0;
+    record.sets = 3;
+    record.repetitions = ExerciseStore::kMaxCount + 1;
+    QCOMPARE(copy.addRecord(name, record), -1);
+    for (int i = copy.units().size(); i < ExerciseStore::kMaxUnits; ++i)
+        QVERIFY(copy.internUnit(QString("bench unit %1").arg(i)) >= 0);
+    QCOMPARE(copy.internUnit("bench unit overflow"), -1);
+    QCOMPARE(copy.at(0).history.size(), size);
+}
+
+void BenchDataCenter::removeHistoryEntry() {
+    const ExerciseStore& store = dataset();
+    DataCenter dataCenter;
+    QVERIFY(waitForReady(dataCenter));
+    dataCenter.setSaveDelay(std::numeric_limits<int>::max());
+
+    // Se reparte entre ejercicios: la primera vez cada historial se materializa
+    int row = 0;
+    QBENCHMARK {
+        dataCenter.removeHistoryEntry(store.at(row++ % store.count()).name, 0);
+    }
+}
+
+void BenchDataCenter::storageRoundTrip() {
+    const ExerciseStore& store = dataset();
+    const QString other = StorageBackend::kindName(m_backend == StorageBackend::Binary
+                                                   ? StorageBackend::Sqlite : StorageBackend::Binary);
+    QJsonObject expected;
+    {
+        DataCenter dataCenter;
+        QVERIFY(waitForReady(dataCenter));
+        QCOMPARE(dataCenter.storageBackend(), StorageBackend::kindName(m_backend));
+        dataCenter.setSaveDelay(std::numeric_limits<int>::max());
+
+        // Lo que se escribe registro a registro tiene que volver igual al cargar
+        const QString name = store.at(0).name;
+        dataCenter.updateExercise(name, 100, "kg", 5, 5);
+        dataCenter.removeHistoryEntry(name, 0);
+        dataCenter.removeExercise(store.at(1).name);
+        dataCenter.undo();
+        dataCenter.addExercise("Bench migration", "Chest", 20, "kg", 3, 12);
+        expected = dataCenter.data();
+        dataCenter.flush();
+    }
+
+    QBENCHMARK_ONCE {
+        DataCenter dataCenter;
+        QVERIFY(waitForReady(dataCenter));
+        QCOMPARE(dataCenter.data(), expected);
+
+        // Migrar al otro motor y volver deja los datos intactos
+        dataCenter.setStorageBackend(other);
+        QCOMPARE(dataCenter.storageBackend(), other);
+    }
+
+    {
+        DataCenter dataCenter;
+        QVERIFY(waitForReady(dataCenter));
+        QCOMPARE(dataCenter.storageBackend(), other);
+        QCOMPARE(dataCenter.data(), expected);
+        dataCenter.setStorageBackend(StorageBackend::kindName(m_backend));
+    }
+
+    DataCenter dataCenter;
+    QVERIFY(waitForReady(dataCenter));
+    QCOMPARE(dataCenter.storageBackend(), StorageBackend::kindName(m_backend));
+    QCOMPARE(dataCenter.data(), expected);
+}
+
+void BenchDataCenter::undoRedo() {
+    const ExerciseStore& store = dataset();
+    DataCenter dataCenter;
+    QVERIFY(waitForReady(dataCenter));
+    dataCenter.setSaveDelay(std::numeric_limits<int>::max());
+
+    const QString name = store.at(0).name;
+    const QJsonObject before = dataCenter.store().exerciseToJson(0);
+
+    dataCenter.removeHistoryEntry(name, 0);
+    dataCenter.removeExercise(name);
+    QVERIFY(!dataCenter.store().contains(name));
+
+    // Deshacer y rehacer el borrado sólo toca ese ejercicio
+    QBENCHMARK {
+        dataCenter.undo();
+        dataCenter.redo();
+    }
+
+    dataCenter.undo();
+    dataCenter.undo();
+    QVERIFY(!dataCenter.canUndo());
+    QVERIFY(dataCenter.canRedo());
+    QCOMPARE(dataCenter.store().exerciseToJson(dataCenter.store().indexOf(name)), before);
+
+    // Con presupuesto cero no queda nada que deshacer
+    dataCenter.setUndoMemoryBudget(0);
+    QVERIFY(!dataCenter.canRedo());
+    dataCenter.removeExercise(name);
+    QVERIFY(!dataCenter.canUndo());
+}
+
+void BenchDataCenter::batch_data() {
+    QTest::addColumn<int>("exercises");
+    QTest::addColumn<int>("records");
+    QTest::addColumn<bool>("batched");
+
+    // Un entrenamiento: 20 ejercicios registrados seguidos, uno a uno o en una transacción
+    QTest::newRow("200x20k/single") << 200 << 20000 << false;
+    QTest::newRow("200x20k/batch") << 200 << 20000 << true;
+}
+
+void BenchDataCenter::batch() {
+    const ExerciseStore& store = dataset();
+    QFETCH(bool, batched);
+    DataCenter dataCenter;
+    QVERIFY(waitForReady(dataCenter));
+    dataCenter.setSaveDelay(std::numeric_limits<int>::max());
+    ExerciseModel model;
+    model.setDataCenter(&dataCenter);
+
+    constexpr int kWorkout = 20;
+    QVariantList workout;
+    for (int i = 0; i < kWorkout; ++i) {
+        const ExerciseStore::Exercise& exercise = store.at(i % store.count());
+        workout.append(QVariantMap{
+            {"op", "updateExercise"},
+            {"name", exercise.name},
+            {"value", exercise.currentValue + 2.5},
+            {"unit", "kg"},
+            {"sets", 4},
+            {"repetitions", 8}
+        });
+    }
+
+    const auto logWorkout = [&]() {
+        if (batched)
+            return dataCenter.applyBatch(workout);
+        for (const QVariant& value : std::as_const(workout)) {
+            const QVariantMap update = value.toMap();
+            dataCenter.updateExercise(update["name"].toString(), update["value"].toDouble(), "kg", 4, 8);
+        }
+        return true;
+    };
+
+    QBENCHMARK {
+        QVERIFY(logWorkout());
+    }
+
+    // Una transacción es un solo aviso (y un solo registro del diario)
+    QSignalSpy changed(&dataCenter, &DataCenter::dataChanged);
+    QVERIFY(logWorkout());
+    QCOMPARE(changed.size(), batched ? 1 : kWorkout);
+
+    // Todo o nada: una operación inválida descarta las anteriores
+    const QString name = store.at(0).name;
+    const int records = dataCenter.store().find(name)->history.size();
+    workout.append(QVariantMap{{"op", "removeExercise"}, {"name", "No existe"}});
+    QVERIFY(!dataCenter.applyBatch(workout));
+    QCOMPARE(dataCenter.store().find(name)->history.size(), records);
+    QVERIFY(!dataCenter.isBatching());
+
+    // Los reinicios del almacén no entran en una transacción abierta
+    dataCenter.beginBatch();
+    dataCenter.deleteAllExercises();
+    QCOMPARE(dataCenter.store().count(), store.count());
+    dataCenter.rollback();
+    QVERIFY(!dataCenter.isBatching());
+}
+
+void BenchDataCenter::historyDetailed() {
+    const ExerciseStore& store = dataset();
+    DataCenter dataCenter;
+    QVERIFY(waitForReady(dataCenter));
+
+    const QString name = store.at(0).name;
+    QBENCHMARK {
+        const QVariantList history = dataCenter.getExerciseHistoryDetailed(name);
+        QCOMPARE(history.size(), store.at(0).history.size());
+    }
+}
+
+void BenchDataCenter::historySeries() {
+    const ExerciseStore& store = dataset();
+    DataCenter dataCenter;
+    QVERIFY(waitForReady(dataCenter));
+    dataCenter.setSaveDelay(std::numeric_limits<int>::max());
+
+    const ExerciseStore::Exercise& exercise = store.at(0);
+    HistorySeriesModel series;
+    series.setDataCenter(&dataCenter);
+    series.setExerciseName(exercise.name);
+    QCOMPARE(series.count(), exercise.history.size());
+
+    // Cada registro nuevo entra como una fila más, sin reiniciar el modelo
+    QSignalSpy resets(&series, &QAbstractItemModel::modelReset);
+    int expected = series.count();
+    double record = series.maxValue();
+    QBENCHMARK {
+        const double value = record + 2.5;
+        dataCenter.updateExercise(exercise.name, value, "kg", 4, 8);
+        QCOMPARE(series.count(), ++expected);
+        QCOMPARE(series.maxValue(), value);
+        record = value;
+    }
+    QCOMPARE(resets.count(), 0);
+
+    // El periodo sólo recorta por delante: los registros nuevos son de hoy
+    series.setPeriod(1);
+    QVERIFY(series.count() > 0);
+    QCOMPARE(series.lastValue(), record);
+    QVERIFY(series.hasDataForPeriod(1));
+}
+
+void BenchDataCenter::exerciseStats() {
+    ExerciseStore store = dataset();
+    const int row = 0;
+    const QString name = store.at(row).name;
+    store.stats(row);
+
+    // Añadir y borrar (récord incluido) sólo toca la aportación del registro
+    const auto compare = [&]() {
+        const ExerciseStats& incremental = store.stats(row);
+        const ExerciseStats full = store.computeStats(store.at(row).history);
+        QCOMPARE(incremental.recordCount(), full.recordCount());
+        QCOMPARE(incremental.personalRecord(), full.personalRecord());
+        QCOMPARE(incremental.personalRecordTimestamp(), full.personalRecordTimestamp());
+        QCOMPARE(incremental.oneRepMax(), full.oneRepMax());
+        QCOMPARE(incremental.sessionCount(), full.sessionCount());
+        QCOMPARE(incremental.trend(), full.trend());
+        QVERIFY(qAbs(incremental.totalVolume() - full.totalVolume()) <= 1e-6 * qMax(1.0, full.totalVolume()));
+    };
+
+    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+    QBENCHMARK {
+        ExerciseStore::Record record;
+        record.timestamp = ++timestamp;
+        record.value = store.stats(row).personalRecord() + 2.5;
+        record.sets = 4;
+        record.repetitions = 8;
+        record.unitId = store.internUnit("kg");
+        store.addRecord(name, record);
+        store.removeRecord(name, store.at(row).history.size() - 1);
+    }
+    compare();
+
+    // Borrar el récord obliga a buscar el siguiente
+    for (int i = 0; i < 10 && store.at(row).history.size() > 0; ++i) {
+        const ExerciseStore::History& history = store.at(row).history;
+        const ExerciseStats& stats = store.stats(row);
+        const auto isRecord = [&](int i) {
+            const double value = history.unitIdAt(i) != 0 ? history.valueAt(i) : history.repetitionsAt(i);
+            return history.timestampAt(i) == stats.personalRecordTimestamp() && value == stats.personalRecord();
+        };
+        int index = 0;
+        while (index < history.size() && !isRecord(index))
+            ++index;
+        QVERIFY(index < history.size());
+        store.removeRecord(name, index);
+        compare();
+    }
+}
+
+void BenchDataCenter::analytics() {
+    const ExerciseStore& store = dataset();
+    HistoryAnalytics analytics;
+
+    // Recálculo completo en cada iteración
+    QBENCHMARK {
+        analytics.invalidate();
+        analytics.compute(store);
+    }
+
+    const HistoryAnalytics::Result& result = analytics.compute(store);
+    QCOMPARE(result.version, store.version());
+    QCOMPARE(result.exercises.size(), store.count());
+
+    // Mismo resultado que un recorrido directo del primer ejercicio
+    const ExerciseStore::History& history = store.at(0).history;
+    const HistoryAnalytics::ExerciseResult& first = result.exercises.at(0);
+    QCOMPARE(first.count, history.size());
+    double sumT = 0, sumV = 0, sumTT = 0, sumTV = 0, volume = 0;
+    for (int i = 0; i < history.size(); ++i) {
+        const double factor = HistoryAnalytics::unitFactor(store.unit(history.unitIdAt(i)));
+        const double weight = history.valueAt(i) * factor;
+        const double value = history.unitIdAt(i) != 0 ? weight : history.repetitionsAt(i);
+        const double t = (history.timestampAt(i) - history.timestampAt(0)) / (7.0 * 24 * 60 * 60 * 1000);
+        sumT += t;
+        sumV += value;
+        sumTT += t * t;
+        sumTV += t * value;
+        volume += weight * history.setsAt(i) * history.repetitionsAt(i);
+    }
+    const int n = history.size();
+    const double slope = n > 1 ? (n * sumTV - sumT * sumV) / (n * sumTT - sumT * sumT) : 0;
+    QVERIFY(qAbs(first.slope - slope) <= 1e-6 * qMax(1.0, qAbs(slope)));
+    QVERIFY(qAbs(first.volume - volume) <= 1e-6 * qMax(1.0, volume));
+    // El volumen de las estadísticas del ejercicio también va en kg
+    const double statsVolume = store.stats(0).totalVolume();
+    QVERIFY(qAbs(statsVolume - volume) <= 1e-6 * qMax(1.0, volume));
+}
+
+QMap<QString, QList<double>> BenchDataCenter::monthlyRollup(const ExerciseStore& store) {
+    // Por nombre de grupo: cada almacén puede haber asignado otros ids
+    const QStringList groups = store.muscleGroups();
+    const auto buckets = store.rollup().buckets(TrainingRollup::Month, QDate(1970, 1, 1), QDate(2100, 1, 1));
+    QMap<QString, QList<double>> result;
+    for (auto it = buckets.cbegin(); it != buckets.cend(); ++it) {
+        for (int group = 0; group < it.value().size(); ++group) {
+            const TrainingRollup::Bucket& bucket = it.value().at(group);
+            if (bucket.records > 0) {
+                result.insert(QString::number(it.key()) + groups.at(group),
+                              {double(bucket.sets), double(bucket.repetitions), std::round(bucket.volume),
+                               double(bucket.sessions), double(bucket.records)});
+            }
+        }
+    }
+    return result;
+}
+
+void BenchDataCenter::rollup() {
+    ExerciseStore store = dataset();
+    const QDate from(1970, 1, 1), to(2100, 1, 1);
+
+    // Borrados repartidos: el índice se actualiza restando cada registro
+    for (int row = 0; row < store.count(); row += 3) {
+        const QString name = store.at(row).name;
+        if (store.at(row).history.size() > 1)
+            store.removeRecord(name, store.at(row).history.size() / 2);
+    }
+    if (store.count() > 1)
+        store.removeExercise(store.at(1).name);
+
+    const ExerciseStore rebuilt = ExerciseStore::fromJson(store.toJson());
+    QCOMPARE(store.rollup().trainingDays(from, to), rebuilt.rollup().trainingDays(from, to));
+    QCOMPARE(monthlyRollup(store), monthlyRollup(rebuilt));
+
+    // Se guarda con el snapshot y se recupera tal cual
+    QTemporaryDir dir;
+    const QString path = dir.filePath("rollup.wsdb");
+    QVERIFY(BinarySnapshot::write(store, 0, path));
+    const ExerciseStore loaded = ExerciseStore::fromSnapshot(BinarySnapshot::open(path));
+    QCOMPARE(loaded.rollup().trainingDays(from, to), store.rollup().trainingDays(from, to));
+    QCOMPARE(monthlyRollup(loaded), monthlyRollup(store));
+
+    // Un año de semanas y de días: sólo recorre los tramos del rango
+    const QDate today = QDate::currentDate();
+    QBENCHMARK {
+        const auto weeks = store.rollup().buckets(TrainingRollup::Week, today.addYears(-1), today);
+        const int days = store.rollup().trainingDays(today.addYears(-1), today);
+        QVERIFY(weeks.size() <= 54);
+        QVERIFY(days <= 367);
+    }
+}
+
+void BenchDataCenter::importJson() {
+    const ExerciseStore& store = dataset();
+    QTemporaryDir dir;
+    const QString path = dir.filePath("backup.json");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QJsonDocument(store.toJson()).toJson(QJsonDocument::Compact));
+    file.close();
+
+    int total = 0;
+    for (int row = 0; row < store.count(); ++row)
+        total += store.at(row).history.size();
+
+    ExerciseImporter::Result result;
+    QBENCHMARK {
+        result = ExerciseImporter::read(path, {});
+    }
+    QVERIFY(result.ok);
+    QCOMPARE(result.invalid, 0);
+    QCOMPARE(result.records + result.duplicates, total);
+    QCOMPARE(int(result.exercises.size()), store.count());
+}
+
+void BenchDataCenter::importCsv() {
+    QTemporaryDir dir;
+    const QString path = dir.filePath("strong.csv");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    // Una fila por serie, como exportan otras apps; una fila sin fecha válida
+    file.write("\xEF\xBB\xBFDate;Exercise Name;Weight;Reps\n"
+               "2024-03-01 18:00:00;\"Press banca; barra\";60;10\n"
+               "2024-03-01 18:00:00;\"Press banca; barra\";80,5;5\n"
+               "2024-03-01 18:00:00;\"Press banca; barra\";70;8\n"
+               "2024-03-08 18:00:00;\"Press banca; barra\";82,5;5\n"
+               "ayer;Sentadilla;100;5\n");
+    file.close();
+
+    const ExerciseImporter::Result result = ExerciseImporter::read(path, {{"muscleGroup", "Pecho"}});
+    QVERIFY(result.ok);
+    QCOMPARE(result.records, 2);
+    QCOMPARE(result.invalid, 1);
+    QCOMPARE(int(result.exercises.size()), 1);
+
+    const QJsonObject exercise = result.exercises.at(0).toObject();
+    QCOMPARE(exercise["name"].toString(), QString("Press banca; barra"));
+    QCOMPARE(exercise["muscleGroup"].toString(), QString("Pecho"));
+    const QJsonObject first = exercise["history"].toArray().at(0).toObject();
+    QCOMPARE(first["sets"].toInt(), 3);
+    QCOMPARE(first["value"].toDouble(), 80.5);
+    QCOMPARE(first["repetitions"].toInt(), 5);
+    QCOMPARE(first["unit"].toString(), QString("kg"));
+}
+
+void BenchDataCenter::exportData() {
+    const ExerciseStore& store = dataset();
+    QTemporaryDir dir;
+    const QString path = dir.filePath("backup.json");
+
+    int total = 0;
+    for (int row = 0; row < store.count(); ++row)
+        total += store.at(row).history.size();
+
+    ExerciseExporter::Result result;
+    QBENCHMARK {
+        result = ExerciseExporter::write(store, path);
+    }
+    QVERIFY(result.ok);
+    QCOMPARE(result.records, total);
+
+    // El JSON compacto es el mismo documento que toJson()
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(QJsonDocument::fromJson(file.readAll()).object(), store.toJson());
+
+    // CSV comprimido: lo lee el importador
+    const QString csvPath = dir.filePath("backup.csv.gz");
+    result = ExerciseExporter::write(store, csvPath);
+    QVERIFY(result.ok);
+    const ExerciseImporter::Result imported = ExerciseImporter::read(csvPath, {});
+    QVERIFY(imported.ok);
+    QCOMPARE(imported.records + imported.duplicates + imported.invalid, total);
+
+    // Incremental: sólo lo posterior a la fecha indicada
+    // En segundos enteros: es la precisión de las fechas ISO
+    const qint64 since = QDateTime::currentDateTime().addYears(-1).toSecsSinceEpoch() * 1000;
+    int newer = 0;
+    for (int row = 0; row < store.count(); ++row) {
+        const ExerciseStore::History& history = store.at(row).history;
+        newer += history.size() - history.lowerBound(since + 1);
+    }
+    result = ExerciseExporter::write(store, path, {{"since", ExerciseStore::formatTimestamp(since)}});
+    QVERIFY(result.ok);
+    QCOMPARE(result.records, newer);
+}
+
+void BenchDataCenter::downsample_data() {
+    QTest::addColumn<int>("points");
+    QTest::addColumn<int>("budget");
+    QTest::newRow("10k") << 10000 << 400;
+    QTest::newRow("100k") << 100000 << 400;
+    // Presupuestos mínimos: la vista aún sin ancho pide 2 puntos
+    for (int budget = 2; budget <= 7; ++budget)
+        QTest::newRow(qPrintable(QString("10k/%1").arg(budget))) << 10000 << budget;
+}
+
+void BenchDataCenter::downsample() {
+    QFETCH(int, points);
+    QFETCH(int, budget);
+    QRandomGenerator random(20240101);
+    QList<double> values;
+    values.reserve(points + 1);
+    for (int i = 0; i < points; ++i)
+        values.append(40 + random.bounded(60.0));
+
+    const int record = int(std::max_element(values.cbegin(), values.cend()) - values.cbegin());
+    SeriesDownsampler sampler;
+    const QList<int> first = sampler.sample(values, 0, budget, {record});
+    QVERIFY(first.size() <= std::max(budget, 6) + 2);
+    QVERIFY(first.contains(record));
+    QCOMPARE(first.first(), 0);
+    QCOMPARE(first.last(), points - 1);
+
+    // Caso habitual: un registro nuevo al final con el nivel ya en caché
+    QBENCHMARK {
+        values.append(values.last());
+        sampler.append(values);
+        const QList<int> rows = sampler.sample(values, points / 2, budget, {record});
+        QCOMPARE(rows.last(), int(values.size()) - 1);
+        QVERIFY(rows.size() <= std::max(budget, 6) + 2);
+    }
+}
+
+void BenchDataCenter::modelData() {
+    dataset();
+    DataCenter dataCenter;
+    QVERIFY(waitForReady(dataCenter));
+    ExerciseModel model;
+    model.setDataCenter(&dataCenter);
+
+    // Todo lo que pide un delegado de MenuPage salvo el historial
+    const QList<int> roles = {ExerciseModel::NameRole, ExerciseModel::MuscleGroupRole,
+                              ExerciseModel::CurrentValueRole, ExerciseModel::UnitRole,
+                              ExerciseModel::SetsRole, ExerciseModel::RepetitionsRole,
+                              ExerciseModel::LastUpdatedRole};
+    QBENCHMARK {
+        for (int row = 0; row < model.rowCount(); ++row) {
+            const QModelIndex index = model.index(row);
+            for (int role : roles)
+                QVERIFY(model.data(index, role).isValid());
+        }
+    }
+}
+
+void BenchDataCenter::modelHistoryRole() {
+    dataset();
+    DataCenter dataCenter;
+    QVERIFY(waitForReady(dataCenter));
+    ExerciseModel model;
+    model.setDataCenter(&dataCenter);
+
+    QBENCHMARK {
+        for (int row = 0; row < model.rowCount(); ++row)
+            model.data(model.index(row), ExerciseModel::HistoryRole);
+    }
+
+    // Un modelo por ejercicio, compartido, que se carga por páginas del más reciente al más antiguo
+    const QString name = dataCenter.store().at(0).name;
+    auto* history = model.data(model.index(0), ExerciseModel::HistoryRole).value<HistoryListModel*>();
+    QVERIFY(history);
+    QCOMPARE(history, dataCenter.historyModel(name));
+    const int total = dataCenter.store().at(0).history.size();
+    QCOMPARE(history->totalCount(), total);
+    QCOMPARE(history->rowCount(), qMin(total, int(HistoryListModel::kPageSize)));
+    while (history->canFetchMore(QModelIndex()))
+        history->fetchMore(QModelIndex());
+    QCOMPARE(history->rowCount(), total);
+    if (total > 0) {
+        QCOMPARE(history->data(history->index(0), HistoryListModel::HistoryIndexRole).toInt(), total - 1);
+        QCOMPARE(history->data(history->index(total - 1), HistoryListModel::HistoryIndexRole).toInt(), 0);
+    }
+
+    // Un registro nuevo llega como una fila insertada arriba, sin reiniciar el modelo
+    QSignalSpy inserted(history, &QAbstractItemModel::rowsInserted);
+    QSignalSpy reset(history, &QAbstractItemModel::modelReset);
+    dataCenter.updateExercise(name, 42.5, "kg", 3, 10);
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(inserted.first().at(1).toInt(), 0);
+    QCOMPARE(reset.count(), 0);
+    QCOMPARE(history->rowCount(), total + 1);
+    QCOMPARE(history->data(history->index(0), HistoryListModel::WeightRole).toDouble(), 42.5);
+
+    // Con periodo, sólo los registros posteriores al corte (el nuevo incluido)
+    HistoryListModel* recent = dataCenter.historyModel(name, 1);
+    QVERIFY(recent != history);
+    QCOMPARE(recent, dataCenter.historyModel(name, 1));
+    const ExerciseStore::History& records = dataCenter.store().at(0).history;
+    const int inPeriod = records.size() - records.lowerBound(HistorySeriesModel::periodCutoff(1));
+    QCOMPARE(recent->totalCount(), inPeriod);
+    QCOMPARE(recent->data(recent->index(0), HistoryListModel::HistoryIndexRole).toInt(), records.size() - 1);
+}
+
+void BenchDataCenter::filterSearch() {
+    dataset();
+    DataCenter dataCenter;
+    QVERIFY(waitForReady(dataCenter));
+    ExerciseModel model;
+    model.setDataCenter(&dataCenter);
+    ExerciseFilterModel filter;
+    filter.setExerciseModel(&model);
+    QCOMPARE(filter.count(), model.rowCount());
+
+    // Lo que pasa al escribir y borrar una búsqueda en MenuPage, tecla a tecla
+    const QString query = QStringLiteral("press inclinado");
+    QBENCHMARK {
+        for (int length = 1; length <= query.size(); ++length)
+            filter.setSearchText(query.left(length));
+        filter.setSearchText(QString());
+    }
+    QCOMPARE(filter.count(), model.rowCount());
+}
+
+void BenchDataCenter::catalogIsSortedAndUnique() {
+    // La tabla generada al compilar ya viene ordenada y sin duplicados
+    for (int i = 1; i < ExerciseCatalog::kCount; ++i) {
+        const ExerciseCatalog::Entry& previous = ExerciseCatalog::kEntries[i - 1];
+        const ExerciseCatalog::Entry& current = ExerciseCatalog::kEntries[i];
+        QVERIFY2(previous.name.compare(current.name, Qt::CaseInsensitive) <= 0, qPrintable(current.name.toString()));
+        QVERIFY2(previous.name.compare(current.name, Qt::CaseInsensitive) != 0 || previous.group != current.group,
+                 qPrintable(current.name.toString()));
+    }
+}
+
+void BenchDataCenter::providerConstruction() {
+    QBENCHMARK {
+        ExerciseProvider provider;
+        QVERIFY(provider.isReady());
+        QCOMPARE(provider.exercises().size(), ExerciseCatalog::kCount);
+    }
+}
+
+void BenchDataCenter::searchMatchesAliases() {
+    ExerciseSearchModel model;
+    QSignalSpy spy(&model, &ExerciseSearchModel::readyChanged);
+    QVERIFY(model.isReady() || spy.wait(10000));
+
+    auto names = [&model]() {
+        QStringList result;
+        for (int row = 0; row < model.rowCount(); ++row)
+            result.append(model.data(model.index(row), ExerciseSearchModel::NameRole).toString());
+        return result;
+    };
+
+    model.setQuery("press militar");
+    QCOMPARE(names().value(0), QString("Press militar"));
+    QVERIFY(names().contains("Overhead Press"));
+
+    model.setQuery("Overhead press");
+    QVERIFY(names().contains("Press militar"));
+
+    // Sin tildes y por prefijo de palabra
+    model.setQuery("elevacion pie");
+    QVERIFY(names().contains("Elevación piernas"));
+    model.setQuery("jalon");
+    QCOMPARE(names().value(0), QString("Jalón al pecho"));
+}
+
+void BenchDataCenter::search() {
+    ExerciseSearchModel model;
+    QSignalSpy spy(&model, &ExerciseSearchModel::readyChanged);
+    QVERIFY(model.isReady() || spy.wait(10000));
+
+    const QString query = QStringLiteral("press inclinado");
+    QBENCHMARK {
+        for (int length = 1; length <= query.size(); ++length)
+            model.setQuery(query.left(length));
+        model.setQuery(QString());
+    }
+}
+
+QTEST_MAIN(BenchDataCenter)
+#include "bench_datacenter.moc"
@@ -0,0 +1,100 @@
+#include <QDateTime>
+#include <QTest>
+#include "isodate.h"
+
+// Compara el codec ISO-8601 propio con QDateTime sobre un historial de fechas
+// locales como las que guarda la app (una por día durante varios años).
+class BenchIsoDate : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void parseMatchesQDateTime();
+    void formatMatchesQDateTime();
+    void parseQDateTime();
+    void parseIsoDate();
+    void formatQDateTime();
+    void formatIsoDate();
+
+private:
+    QStringList m_texts;
+    QList<qint64> m_values;
+};
+
+void BenchIsoDate::initTestCase() {
+    const QDateTime start(QDate(2019, 1, 1), QTime(18, 30, 15));
+    for (int day = 0; day < 5 * 365; ++day) {
+        const QDateTime dateTime = start.addDays(day).addSecs(day * 37 % 3600);
+        m_texts.append(dateTime.toString(Qt::ISODate));
+        m_values.append(dateTime.toMSecsSinceEpoch());
+    }
+}
+
+void BenchIsoDate::parseMatchesQDateTime() {
+    for (const QString& text : std::as_const(m_texts)) {
+        qint64 msecs = 0;
+        QVERIFY2(IsoDate::parse(QStringView(text), &msecs), qPrintable(text));
+        QCOMPARE(msecs, QDateTime::fromString(text, Qt::ISODate).toMSecsSinceEpoch());
+    }
+
+    const QStringList variants = {"2024-03-31T02:30:00Z", "2024-10-27T01:15:00+02:00",
+                                  "2024-02-29T23:59:59.999-0530", "2024-06-01"};
+    for (const QString& text : variants) {
+        qint64 msecs = 0;
+        QVERIFY2(IsoDate::parse(QStringView(text), &msecs), qPrintable(text));
+        QCOMPARE(msecs, QDateTime::fromString(text, Qt::ISODate).toMSecsSinceEpoch());
+    }
+
+    qint64 msecs = 0;
+    QVERIFY(!IsoDate::parse(QStringView(u"2024-02-30T10:00:00"), &msecs));
+    QVERIFY(!IsoDate::parse(QStringView(u"2024-1-01"), &msecs));
+}
+
+void BenchIsoDate::formatMatchesQDateTime() {
+    for (qint64 msecs : std::as_const(m_values))
+        QCOMPARE(IsoDate::format(msecs), QDateTime::fromMSecsSinceEpoch(msecs).toString(Qt::ISODate));
+}
+
+void BenchIsoDate::parseQDateTime() {
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (const QString& text : std::as_const(m_texts))
+            sum += QDateTime::fromString(text, Qt::ISODate).toMSecsSinceEpoch();
+    }
+    QVERIFY(sum != 0);
+}
+
+void BenchIsoDate::parseIsoDate() {
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (const QString& text : std::as_const(m_texts)) {
+            qint64 msecs = 0;
+            IsoDate::parse(QStringView(text), &msecs);
+            sum += msecs;
+        }
+    }
+    QVERIFY(sum != 0);
+}
+
+void BenchIsoDate::formatQDateTime() {
+    qsizetype length = 0;
+    QBENCHMARK {
+        for (qint64 msecs : std::as_const(m_values))
+            length += QDateTime::fromMSecsSinceEpoch(msecs).toString(Qt::ISODate).size();
+    }
+    QVERIFY(length != 0);
+}
+
+void BenchIsoDate::formatIsoDate() {
+    char16_t buffer[IsoDate::kFormattedLength];
+    qsizetype length = 0;
+    QBENCHMARK {
+        for (qint64 msecs : std::as_const(m_values))
+            length += IsoDate::format(msecs, buffer);
+    }
+    QVERIFY(length != 0);
+}
+
+QTEST_GUILESS_MAIN(BenchIsoDate)
+#include "bench_isodate.moc"
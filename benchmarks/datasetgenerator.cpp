@@ -0,0 +1,64 @@
+#include "datasetgenerator.h"
+#include "exercisecatalog.h"
+#include <QDir>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+
+namespace {
+// 2020-01-01T00:00:00Z: base fija para que las fechas no dependan del día de ejecución
+constexpr qint64 kBaseTimestamp = 1577836800000;
+constexpr qint64 kMsecsPerDay = 86400000;
+}
+
+namespace DatasetGenerator {
+
+ExerciseStore generate(int exerciseCount, int recordCount, quint32 seed) {
+    QRandomGenerator random(seed);
+
+    ExerciseStore store;
+    if (exerciseCount <= 0)
+        return store;
+
+    const int kg = store.internUnit("kg");
+    const int lb = store.internUnit("lb");
+
+    for (int i = 0; i < exerciseCount; ++i) {
+        const ExerciseCatalog::Entry& entry = ExerciseCatalog::kEntries[i % ExerciseCatalog::kCount];
+        const int round = i / ExerciseCatalog::kCount;
+        const QString name = round == 0 ? ExerciseCatalog::name(entry)
+                                        : QString("%1 #%2").arg(entry.name).arg(round + 1);
+        store.setExercise(name, QString(ExerciseCatalog::groupName(entry.group)));
+
+        // Reparto uniforme de los registros; el resto va a los primeros ejercicios
+        const int records = recordCount / exerciseCount + (i < recordCount % exerciseCount ? 1 : 0);
+        const int unit = random.bounded(4) == 0 ? lb : kg;
+        double weight = 10 + random.bounded(80);
+        qint64 timestamp = kBaseTimestamp + random.bounded(30) * kMsecsPerDay;
+
+        for (int r = 0; r < records; ++r) {
+            ExerciseStore::Record record;
+            record.timestamp = timestamp + random.bounded(12 * 3600) * 1000LL;
+            record.value = weight;
+            record.unitId = unit;
+            record.sets = 3 + random.bounded(3);
+            record.repetitions = 5 + random.bounded(8);
+            store.addRecord(name, record);
+
+            // Progresión realista: sube poco a poco con alguna descarga
+            weight = qMax(2.5, weight + (random.bounded(10) == 0 ? -5.0 : 2.5 * random.bounded(2)));
+            timestamp += (1 + random.bounded(4)) * kMsecsPerDay;
+        }
+    }
+
+    store.setMetadata("appVersion", "benchmark");
+    return store;
+}
+
+bool install(const ExerciseStore& store, StorageBackend::Kind kind) {
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir(dir).removeRecursively();
+    QDir().mkpath(dir);
+    return StorageBackend::create(kind, dir)->writeSnapshot(store, 0);
+}
+
+} // namespace DatasetGenerator
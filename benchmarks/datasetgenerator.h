@@ -0,0 +1,22 @@
+#ifndef DATASETGENERATOR_H
+#define DATASETGENERATOR_H
+
+#include <QString>
+#include <QStringList>
+#include "exercisestore.h"
+#include "storagebackend.h"
+
+// Generador determinista de datos de prueba: mismos parámetros y semilla
+// producen exactamente el mismo almacén en cualquier plataforma. Los nombres
+// y grupos salen del catálogo compilado; si se piden más ejercicios que
+// nombres hay en el catálogo se numeran ("Press banca #2").
+namespace DatasetGenerator {
+
+ExerciseStore generate(int exerciseCount, int recordCount, quint32 seed = 20240101);
+
+// Deja el directorio de datos de la app con este almacén guardado en el motor indicado
+bool install(const ExerciseStore& store, StorageBackend::Kind kind = StorageBackend::Binary);
+
+} // namespace DatasetGenerator
+
+#endif // DATASETGENERATOR_H
@@ -0,0 +1,266 @@
+#include "binarysnapshot.h"
+#include "exercisestore.h"
+#include "logging.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+constexpr char kMagic[8] = {'W', 'S', 'E', 'E', 'S', 'N', 'A', 'P'};
+constexpr quint32 kByteOrderMark = 0x01020304;
+// Cabecera de la versión 1, sin la sección de resúmenes
+constexpr qint64 kHeaderSizeV1 = offsetof(BinarySnapshot::Header, rollupOffset);
+
+// Todas las secciones empiezan alineadas a 8 bytes para poder leerlas en el sitio
+qint64 align(qint64 offset) {
+    return (offset + 7) & ~qint64(7);
+}
+
+void pad(QByteArray& data) {
+    data.append(align(data.size()) - data.size(), '\0');
+}
+
+template <typename T>
+void appendRaw(QByteArray& data, const T& value) {
+    data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+BinarySnapshot::BinarySnapshot(const QString& filePath) : m_file(filePath) {}
+
+BinarySnapshot::~BinarySnapshot() {
+    if (m_base && m_buffer.isEmpty())
+        m_file.unmap(const_cast<uchar*>(m_base));
+}
+
+QSharedPointer<const BinarySnapshot> BinarySnapshot::open(const QString& filePath, QString* error) {
+    QSharedPointer<BinarySnapshot> snapshot(new BinarySnapshot(filePath));
+
+    if (!snapshot->m_file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = snapshot->m_file.errorString();
+        return {};
+    }
+
+    snapshot->m_size = snapshot->m_file.size();
+    snapshot->m_base = snapshot->m_file.map(0, snapshot->m_size);
+    if (!snapshot->m_base) {
+        // Sin soporte de mapeo (p.ej. recursos): se lee entero
+        snapshot->m_buffer = snapshot->m_file.readAll();
+        snapshot->m_base = reinterpret_cast<const uchar*>(snapshot->m_buffer.constData());
+    }
+
+    if (!snapshot->validate(error))
+        return {};
+
+    return snapshot;
+}
+
+bool BinarySnapshot::validate(QString* error) {
+    auto fail = [error](const QString& reason) {
+        if (error)
+            *error = reason;
+        return false;
+    };
+
+    if (!m_base || m_size < kHeaderSizeV1)
+        return fail("Fichero demasiado pequeño");
+
+    m_header = reinterpret_cast<const Header*>(m_base);
+    if (std::memcmp(m_header->magic, kMagic, sizeof(kMagic)) != 0)
+        return fail("Firma desconocida");
+    if (m_header->byteOrderMark != kByteOrderMark)
+        return fail("Orden de bytes distinto");
+    if (m_header->version != kVersion && m_header->version != 1)
+        return fail(QString("Versión no soportada: %1").arg(m_header->version));
+    if (m_header->version >= 2 && m_size < qint64(sizeof(Header)))
+        return fail("Fichero demasiado pequeño");
+
+    const quint64 size = quint64(m_size);
+    auto fits = [size](quint64 offset, quint64 bytes) {
+        return offset <= size && bytes <= size - offset;
+    };
+
+    const Header& h = *m_header;
+    if (!fits(h.stringsOffset, h.stringsSize)
+        || !fits(h.unitsOffset, quint64(h.unitCount) * sizeof(StringRef))
+        || !fits(h.directoryOffset, quint64(h.exerciseCount) * sizeof(DirectoryEntry))
+        || !fits(h.recordsOffset, h.recordCount * sizeof(SnapshotRecord))
+        || !fits(h.metadataOffset, h.metadataSize)
+        || (h.version >= 2 && !fits(h.rollupOffset, h.rollupSize)))
+        return fail("Sección fuera de rango");
+
+    if ((h.unitsOffset | h.directoryOffset | h.recordsOffset) % 8 != 0)
+        return fail("Sección desalineada");
+
+    m_strings = reinterpret_cast<const char*>(m_base + h.stringsOffset);
+    m_units = reinterpret_cast<const StringRef*>(m_base + h.unitsOffset);
+    m_directory = reinterpret_cast<const DirectoryEntry*>(m_base + h.directoryOffset);
+    m_records = reinterpret_cast<const SnapshotRecord*>(m_base + h.recordsOffset);
+
+    auto validString = [&h](const StringRef& ref) {
+        return ref.offset <= h.stringsSize && ref.length <= h.stringsSize - ref.offset;
+    };
+
+    for (quint32 i = 0; i < h.unitCount; ++i) {
+        if (!validString(m_units[i]))
+            return fail("Unidad fuera de rango");
+    }
+
+    // Sólo se comprueba el directorio: los registros se leen bajo demanda
+    for (quint32 i = 0; i < h.exerciseCount; ++i) {
+        const DirectoryEntry& entry = m_directory[i];
+        if (!validString(entry.name) || !validString(entry.muscleGroup))
+            return fail("Nombre fuera de rango");
+        if (entry.firstRecord > h.recordCount || entry.recordCount > h.recordCount - entry.firstRecord)
+            return fail("Historial fuera de rango");
+    }
+
+    return true;
+}
+
+QString BinarySnapshot::string(const StringRef& ref) const {
+    return QString::fromUtf8(m_strings + ref.offset, qsizetype(ref.length));
+}
+
+QStringList BinarySnapshot::units() const {
+    QStringList result;
+    result.reserve(m_header->unitCount);
+    for (quint32 i = 0; i < m_header->unitCount; ++i)
+        result.append(string(m_units[i]));
+    return result;
+}
+
+QJsonObject BinarySnapshot::metadata() const {
+    if (m_header->metadataSize == 0)
+        return QJsonObject();
+
+    const QByteArray json = QByteArray::fromRawData(
+        reinterpret_cast<const char*>(m_base + m_header->metadataOffset),
+        qsizetype(m_header->metadataSize));
+    return QJsonDocument::fromJson(json).object();
+}
+
+QByteArray BinarySnapshot::rollup() const {
+    if (m_header->version < 2 || m_header->rollupSize == 0)
+        return QByteArray();
+
+    return QByteArray(reinterpret_cast<const char*>(m_base + m_header->rollupOffset),
+                      qsizetype(m_header->rollupSize));
+}
+
+bool BinarySnapshot::write(const ExerciseStore& store, qint64 journalSequence, const QString& filePath) {
+    QByteArray strings;
+    QHash<QString, StringRef> stringRefs;
+    auto addString = [&](const QString& value) {
+        auto it = stringRefs.constFind(value);
+        if (it != stringRefs.constEnd())
+            return it.value();
+
+        const QByteArray utf8 = value.toUtf8();
+        const StringRef ref{quint32(strings.size()), quint32(utf8.size())};
+        strings.append(utf8);
+        stringRefs.insert(value, ref);
+        return ref;
+    };
+
+    const QStringList units = store.units();
+    QList<StringRef> unitRefs;
+    unitRefs.reserve(units.size());
+    for (const QString& unit : units)
+        unitRefs.append(addString(unit));
+
+    QList<DirectoryEntry> directory;
+    directory.reserve(store.count());
+    quint64 recordCount = 0;
+    for (int row = 0; row < store.count(); ++row) {
+        const ExerciseStore::Exercise& exercise = store.at(row);
+        DirectoryEntry entry{};
+        entry.name = addString(exercise.name);
+        entry.muscleGroup = addString(store.muscleGroup(exercise));
+        entry.firstRecord = recordCount;
+        entry.recordCount = quint32(exercise.history.size());
+        entry.currentValue = exercise.currentValue;
+        entry.lastUpdated = exercise.lastUpdated;
+        entry.sets = qint16(exercise.sets);
+        entry.repetitions = qint16(exercise.repetitions);
+        entry.unitId = quint8(exercise.unitId);
+        recordCount += entry.recordCount;
+        directory.append(entry);
+    }
+
+    const QByteArray metadata = QJsonDocument(store.metadata()).toJson(QJsonDocument::Compact);
+    const QByteArray rollup = store.rollup().serialize(store.muscleGroups());
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrderMark = kByteOrderMark;
+    header.journalSequence = journalSequence;
+    header.exerciseCount = quint32(directory.size());
+    header.unitCount = quint32(unitRefs.size());
+    header.stringsOffset = align(sizeof(Header));
+    header.stringsSize = quint64(strings.size());
+    header.unitsOffset = align(header.stringsOffset + header.stringsSize);
+    header.directoryOffset = align(header.unitsOffset + unitRefs.size() * sizeof(StringRef));
+    header.recordsOffset = align(header.directoryOffset + directory.size() * sizeof(DirectoryEntry));
+    header.recordCount = recordCount;
+    header.metadataOffset = header.recordsOffset + recordCount * sizeof(SnapshotRecord);
+    header.metadataSize = quint64(metadata.size());
+    header.rollupOffset = header.metadataOffset + header.metadataSize;
+    header.rollupSize = quint64(rollup.size());
+
+    QByteArray data;
+    data.reserve(qsizetype(header.rollupOffset + header.rollupSize));
+    appendRaw(data, header);
+    pad(data);
+    data.append(strings);
+    pad(data);
+    for (const StringRef& ref : unitRefs)
+        appendRaw(data, ref);
+    pad(data);
+    for (const DirectoryEntry& entry : directory)
+        appendRaw(data, entry);
+    pad(data);
+    for (int row = 0; row < store.count(); ++row) {
+        const ExerciseStore::History& history = store.at(row).history;
+        if (history.isMapped()) {
+            data.append(reinterpret_cast<const char*>(history.mapped),
+                        qsizetype(history.mappedCount) * qsizetype(sizeof(SnapshotRecord)));
+            continue;
+        }
+        for (int i = 0; i < history.size(); ++i) {
+            SnapshotRecord record{};
+            record.timestamp = history.timestampAt(i);
+            record.value = history.valueAt(i);
+            record.sets = qint16(history.setsAt(i));
+            record.repetitions = qint16(history.repetitionsAt(i));
+            record.unitId = quint8(history.unitIdAt(i));
+            appendRaw(data, record);
+        }
+    }
+    data.append(metadata);
+    data.append(rollup);
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    // El snapshot anterior puede seguir mapeado: QSaveFile escribe en un
+    // temporal y lo renombra, así que el mapeo antiguo sigue siendo válido
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(lcPersistence) << "Error al abrir el snapshot para escritura:" << file.errorString();
+        return false;
+    }
+
+    if (file.write(data) != data.size() || !file.commit()) {
+        qCWarning(lcPersistence) << "Error al escribir el snapshot:" << file.errorString();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,116 @@
+#ifndef BINARYSNAPSHOT_H
+#define BINARYSNAPSHOT_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QJsonObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+
+class ExerciseStore;
+
+// Registro de historial tal y como se guarda en disco: ancho fijo para poder
+// leerlo directamente desde el fichero mapeado en memoria.
+struct SnapshotRecord {
+    qint64 timestamp;   // ms desde epoch
+    double value;
+    qint16 sets;
+    qint16 repetitions;
+    quint8 unitId;      // índice en la tabla de unidades del snapshot
+    quint8 reserved[3];
+};
+static_assert(sizeof(SnapshotRecord) == 24, "SnapshotRecord debe ocupar 24 bytes");
+
+// Snapshot binario versionado de los ejercicios. Formato (orden de bytes nativo,
+// comprobado con una marca en la cabecera):
+//
+//   Header | tabla de cadenas UTF-8 | tabla de unidades | directorio de ejercicios
+//          | registros de historial (por ejercicio, ordenados por fecha) | metadatos JSON
+//          | resúmenes por tiempo (TrainingRollup, desde la versión 2)
+//
+// Al abrirlo sólo se leen la cabecera y el directorio (con el resumen de cada
+// ejercicio); los registros se leen en el sitio cuando alguien los consulta.
+class BinarySnapshot
+{
+public:
+    static constexpr quint32 kVersion = 2;
+
+    struct Header {
+        char magic[8];          // "WSEESNAP"
+        quint32 version;
+        quint32 byteOrderMark;  // 0x01020304
+        qint64 journalSequence;
+        quint32 exerciseCount;
+        quint32 unitCount;
+        quint64 stringsOffset;
+        quint64 stringsSize;
+        quint64 unitsOffset;
+        quint64 directoryOffset;
+        quint64 recordsOffset;
+        quint64 recordCount;
+        quint64 metadataOffset;
+        quint64 metadataSize;
+        // Versión 2; en un fichero de la versión 1 aquí ya empiezan las cadenas
+        quint64 rollupOffset;
+        quint64 rollupSize;
+    };
+
+    struct StringRef {
+        quint32 offset;
+        quint32 length;
+    };
+
+    // Entrada del directorio: además de localizar el historial lleva el resumen
+    // que necesita la lista principal, para no tocar los registros al arrancar
+    struct DirectoryEntry {
+        StringRef name;
+        StringRef muscleGroup;
+        quint64 firstRecord;
+        quint32 recordCount;
+        quint32 reserved;
+        double currentValue;
+        qint64 lastUpdated;
+        qint16 sets;
+        qint16 repetitions;
+        quint8 unitId;
+        quint8 reserved2[3];
+    };
+
+    ~BinarySnapshot();
+
+    static QSharedPointer<const BinarySnapshot> open(const QString& filePath, QString* error = nullptr);
+    static bool write(const ExerciseStore& store, qint64 journalSequence, const QString& filePath);
+
+    qint64 journalSequence() const { return m_header->journalSequence; }
+    int exerciseCount() const { return int(m_header->exerciseCount); }
+    QString exerciseName(int i) const { return string(m_directory[i].name); }
+    QString muscleGroup(int i) const { return string(m_directory[i].muscleGroup); }
+    const DirectoryEntry& entry(int i) const { return m_directory[i]; }
+    const SnapshotRecord* records(int i) const { return m_records + m_directory[i].firstRecord; }
+    int recordCount(int i) const { return int(m_directory[i].recordCount); }
+    QStringList units() const;
+    QJsonObject metadata() const;
+    // Vacío en snapshots de la versión 1
+    QByteArray rollup() const;
+
+private:
+    BinarySnapshot(const QString& filePath);
+    Q_DISABLE_COPY(BinarySnapshot)
+
+    QFile m_file;
+    QByteArray m_buffer; // sólo si el sistema no permite mapear el fichero
+    const uchar* m_base = nullptr;
+    qint64 m_size = 0;
+
+    const Header* m_header = nullptr;
+    const StringRef* m_units = nullptr;
+    const DirectoryEntry* m_directory = nullptr;
+    const SnapshotRecord* m_records = nullptr;
+    const char* m_strings = nullptr;
+
+    bool validate(QString* error);
+    QString string(const StringRef& ref) const;
+};
+
+#endif // BINARYSNAPSHOT_H
@@ -0,0 +1,57 @@
+#include "binarystorage.h"
+#include "logging.h"
+#include <QFile>
+
+BinaryStorage::BinaryStorage(const QString& snapshotPath, const QString& journalPath)
+    : m_snapshotPath(snapshotPath), m_journal(journalPath) {}
+
+bool BinaryStorage::exists() const {
+    return QFile::exists(m_snapshotPath) || m_journal.size() > 0;
+}
+
+StorageBackend::LoadResult BinaryStorage::load() {
+    LoadResult result;
+
+    QString error;
+    const QSharedPointer<const BinarySnapshot> snapshot = BinarySnapshot::open(m_snapshotPath, &error);
+    if (snapshot) {
+        // Sólo se lee el directorio; el historial queda mapeado hasta que se consulte
+        result.store = ExerciseStore::fromSnapshot(snapshot);
+        result.sequence = snapshot->journalSequence();
+        result.snapshotFound = true;
+        qCDebug(lcPersistence) << "BinaryStorage:" << result.store.count() << "ejercicios cargados del snapshot";
+    } else if (QFile::exists(m_snapshotPath)) {
+        qCWarning(lcPersistence) << "BinaryStorage: snapshot no válido:" << error;
+    }
+
+    // Cambios registrados en el diario que aún no están en el snapshot
+    result.journal = m_journal.readAll(result.sequence);
+    return result;
+}
+
+bool BinaryStorage::append(const QJsonObject& record) {
+    return m_journal.append(record);
+}
+
+bool BinaryStorage::writeSnapshot(const ExerciseStore& store, qint64 sequence) {
+    // BinarySnapshot::write usa QSaveFile: se escribe en un temporal y se renombra
+    if (!BinarySnapshot::write(store, sequence, m_snapshotPath))
+        return false;
+
+    // Los registros añadidos después de la copia (seq > sequence) se conservan
+    m_journal.discardUpTo(sequence);
+    return true;
+}
+
+bool BinaryStorage::clear() {
+    m_journal.clear();
+    if (QFile::exists(m_snapshotPath) && !QFile::remove(m_snapshotPath)) {
+        qCWarning(lcPersistence) << "BinaryStorage: no se pudo borrar" << m_snapshotPath;
+        return false;
+    }
+    return true;
+}
+
+QSharedPointer<const BinarySnapshot> BinaryStorage::mapSnapshot() const {
+    return BinarySnapshot::open(m_snapshotPath);
+}
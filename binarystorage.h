@@ -0,0 +1,30 @@
+#ifndef BINARYSTORAGE_H
+#define BINARYSTORAGE_H
+
+#include "mutationjournal.h"
+#include "storagebackend.h"
+
+// Motor por defecto: snapshot binario que se mapea en memoria al cargar y un
+// diario con las mutaciones posteriores. Cada snapshot reescribe el fichero
+// entero (QSaveFile) y recorta el diario hasta su secuencia.
+class BinaryStorage : public StorageBackend
+{
+public:
+    BinaryStorage(const QString& snapshotPath, const QString& journalPath);
+
+    Kind kind() const override { return Binary; }
+    bool exists() const override;
+
+    LoadResult load() override;
+    bool append(const QJsonObject& record) override;
+    bool writeSnapshot(const ExerciseStore& store, qint64 sequence) override;
+    bool clear() override;
+
+    QSharedPointer<const BinarySnapshot> mapSnapshot() const override;
+
+private:
+    QString m_snapshotPath;
+    MutationJournal m_journal;
+};
+
+#endif // BINARYSTORAGE_H
@@ -0,0 +1,110 @@
+# Genera la tabla estática del catálogo de ejercicios a partir de
+# data/exerciseList.txt ("Nombre | Grupo" por línea).
+#
+#   cmake -DINPUT=<exerciseList.txt> -DOUTPUT=<exercisecatalog_table.h> -P GenerateExerciseCatalog.cmake
+#
+# La tabla sale ordenada por nombre (sin distinguir mayúsculas). Una línea mal
+# formada, un grupo desconocido o un ejercicio repetido hacen fallar la compilación.
+
+cmake_minimum_required(VERSION 3.21)
+
+if(NOT INPUT OR NOT OUTPUT)
+    message(FATAL_ERROR "Uso: cmake -DINPUT=... -DOUTPUT=... -P GenerateExerciseCatalog.cmake")
+endif()
+
+# Mismo orden que MuscleGroupFilter.qml y que ExerciseCatalog::MuscleGroup
+set(MUSCLE_GROUPS Shoulders Arms Chest Back Core Legs)
+
+file(STRINGS "${INPUT}" lines ENCODING UTF-8)
+
+# Separador interno menor que cualquier carácter imprimible: así "Ab Wheel"
+# queda antes que "Ab Wheel Rollout" al ordenar
+string(ASCII 1 SEPARATOR)
+
+set(entries)
+set(line_number 0)
+foreach(line IN LISTS lines)
+    math(EXPR line_number "${line_number} + 1")
+    string(STRIP "${line}" line)
+    if(line STREQUAL "")
+        continue()
+    endif()
+
+    # ';' y los corchetes rompen las listas de CMake: no se admiten en los nombres
+    if(line MATCHES "[][;]")
+        message(FATAL_ERROR "${INPUT}:${line_number}: carácter no permitido: ${line}")
+    endif()
+
+    string(REPLACE "|" ";" parts "${line}")
+    list(LENGTH parts part_count)
+    if(NOT part_count EQUAL 2)
+        message(FATAL_ERROR "${INPUT}:${line_number}: se esperaba \"Nombre | Grupo\": ${line}")
+    endif()
+
+    list(GET parts 0 name)
+    list(GET parts 1 group)
+    string(STRIP "${name}" name)
+    string(STRIP "${group}" group)
+
+    if(name STREQUAL "")
+        message(FATAL_ERROR "${INPUT}:${line_number}: nombre vacío")
+    endif()
+    if(NOT group IN_LIST MUSCLE_GROUPS)
+        message(FATAL_ERROR "${INPUT}:${line_number}: grupo muscular desconocido \"${group}\"")
+    endif()
+
+    list(APPEND entries "${name}${SEPARATOR}${group}${SEPARATOR}${line_number}")
+endforeach()
+
+list(SORT entries CASE INSENSITIVE)
+
+# Tras ordenar, los repetidos (mismo nombre y grupo, sin distinguir mayúsculas) quedan juntos
+set(previous_key "")
+set(previous_line 0)
+set(table "")
+set(count 0)
+foreach(entry IN LISTS entries)
+    string(REPLACE "${SEPARATOR}" ";" parts "${entry}")
+    list(GET parts 0 name)
+    list(GET parts 1 group)
+    list(GET parts 2 line_number)
+
+    string(TOLOWER "${name}|${group}" key)
+    if(key STREQUAL previous_key)
+        message(FATAL_ERROR "${INPUT}:${line_number}: \"${name}\" (${group}) repite la línea ${previous_line}")
+    endif()
+    set(previous_key "${key}")
+    set(previous_line ${line_number})
+
+    string(REPLACE "\\" "\\\\" literal "${name}")
+    string(REPLACE "\"" "\\\"" literal "${literal}")
+    string(APPEND table "    {u\"${literal}\", MuscleGroup::${group}},\n")
+    math(EXPR count "${count} + 1")
+endforeach()
+
+set(content "// Generado por cmake/GenerateExerciseCatalog.cmake a partir de data/exerciseList.txt.
+// No editar: los cambios se pierden en la próxima compilación.
+
+#ifndef EXERCISECATALOG_TABLE_H
+#define EXERCISECATALOG_TABLE_H
+
+namespace ExerciseCatalog {
+
+inline constexpr int kCount = ${count};
+
+inline constexpr Entry kEntries[kCount] = {
+${table}};
+
+} // namespace ExerciseCatalog
+
+#endif // EXERCISECATALOG_TABLE_H
+")
+
+# Sólo se reescribe si cambia, para no recompilar lo que lo incluye
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous_content)
+    if(previous_content STREQUAL content)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${content}")
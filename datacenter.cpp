@@ -1,431 +1,977 @@
 #include "datacenter.h"
-#include <QFile>
+#include "diagnostics.h"
+#include "exercisecatalog.h"
+#include "historylistmodel.h"
+#include "logging.h"
+#include <QGuiApplication>
+#include <QSettings>
 #include <QStandardPaths>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QJsonArray>
 #include <QDateTime>
-#include <QDebug>
+#include <QSet>
+#include <algorithm>
 #include <random> // Para std::mt19937 y std::random_device
+#include <utility>
+
+namespace {
+// Ventana por defecto en la que se agrupan los cambios antes de escribir el snapshot
+constexpr int kDefaultSaveDelay = 1500;
+// Por encima de este número de cambios, deshacer reinicia los modelos en vez
+// de notificar fila a fila
+constexpr int kMaxTargetedChanges = 256;
+}
 
 DataCenter::DataCenter(QObject *parent) : QObject(parent) {
+    m_storageKind = StorageBackend::kindFromName(QSettings().value(StorageBackend::kSettingsKey).toString());
+    m_worker = new PersistenceWorker(m_storageKind, getDataDirectory());
+    m_worker->moveToThread(&m_ioThread);
+    connect(&m_ioThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &PersistenceWorker::snapshotWritten, this, &DataCenter::onSnapshotWritten);
+    connect(m_worker, &PersistenceWorker::snapshotMapped, this, &DataCenter::onSnapshotMapped);
+    connect(m_worker, &PersistenceWorker::backendChanged, this, [this](StorageBackend::Kind kind) {
+        if (m_storageKind == kind)
+            return;
+        m_storageKind = kind;
+        emit storageBackendChanged();
+    });
+    connect(m_worker, &PersistenceWorker::journalAppendFailed, this, [this]() {
+        m_saveTimer.start(0);
+    });
+    connect(m_worker, &PersistenceWorker::loadProgress, this, [this](double progress) {
+        if (!m_loading)
+            return;
+        m_progress = progress;
+        emit progressChanged();
+    });
+    m_ioThread.setObjectName("DataCenter I/O");
+    m_ioThread.start(QThread::LowPriority);
+    // Una importación cada vez (importData ignora las demás mientras dura);
+    // las exportaciones se escriben en orden
+    m_importPool.setMaxThreadCount(1);
+    m_exportPool.setMaxThreadCount(1);
+
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(kDefaultSaveDelay);
+    connect(&m_saveTimer, &QTimer::timeout, this, &DataCenter::writeSnapshotAsync);
+
     load();
+
+    // Al pasar a segundo plano o al salir se vuelca todo lo pendiente y se
+    // devuelve al sistema la memoria de los historiales
+    connect(qGuiApp, &QGuiApplication::applicationStateChanged, this, [this](Qt::ApplicationState state) {
+        if (state == Qt::ApplicationSuspended || state == Qt::ApplicationHidden)
+            releaseMemory();
+    });
+    connect(qGuiApp, &QCoreApplication::aboutToQuit, this, &DataCenter::flush);
+}
+
+DataCenter::~DataCenter() {
+    // Ninguna lectura o escritura puede quedar publicando en un objeto destruido
+    m_importPool.waitForDone();
+    m_exportPool.waitForDone();
+    flush();
+    m_ioThread.quit();
+    m_ioThread.wait();
 }
 
 QJsonObject DataCenter::data() const {
-    return m_data;
+    return m_store.toJson();
 }
 
 void DataCenter::load() {
-    QFile file(getFilePath());
-
-    if (file.exists() && file.open(QIODevice::ReadOnly)) {
-        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-        file.close();
+    if (m_loading)
+        return;
+
+    // Lo pendiente se vuelca antes de volver a leer el snapshot y el diario
+    flush();
+    setLoading(true);
+    m_loadStarted = Diagnostics::instance()->now();
+
+    // La lectura se hace en el hilo del worker; la interfaz sigue respondiendo
+    // (splash) y el resultado se adopta de golpe en finishLoad()
+    QMetaObject::invokeMethod(m_worker, [this, worker = m_worker, legacyPath = getLegacyFilePath()]() {
+        const PersistenceWorker::LoadResult result = worker->load(legacyPath);
+        QMetaObject::invokeMethod(this, [this, result]() {
+            finishLoad(result);
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
 
-        if (!doc.isNull() && doc.isObject()) {
-            m_data = doc.object();
+void DataCenter::finishLoad(const PersistenceWorker::LoadResult& result) {
+    Diagnostics* diagnostics = Diagnostics::instance();
+    const qint64 applyStarted = diagnostics->now();
+    beginStoreReset();
 
-            if (!m_data.contains("exercises") || !m_data["exercises"].isObject()) {
-                loadEmptyData();
-            } else {
-                loadData();
-            }
-        } else {
-            loadEmptyData();
-        }
+    if (result.store.count() > 0 || result.snapshotFound) {
+        m_store = result.store;
     } else {
         loadEmptyData();
     }
 
-    save(); // Guardar por si hubo correcciones
-    qDebug() << "Datos cargados:\n" << QJsonDocument(m_data).toJson(QJsonDocument::Indented);
+    // Aplicar sobre el snapshot los cambios registrados en el diario
+    replayJournal(result.sequence, result.journal);
+    m_undoStack.clear();
+    emit undoChanged();
+
+    if (!result.snapshotFound) {
+        writeResetSnapshot();
+    }
+
+    endStoreReset();
+    setLoading(false);
+
+    diagnostics->addTiming("data.load.apply", applyStarted, diagnostics->now() - applyStarted);
+    diagnostics->addTiming("data.load", m_loadStarted, diagnostics->now() - m_loadStarted);
     emit dataChanged();
 }
 
-void DataCenter::loadData() {
-    QJsonObject exercises = m_data["exercises"].toObject();
-    bool modified = false;
+void DataCenter::setLoading(bool loading) {
+    m_loading = loading;
+    if (!loading)
+        m_ready = true;
+    m_progress = loading ? 0.0 : 1.0;
+    emit loadingChanged();
+    emit progressChanged();
+}
 
-    // Usar iteradores tradicionales para evitar el warning
-    const QStringList keys = exercises.keys();
-    for (auto it = keys.constBegin(); it != keys.constEnd(); ++it) {
-        const QString& key = *it;
-        QJsonObject exercise = exercises[key].toObject();
-        QJsonArray history = exercise["history"].toArray();
+void DataCenter::beginStoreReset() {
+    m_resetting = true;
+    emit storeAboutToBeReset();
+}
 
-        if (!history.isEmpty()) {
-            // Convertir a lista para ordenar (usando iteradores)
-            QList<QJsonObject> historyList;
-            for (auto histIt = history.constBegin(); histIt != history.constEnd(); ++histIt) {
-                historyList.append(histIt->toObject());
-            }
+void DataCenter::endStoreReset() {
+    m_resetting = false;
+    emit storeReset();
+}
 
-            // Ordenar cronológicamente (más antiguo primero)
-            std::sort(historyList.begin(), historyList.end(), [](const QJsonObject &a, const QJsonObject &b) {
-                QDateTime dateA = QDateTime::fromString(a["timestamp"].toString(), Qt::ISODate);
-                QDateTime dateB = QDateTime::fromString(b["timestamp"].toString(), Qt::ISODate);
-                return dateA < dateB;
-            });
+void DataCenter::setSaveDelay(int msecs) {
+    if (msecs == m_saveTimer.interval())
+        return;
+    m_saveTimer.setInterval(qMax(0, msecs));
+    emit saveDelayChanged();
+}
 
-            // Convertir de vuelta a QJsonArray (usando iteradores)
-            QJsonArray sortedHistory;
-            for (auto listIt = historyList.constBegin(); listIt != historyList.constEnd(); ++listIt) {
-                sortedHistory.append(*listIt);
-            }
+void DataCenter::save() {
+    ScopedTimer timer("data.save");
+    m_saveTimer.stop();
+
+    // Escritura síncrona en el hilo del worker: al ser una llamada encolada se
+    // ejecuta después de los registros del diario pendientes
+    const ExerciseStore store = m_store;
+    const qint64 sequence = m_sequence;
+    bool ok = false;
+    QMetaObject::invokeMethod(m_worker, [this, &store, sequence, &ok]() {
+        ok = m_worker->writeSnapshot(store, sequence);
+    }, Qt::BlockingQueuedConnection);
+
+    if (ok) {
+        m_savedSequence = qMax(m_savedSequence, sequence);
+        remapSnapshot();
+        emit persistenceChanged();
+    }
+}
 
-            // Obtener el último registro (más reciente)
-            QJsonObject lastRecord = sortedHistory.last().toObject();
-            qDebug() << "loadData() - Actualizando ejercicio" << key
-                     << "con último registro de:" << lastRecord["timestamp"].toString();
-
-            // Actualizar valores actuales
-            exercise["currentValue"] = lastRecord["value"].toDouble();
-            exercise["unit"] = lastRecord["unit"].toString();
-            exercise["sets"] = lastRecord["sets"].toInt();
-            exercise["repetitions"] = lastRecord["repetitions"].toInt();
-            exercise["lastUpdated"] = lastRecord["timestamp"].toString();
-            exercise["history"] = sortedHistory;
-
-            exercises[key] = exercise;
-            modified = true;
+void DataCenter::flush() {
+    if (m_sequence != m_savedSequence) {
+        save();
+    } else {
+        m_saveTimer.stop();
+    }
+}
+
+void DataCenter::releaseMemory() {
+    flush();
+
+    // Tras escribir el snapshot los historiales modificados vuelven a ser
+    // vistas sobre el fichero mapeado y se liberan sus columnas
+    const int materialized = m_store.materializedCount();
+    if (materialized > 0) {
+        qCDebug(lcData) << "releaseMemory() -" << materialized << "historiales en memoria";
+        remapSnapshot();
+    }
+}
+
+void DataCenter::scheduleSave() {
+    // Cada cambio reinicia la ventana: una ráfaga de cambios produce una sola escritura
+    m_saveTimer.start();
+    emit persistenceChanged();
+}
+
+void DataCenter::writeSnapshotAsync() {
+    if (m_sequence == m_savedSequence)
+        return;
+
+    // Las columnas del almacén son implícitamente compartidas: la copia es inmediata
+    // y no se ve afectada por los cambios que lleguen mientras se escribe
+    const ExerciseStore store = m_store;
+    const qint64 sequence = m_sequence;
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, store, sequence]() {
+        worker->writeSnapshot(store, sequence);
+    }, Qt::QueuedConnection);
+}
+
+void DataCenter::writeResetSnapshot() {
+    // Un reinicio no pasa por el diario: cuenta como un cambio más y se escribe
+    // en segundo plano. Los registros siguientes van detrás en la cola del
+    // worker, así que nunca llegan al disco antes que este snapshot
+    m_saveTimer.stop();
+    m_sequence++;
+    writeSnapshotAsync();
+    emit persistenceChanged();
+}
+
+void DataCenter::onSnapshotWritten(qint64 sequence, qint64 durationMs, bool ok) {
+    if (!ok) {
+        // Los cambios siguen en el diario; se reintentará en el próximo cambio o al salir
+        emit persistenceChanged();
+        return;
+    }
+
+    m_savedSequence = qMax(m_savedSequence, sequence);
+    m_lastSaveDuration = durationMs;
+
+    // Si no ha habido cambios mientras tanto, el snapshot refleja el estado actual
+    if (m_sequence == sequence && m_store.materializedCount() > 0)
+        remapSnapshot();
+
+    emit persistenceChanged();
+}
+
+void DataCenter::remapSnapshot() {
+    // El snapshot lo abre el worker (sólo el motor binario tiene uno) y llega
+    // por snapshotMapped, después de las escrituras que tuviera en cola
+    QMetaObject::invokeMethod(m_worker, &PersistenceWorker::mapSnapshot, Qt::QueuedConnection);
+}
+
+void DataCenter::onSnapshotMapped(const QSharedPointer<const BinarySnapshot>& snapshot) {
+    // Si ha habido cambios desde que se escribió, se esperará al siguiente
+    if (snapshot && snapshot->journalSequence() == m_sequence)
+        m_store.remap(snapshot);
+}
+
+void DataCenter::commitMutation(QJsonObject mutation) {
+    ScopedTimer timer("data.mutation");
+    Diagnostics::instance()->increment("data.mutations");
+
+    // En una transacción sólo se aplica; commit() la lleva al diario entera
+    if (m_batchDepth > 0) {
+        m_undoRecording = &m_batchStep;
+        const bool applied = applyMutation(mutation);
+        m_undoRecording = nullptr;
+        if (applied) {
+            m_batchMutations.append(mutation);
         } else {
-            qDebug() << "loadData() Ejercicio" << key << "sin historial, estableciendo valores por defecto";
-            // Valores por defecto
-            exercise["currentValue"] = 0;
-            exercise["repetitions"] = 0;
-            exercise["sets"] = 0;
-            exercise["lastUpdated"] = "";
-            exercise["unit"] = "-";
-
-            exercises[key] = exercise;
-            modified = true;
+            qCWarning(lcData) << "Transacción: no se pudo aplicar" << mutation["op"].toString() << mutation["name"].toString();
+            m_batchFailed = true;
         }
+        return;
     }
 
-    if (modified) {
-        m_data["exercises"] = exercises;
-        qDebug() << "ANDRESS 4 - Datos modificados y guardados";
+    mutation["seq"] = m_sequence + 1;
+
+    UndoStack::Step step;
+    m_undoRecording = &step;
+    const bool applied = applyMutation(mutation);
+    m_undoRecording = nullptr;
+    if (!applied)
+        return;
+
+    if (!step.isEmpty()) {
+        m_undoStack.push(std::move(step));
+        emit undoChanged();
     }
+    appendToJournal(mutation);
 }
 
-void DataCenter::save() {
-    QFile file(getFilePath());
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(QJsonDocument(m_data).toJson());
-        file.close();
+void DataCenter::appendToJournal(const QJsonObject& mutation) {
+    m_sequence++;
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, mutation]() {
+        worker->appendMutation(mutation);
+    }, Qt::QueuedConnection);
+    scheduleSave();
+
+    emit dataChanged();
+}
+
+bool DataCenter::applyMutation(const QJsonObject& mutation) {
+    const QString op = mutation["op"].toString();
+    const QString name = mutation["name"].toString();
+
+    if (op == "addExercise") {
+        return applyAddExercise(name, mutation["muscleGroup"].toString(), mutation["value"].toDouble(),
+                                mutation["unit"].toString(), mutation["sets"].toInt(),
+                                mutation["repetitions"].toInt(), mutation["timestamp"].toString());
+    } else if (op == "updateExercise") {
+        return applyUpdateExercise(name, mutation["value"].toDouble(), mutation["unit"].toString(),
+                                   mutation["sets"].toInt(), mutation["repetitions"].toInt(),
+                                   mutation["timestamp"].toString());
+    } else if (op == "removeExercise") {
+        return applyRemoveExercise(name);
+    } else if (op == "removeHistoryEntry") {
+        return applyRemoveHistoryEntry(name, mutation["index"].toInt());
+    } else if (op == "import") {
+        return applyImport(mutation["exercises"].toArray());
+    } else if (op == "batch") {
+        // Sólo al reproducir el diario: en vivo cada mutación ya se aplicó.
+        // Entera o nada, como en commit(): si una falla se deshacen las anteriores
+        const QJsonArray mutations = mutation["mutations"].toArray();
+        UndoStack::Step step;
+        UndoStack::Step* const recording = std::exchange(m_undoRecording, &step);
+        bool applied = true;
+        for (const QJsonValue& value : mutations) {
+            if (!applyMutation(value.toObject())) {
+                applied = false;
+                break;
+            }
+        }
+        m_undoRecording = recording;
+        if (!applied) {
+            qCWarning(lcPersistence) << "applyMutation() - transacción del diario descartada:"
+                                     << mutation["seq"].toInteger();
+            step.invert();
+            applyChanges(step);
+        }
+        return applied;
+    } else if (op == "changes") {
+        UndoStack::Step step = changesFromJson(mutation["changes"].toArray());
+        return applyChanges(step);
+    } else if (op == "setMetadata") {
+        m_store.setMetadata(mutation["key"].toString(), mutation["value"]);
+        return true;
+    }
+
+    qCWarning(lcData) << "DataCenter::applyMutation operación desconocida:" << op;
+    return false;
+}
+
+void DataCenter::replayJournal(qint64 snapshotSequence, const QList<QJsonObject>& records) {
+    m_sequence = snapshotSequence;
+    m_savedSequence = snapshotSequence;
+
+    for (const QJsonObject& record : records) {
+        applyMutation(record);
+        m_sequence = record["seq"].toInteger();
+    }
+
+    if (!records.isEmpty()) {
+        qCDebug(lcPersistence) << "replayJournal() -" << records.size() << "cambios recuperados del diario";
+        scheduleSave();
     }
 }
 
 void DataCenter::addExercise(const QString& name, const QString& muscleGroup,
                              double value, const QString& unit, int sets, int reps) {
-    QJsonObject exercises = m_data["exercises"].toObject();
-    QDateTime now = QDateTime::currentDateTime();
-    bool onlyExerciseName = value == 0 && sets == 0 && reps == 0;
-
-    qDebug() << "➡️ addExercise() llamado con:"
-    << "\n  name:" << name
-    << "\n  muscleGroup:" << muscleGroup
-    << "\n  value:" << value
-    << "\n  unit:" << unit
-    << "\n  sets:" << sets
-    << "\n  reps:" << reps
-    << "\n  timestamp:" << now.toString(Qt::ISODate)
-    << "\n  onlyExerciseName:" << onlyExerciseName;
-
-    QJsonObject newExercise {
+    commitMutation(QJsonObject{
+        {"op", "addExercise"},
+        {"name", name},
         {"muscleGroup", muscleGroup},
-        {"currentValue", value},
+        {"value", value},
         {"unit", unit},
         {"sets", sets},
         {"repetitions", reps},
-        {"lastUpdated", now.toString(Qt::ISODate)},
-            {"history", onlyExerciseName ? QJsonArray{} : QJsonArray{QJsonObject{
-                        {"timestamp", now.toString(Qt::ISODate)},
-                        {"value", value},
-                        {"unit", unit},
-                        {"sets", sets},
-                        {"repetitions", reps}
-                    }}}
-    };
-
-    exercises[name] = newExercise;
-    m_data["exercises"] = exercises;
-    save();
-    emit dataChanged();
+        {"timestamp", ExerciseStore::formatTimestamp(QDateTime::currentMSecsSinceEpoch())}
+    });
 }
 
-void DataCenter::addRandomExercises(int number) {
-    try {
-        // 1. Cargar el archivo desde recursos
-        QFile file(":/data/exerciseList.txt");
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            throw std::runtime_error("No se pudo abrir el archivo de ejercicios");
-        }
+bool DataCenter::applyAddExercise(const QString& name, const QString& muscleGroup, double value,
+                                  const QString& unit, int sets, int reps, const QString& timestamp) {
+    bool onlyExerciseName = value == 0 && sets == 0 && reps == 0;
 
-        // 2. Procesar el archivo
-        QTextStream in(&file);
-        QList<QPair<QString, QString>> availableExercises;
+    qCDebug(lcData) << "addExercise()" << name << muscleGroup << value << unit << sets << reps
+                    << timestamp << "onlyExerciseName:" << onlyExerciseName;
+
+    ExerciseStore::Record record;
+    if (!onlyExerciseName) {
+        record.timestamp = ExerciseStore::parseTimestamp(timestamp);
+        record.value = value;
+        record.sets = sets;
+        record.repetitions = reps;
+        record.unitId = m_store.internUnit(unit);
+        if (!record.fits()) {
+            qCWarning(lcData) << "addExercise() - registro fuera de rango:" << sets << reps << unit;
+            return false;
+        }
+    }
 
-        while (!in.atEnd()) {
-            QString line = in.readLine().trimmed();
-            if (line.isEmpty()) continue;
+    // Si ya existía un ejercicio con ese nombre se sustituye por completo
+    const bool exists = m_store.contains(name);
+    const int row = exists ? m_store.indexOf(name) : m_store.insertionRow(name);
 
-            QStringList parts = line.split(" | ");
-            if (parts.size() != 2) continue;
+    if (exists)
+        recordExercise(UndoStack::Change::RemoveExercise, row);
+    if (!exists && !m_resetting) emit exerciseAboutToBeAdded(row);
+    m_store.setExercise(name, muscleGroup);
+    recordExercise(UndoStack::Change::AddExercise, row);
 
-            QString name = parts[0].trimmed();
-            QString group = parts[1].trimmed();
+    if (!onlyExerciseName) {
+        m_store.addRecord(name, record);
+        recordRecord(UndoStack::Change::AddRecord, name, record);
+    }
 
-            if (!name.isEmpty() && !group.isEmpty()) {
-                availableExercises.append(qMakePair(name, group));
-            }
-        }
-        file.close();
-
-        // 3. Filtrar ejercicios que no existen ya
-        QJsonObject currentExercises = m_data["exercises"].toObject();
-        QList<QPair<QString, QString>> newExercises;
-
-        std::sample(
-            availableExercises.begin(),
-            availableExercises.end(),
-            std::back_inserter(newExercises),
-            number,
-            std::mt19937{std::random_device{}()}
-            );
-
-        // 4. Añadir los nuevos ejercicios
-        int addedCount = 0;
-        for (const auto& [name, group] : newExercises) {
-            if (!currentExercises.contains(name)) {
-                currentExercises[name] = QJsonObject{
-                    {"muscleGroup", group},
-                    {"currentValue", 0},
-                    {"unit", "-"},
-                    {"sets", 0},
-                    {"repetitions", 0},
-                    {"lastUpdated", ""},
-                    {"history", QJsonArray()}
-                };
-                addedCount++;
-            }
+    if (!m_resetting) {
+        if (exists) {
+            emit exerciseUpdated(row);
+            emit historyChanged(row);
+        } else {
+            emit exerciseAdded(row);
         }
+    }
 
-        // 5. Actualizar datos
-        if (addedCount > 0) {
-            m_data["exercises"] = currentExercises;
-            save();
-            emit dataChanged();
-            emit showMessage("Éxito", "Success", QString("Añadidos %1 nuevos ejercicios").arg(addedCount), QString("%1 new exercises added").arg(addedCount));
-        } else {
-            emit showMessage("Info", "Info", "Todos los ejercicios aleatorios ya existían", "All the random exercises already existed");
+    return true;
+}
+
+void DataCenter::addRandomExercises(int number) {
+    // 1. Muestra aleatoria del catálogo compilado
+    QList<const ExerciseCatalog::Entry*> newExercises;
+    std::sample(
+        std::begin(ExerciseCatalog::kEntries),
+        std::end(ExerciseCatalog::kEntries),
+        std::back_inserter(newExercises),
+        number,
+        std::mt19937{std::random_device{}()}
+        );
+
+    // 2. Añadir los que no existen ya, en una sola transacción
+    beginBatch();
+    int addedCount = 0;
+    for (const ExerciseCatalog::Entry* entry : std::as_const(newExercises)) {
+        const QString name = ExerciseCatalog::name(*entry);
+        if (!m_store.contains(name)) {
+            commitMutation(QJsonObject{
+                {"op", "addExercise"},
+                {"name", name},
+                {"muscleGroup", QString(ExerciseCatalog::groupName(entry->group))},
+                {"value", 0},
+                {"unit", "-"},
+                {"sets", 0},
+                {"repetitions", 0},
+                {"timestamp", ""}
+            });
+            addedCount++;
         }
+    }
+    if (!commit())
+        addedCount = 0;
 
-    } catch (const std::exception& e) {
-        qWarning() << "Error en addRandomExercises:" << e.what();
-        emit showMessage("Error", "Error", "Error añadiendo ejercicios", "Error adding exercises");
+    // 3. Informar del resultado
+    if (addedCount > 0) {
+        emit showMessage("Éxito", "Success", QString("Añadidos %1 nuevos ejercicios").arg(addedCount), QString("%1 new exercises added").arg(addedCount));
+    } else {
+        emit showMessage("Info", "Info", "Todos los ejercicios aleatorios ya existían", "All the random exercises already existed");
     }
 }
 
 void DataCenter::updateExercise(const QString& name, double value, const QString& unit, int sets, int reps) {
-    QJsonObject exercises = m_data["exercises"].toObject();
-    if (!exercises.contains(name)) return;
-
-    QJsonObject exercise = exercises[name].toObject();
-    QDateTime now = QDateTime::currentDateTime();
-
-    // Crear nuevo registro
-    QJsonObject newRecord {
-        {"timestamp", now.toString(Qt::ISODate)},
+    ScopedTimer timer("data.updateExercise");
+    commitMutation(QJsonObject{
+        {"op", "updateExercise"},
+        {"name", name},
         {"value", value},
         {"unit", unit},
         {"sets", sets},
-        {"repetitions", reps}
-    };
+        {"repetitions", reps},
+        {"timestamp", ExerciseStore::formatTimestamp(QDateTime::currentMSecsSinceEpoch())}
+    });
+}
 
-    // Obtener historial existente y añadir nuevo registro
-    QJsonArray history = exercise["history"].toArray();
-    history.append(newRecord);
+bool DataCenter::applyUpdateExercise(const QString& name, double value, const QString& unit,
+                                     int sets, int reps, const QString& timestamp) {
+    // Crear nuevo registro; el almacén lo inserta en su posición cronológica
+    // y actualiza el ejercicio con los valores del registro más reciente
+    ExerciseStore::Record record;
+    record.timestamp = ExerciseStore::parseTimestamp(timestamp);
+    record.value = value;
+    record.unitId = m_store.internUnit(unit);
+    record.sets = sets;
+    record.repetitions = reps;
+    if (!record.fits()) {
+        qCWarning(lcData) << "updateExercise() - registro fuera de rango:" << sets << reps << unit;
+        return false;
+    }
 
-    // Ordenar historial por fecha (más antiguo primero)
-    QList<QJsonObject> historyList;
+    const int row = m_store.addRecord(name, record);
+    if (row < 0) return false;
+    recordRecord(UndoStack::Change::AddRecord, name, record);
 
-    // Usando iteradores tradicionales para evitar el warning
-    for (auto it = history.begin(); it != history.end(); ++it) {
-        historyList.append(it->toObject());
+    if (!m_resetting) {
+        emit recordInserted(row, m_store.at(row).history.indexOf(record));
+        emit exerciseUpdated(row);
+        emit historyChanged(row);
     }
+    return true;
+}
 
-    std::sort(historyList.begin(), historyList.end(), [](const QJsonObject &a, const QJsonObject &b) {
-        QDateTime dateA = QDateTime::fromString(a["timestamp"].toString(), Qt::ISODate);
-        QDateTime dateB = QDateTime::fromString(b["timestamp"].toString(), Qt::ISODate);
-        return dateA < dateB;
+void DataCenter::removeExercise(const QString& name) {
+    commitMutation(QJsonObject{
+        {"op", "removeExercise"},
+        {"name", name}
     });
+}
 
-    // Convertir de vuelta a QJsonArray
-    QJsonArray sortedHistory;
-    for (const QJsonObject& obj : historyList) {
-        sortedHistory.append(obj);
+bool DataCenter::applyRemoveExercise(const QString& name) {
+    const int row = m_store.indexOf(name);
+    if (row >= 0) {
+        recordExercise(UndoStack::Change::RemoveExercise, row);
+        if (!m_resetting) emit exerciseAboutToBeRemoved(row);
+        m_store.removeExercise(name);
+        if (!m_resetting) emit exerciseRemoved(row);
+        qCDebug(lcData) << "removeExercise()" << name << "eliminado";
+        return true;
     }
 
-    // Actualizar ejercicio con los valores del último registro del historial
-    QJsonObject lastRecord = sortedHistory.last().toObject();
-    exercise["currentValue"] = lastRecord["value"].toDouble();
-    exercise["unit"] = lastRecord["unit"].toString();
-    exercise["sets"] = lastRecord["sets"].toInt();
-    exercise["repetitions"] = lastRecord["repetitions"].toInt();
-    exercise["lastUpdated"] = lastRecord["timestamp"].toString();
-    exercise["history"] = sortedHistory;
-
-    exercises[name] = exercise;
-    m_data["exercises"] = exercises;
+    qCDebug(lcData) << "removeExercise()" << name << "no existe";
+    return false;
+}
 
-    save();
-    emit dataChanged();
+void DataCenter::removeHistoryEntry(const QString &exerciseName, int index) {
+    commitMutation(QJsonObject{
+        {"op", "removeHistoryEntry"},
+        {"name", exerciseName},
+        {"index", index}
+    });
 }
 
-void DataCenter::removeExercise(const QString& name) {
-    qDebug() << "DataCenter::removeExercise Intentamos eliminar el ejercicio: " << name;
-    QJsonObject exercises = m_data["exercises"].toObject();
-    if (exercises.contains(name)) {
-        exercises.remove(name);
-        qDebug() << "DataCenter::removeExercise el elemento " << name << " eliminado correctamente.";
-        m_data["exercises"] = exercises;
-        save();
-        emit dataChanged();
+bool DataCenter::applyRemoveHistoryEntry(const QString &exerciseName, int index) {
+    // El índice se refiere al historial ordenado cronológicamente (más antiguo primero)
+    const ExerciseStore::Exercise* exercise = m_store.find(exerciseName);
+    if (!exercise || index < 0 || index >= exercise->history.size()) return false;
+
+    const qint64 removedTimestamp = exercise->history.timestampAt(index);
+    recordRecord(UndoStack::Change::RemoveRecord, exerciseName, exercise->history.at(index));
+    const int row = m_store.removeRecord(exerciseName, index);
+    exercise = &m_store.at(row);
+
+    if (!m_resetting) {
+        emit recordRemoved(row, index);
+        emit exerciseUpdated(row);
+        emit historyChanged(row);
+    }
+
+    if (exercise->history.isEmpty()) {
+        qCDebug(lcData) << "removeHistoryEntry() historial vacío:" << exerciseName;
     } else {
-        qDebug() << "DataCenter::removeExercise el elemento " << name << " no existe!";
+        qCDebug(lcData) << "removeHistoryEntry()" << exerciseName << ExerciseStore::formatTimestamp(removedTimestamp)
+                        << "más reciente:" << ExerciseStore::formatTimestamp(exercise->lastUpdated);
     }
+
+    return true;
 }
 
-void DataCenter::removeHistoryEntry(const QString &exerciseName, int index) {
-    QJsonObject exercises = m_data["exercises"].toObject();
-    if (!exercises.contains(exerciseName)) return;
+void DataCenter::undo() {
+    if (!m_undoStack.canUndo() || m_batchDepth > 0)
+        return;
+
+    ScopedTimer timer("data.undo");
+    UndoStack::Step step = m_undoStack.takeUndo();
+    step.invert();
+    applyUndoStep(step);
+    step.invert();
+    m_undoStack.pushRedo(std::move(step));
+    emit undoChanged();
+}
 
-    QJsonObject exercise = exercises[exerciseName].toObject();
-    QJsonArray history = exercise["history"].toArray();
+void DataCenter::redo() {
+    if (!m_undoStack.canRedo() || m_batchDepth > 0)
+        return;
 
-    // Primero ordenamos el historial usando iteradores tradicionales
-    QList<QJsonObject> historyList;
-    for (auto it = history.constBegin(); it != history.constEnd(); ++it) {
-        historyList.append(it->toObject());
-    }
+    ScopedTimer timer("data.redo");
+    UndoStack::Step step = m_undoStack.takeRedo();
+    applyUndoStep(step);
+    m_undoStack.pushUndo(std::move(step));
+    emit undoChanged();
+}
 
-    std::sort(historyList.begin(), historyList.end(), [](const QJsonObject &a, const QJsonObject &b) {
-        QDateTime dateA = QDateTime::fromString(a["timestamp"].toString(), Qt::ISODate);
-        QDateTime dateB = QDateTime::fromString(b["timestamp"].toString(), Qt::ISODate);
-        return dateA < dateB;
-    });
+void DataCenter::beginBatch() {
+    // Anidadas: sólo cuenta la más externa
+    if (m_batchDepth++ > 0)
+        return;
+
+    m_batchFailed = false;
+    beginStoreReset();
+}
+
+bool DataCenter::commit() {
+    if (m_batchDepth == 0)
+        return false;
+    if (--m_batchDepth > 0)
+        return !m_batchFailed;
+    QMetaObject::invokeMethod(this, &DataCenter::finishPendingImport, Qt::QueuedConnection);
+    if (m_batchFailed) {
+        discardBatch();
+        return false;
+    }
 
-    // Verificamos que el índice sea válido después de ordenar
-    if (index < 0 || index >= historyList.size()) return;
+    ScopedTimer timer("data.batch");
+    const QJsonArray mutations = std::exchange(m_batchMutations, QJsonArray());
+    UndoStack::Step step = std::exchange(m_batchStep, UndoStack::Step());
+    endStoreReset();
 
-    const QString removedTimestamp = historyList[index]["timestamp"].toString();
-    historyList.removeAt(index);
+    if (mutations.isEmpty())
+        return true;
 
-    // Convertimos de vuelta a QJsonArray usando iteradores
-    QJsonArray sortedHistory;
-    for (auto it = historyList.constBegin(); it != historyList.constEnd(); ++it) {
-        sortedHistory.append(*it);
+    if (!step.isEmpty()) {
+        m_undoStack.push(std::move(step));
+        emit undoChanged();
     }
 
-    exercise["history"] = sortedHistory;
+    // Un solo registro del diario: al reproducirlo se aplica entero o nada
+    QJsonObject record{
+        {"op", "batch"},
+        {"mutations", mutations}
+    };
+    record["seq"] = m_sequence + 1;
+    appendToJournal(record);
+    qCDebug(lcData) << "commit()" << mutations.size() << "cambios";
+    return true;
+}
 
-    // Actualizar currentValue si era el último registro
-    if (sortedHistory.isEmpty()) {
-        exercise["currentValue"] = 0;
-        exercise["repetitions"] = 0;
-        exercise["sets"] = 0;
-        exercise["lastUpdated"] = "";
-        exercise["unit"] = "-";
+void DataCenter::rollback() {
+    if (m_batchDepth == 0)
+        return;
 
-        qDebug() << "ℹ️ History is empty. Resetting exercise:"
-                 << "\n  currentValue: 0"
-                 << "\n  repetitions: 0"
-                 << "\n  sets: 0"
-                 << "\n  lastUpdated: (empty)"
-                 << "\n  unit: -";
-    } else {
-        // Obtenemos el último registro (más reciente)
-        const QJsonObject lastEntry = sortedHistory.last().toObject();
-        const QString newestTimestamp = lastEntry["timestamp"].toString();
-        const QString lastUpdated = exercise["lastUpdated"].toString();
-
-        qDebug() << "🧾 Last updated timestamp:" << lastUpdated
-                 << "\n🗑️ Removed entry timestamp:" << removedTimestamp
-                 << "\n🆕 Newest timestamp:" << newestTimestamp;
-
-        // Si el registro eliminado era el más reciente o el último actualizado
-        if (lastUpdated == removedTimestamp || newestTimestamp == removedTimestamp) {
-            exercise["currentValue"] = lastEntry["value"].toDouble();
-            exercise["unit"] = lastEntry["unit"].toString();
-            exercise["repetitions"] = lastEntry["repetitions"].toInt();
-            exercise["sets"] = lastEntry["sets"].toInt();
-            exercise["lastUpdated"] = newestTimestamp;
-
-            qDebug() << "🔄 Updated exercise with new last entry:"
-                     << "\n  currentValue:" << lastEntry["value"].toDouble()
-                     << "\n  unit:" << lastEntry["unit"].toString()
-                     << "\n  repetitions:" << lastEntry["repetitions"].toInt()
-                     << "\n  sets:" << lastEntry["sets"].toInt()
-                     << "\n  lastUpdated:" << newestTimestamp;
+    // Dentro de otra transacción se descarta al cerrar la externa
+    m_batchFailed = true;
+    if (--m_batchDepth == 0) {
+        discardBatch();
+        QMetaObject::invokeMethod(this, &DataCenter::finishPendingImport, Qt::QueuedConnection);
+    }
+}
+
+void DataCenter::discardBatch() {
+    // Lo aplicado se deshace con los cambios apuntados, sin tocar el diario.
+    // Los metadatos (lastSync) no se apuntan y no se restauran.
+    UndoStack::Step step = std::exchange(m_batchStep, UndoStack::Step());
+    m_batchMutations = QJsonArray();
+    step.invert();
+    applyChanges(step);
+    endStoreReset();
+    qCDebug(lcData) << "rollback()" << step.changes.size() << "cambios descartados";
+}
+
+bool DataCenter::applyBatch(const QVariantList& mutations) {
+    beginBatch();
+    for (const QVariant& value : mutations) {
+        const QVariantMap mutation = value.toMap();
+        const QString op = mutation.value("op").toString();
+        const QString name = mutation.value("name").toString();
+
+        if (op == "addExercise") {
+            addExercise(name, mutation.value("muscleGroup").toString(), mutation.value("value").toDouble(),
+                        mutation.value("unit").toString(), mutation.value("sets").toInt(),
+                        mutation.value("repetitions").toInt());
+        } else if (op == "updateExercise") {
+            updateExercise(name, mutation.value("value").toDouble(), mutation.value("unit").toString(),
+                           mutation.value("sets").toInt(), mutation.value("repetitions").toInt());
+        } else if (op == "removeExercise") {
+            removeExercise(name);
+        } else if (op == "removeHistoryEntry") {
+            removeHistoryEntry(name, mutation.value("index").toInt());
         } else {
-            qDebug() << "✅ Removed entry was not the last updated. No update needed.";
+            qCWarning(lcData) << "applyBatch() operación desconocida:" << op;
+            m_batchFailed = true;
         }
     }
 
-    exercises[exerciseName] = exercise;
-    m_data["exercises"] = exercises;
+    return commit();
+}
 
-    save();
-    emit dataChanged();
+void DataCenter::setUndoMemoryBudget(qint64 bytes) {
+    if (bytes == m_undoStack.budget())
+        return;
+    m_undoStack.setBudget(bytes);
+    emit undoChanged();
 }
 
-bool DataCenter::hasHistory(const QString& exerciseName) const {
-    if (!m_data.contains("exercises")) return false;
+void DataCenter::recordRecord(UndoStack::Change::Type type, const QString& name, const ExerciseStore::Record& record) {
+    if (m_undoRecording)
+        m_undoRecording->addRecord(type, name, record);
+}
 
-    const QJsonObject exercises = m_data["exercises"].toObject();
-    if (!exercises.contains(exerciseName)) return false;
+void DataCenter::recordExercise(UndoStack::Change::Type type, int row) {
+    if (m_undoRecording)
+        m_undoRecording->addExercise(type, m_store.at(row));
+}
 
-    const QJsonObject exercise = exercises[exerciseName].toObject();
-    const QJsonArray history = exercise["history"].toArray();
+void DataCenter::applyUndoStep(UndoStack::Step& step) {
+    if (step.store) {
+        // Reinicio: se intercambia el almacén entero y se escribe el snapshot,
+        // igual que al borrarlo todo. El paso se queda con el estado actual.
+        beginStoreReset();
+        std::swap(m_store, *step.store);
+        writeResetSnapshot();
+        endStoreReset();
+        emit dataChanged();
+        return;
+    }
+
+    if (!applyChanges(step))
+        return;
 
-    return !history.isEmpty();
+    // Al diario va lo aplicado: O(registros cambiados), no una copia del almacén
+    QJsonObject mutation{
+        {"op", "changes"},
+        {"changes", changesToJson(step)}
+    };
+    mutation["seq"] = m_sequence + 1;
+    appendToJournal(mutation);
 }
 
-void DataCenter::reloadSampleData() {
-    qDebug() << "reloadSampleData()";
-    QFile file(getFilePath());
-    if (file.exists()) {
-        if (file.remove()) {
-            qDebug("Archivo eliminado correctamente, inicializando estructura vacía...");
+bool DataCenter::applyChanges(UndoStack::Step& step) {
+    // Muchos cambios (deshacer una importación): un solo reinicio de los modelos
+    const bool reset = !m_resetting && step.changes.size() > kMaxTargetedChanges;
+    if (reset)
+        beginStoreReset();
+
+    QSet<QString> updated;
+    bool applied = false;
+    for (UndoStack::Change& change : step.changes) {
+        switch (change.type) {
+        case UndoStack::Change::AddRecord: {
+            const int row = m_store.addRecord(change.name, change.record);
+            if (row >= 0) {
+                if (!reset && !m_resetting)
+                    emit recordInserted(row, m_store.at(row).history.indexOf(change.record));
+                updated.insert(change.name);
+                applied = true;
+            }
+            break;
+        }
+        case UndoStack::Change::RemoveRecord: {
+            const ExerciseStore::Exercise* exercise = m_store.find(change.name);
+            const int index = exercise ? exercise->history.indexOf(change.record) : -1;
+            if (index >= 0) {
+                const int row = m_store.removeRecord(change.name, index);
+                if (!reset && !m_resetting)
+                    emit recordRemoved(row, index);
+                updated.insert(change.name);
+                applied = true;
+            }
+            break;
+        }
+        case UndoStack::Change::AddExercise: {
+            const ExerciseStore::Exercise& exercise = step.exercises.at(change.exercise);
+            if (m_store.contains(exercise.name))
+                break;
+            const int row = m_store.insertionRow(exercise.name);
+            if (!m_resetting) emit exerciseAboutToBeAdded(row);
+            m_store.insertExercise(exercise);
+            if (!m_resetting) emit exerciseAdded(row);
+            applied = true;
+            break;
+        }
+        case UndoStack::Change::RemoveExercise: {
+            const int row = m_store.indexOf(change.name);
+            if (row < 0)
+                break;
+            // Se guarda como está ahora: es lo que restaura el cambio contrario
+            step.exercises[change.exercise] = UndoStack::capture(m_store.at(row));
+            if (!m_resetting) emit exerciseAboutToBeRemoved(row);
+            m_store.removeExercise(change.name);
+            if (!m_resetting) emit exerciseRemoved(row);
+            updated.remove(change.name);
+            applied = true;
+            break;
+        }
+        }
+    }
+
+    if (reset) {
+        endStoreReset();
+    } else if (!m_resetting) {
+        for (const QString& name : std::as_const(updated)) {
+            const int row = m_store.indexOf(name);
+            if (row >= 0) {
+                emit exerciseUpdated(row);
+                emit historyChanged(row);
+            }
         }
     }
+
+    return applied;
+}
+
+QJsonArray DataCenter::changesToJson(const UndoStack::Step& step) const {
+    static const char* const kTypes[] = {"addRecord", "removeRecord", "addExercise", "removeExercise"};
+
+    QJsonArray changes;
+    for (const UndoStack::Change& change : step.changes) {
+        QJsonObject json{
+            {"type", kTypes[change.type]},
+            {"name", change.name}
+        };
+        if (change.type == UndoStack::Change::AddRecord || change.type == UndoStack::Change::RemoveRecord) {
+            json["record"] = QJsonObject{
+                {"timestamp", ExerciseStore::formatTimestamp(change.record.timestamp)},
+                {"value", change.record.value},
+                {"unit", m_store.unit(change.record.unitId)},
+                {"sets", change.record.sets},
+                {"repetitions", change.record.repetitions}
+            };
+        } else if (change.type == UndoStack::Change::AddExercise) {
+            json["exercise"] = m_store.exerciseToJson(step.exercises.at(change.exercise));
+        }
+        changes.append(json);
+    }
+    return changes;
+}
+
+UndoStack::Step DataCenter::changesFromJson(const QJsonArray& changes) {
+    const auto recordFromJson = [this](const QJsonObject& json) {
+        ExerciseStore::Record record;
+        record.timestamp = ExerciseStore::parseTimestamp(json["timestamp"].toString());
+        record.value = json["value"].toDouble();
+        record.unitId = m_store.internUnit(json["unit"].toString());
+        record.sets = json["sets"].toInt();
+        record.repetitions = json["repetitions"].toInt();
+        return record;
+    };
+
+    UndoStack::Step step;
+    for (const QJsonValue& value : changes) {
+        const QJsonObject json = value.toObject();
+        const QString type = json["type"].toString();
+        const QString name = json["name"].toString();
+
+        if (type == "addRecord" || type == "removeRecord") {
+            step.addRecord(type == "addRecord" ? UndoStack::Change::AddRecord : UndoStack::Change::RemoveRecord,
+                           name, recordFromJson(json["record"].toObject()));
+        } else if (type == "addExercise" || type == "removeExercise") {
+            ExerciseStore::Exercise exercise;
+            exercise.name = name;
+            if (type == "addExercise") {
+                const QJsonObject exerciseJson = json["exercise"].toObject();
+                exercise.muscleGroupId = m_store.internMuscleGroup(exerciseJson["muscleGroup"].toString());
+                const QJsonArray history = exerciseJson["history"].toArray();
+                for (const QJsonValue& entry : history) {
+                    // insert() escribe directamente en las columnas: se filtra aquí
+                    const ExerciseStore::Record record = recordFromJson(entry.toObject());
+                    if (record.fits())
+                        exercise.history.insert(record);
+                }
+            }
+            step.addExercise(type == "addExercise" ? UndoStack::Change::AddExercise : UndoStack::Change::RemoveExercise,
+                             exercise);
+        } else {
+            qCWarning(lcData) << "DataCenter::changesFromJson tipo desconocido:" << type;
+        }
+    }
+    return step;
+}
+
+bool DataCenter::hasHistory(const QString& exerciseName) const {
+    const ExerciseStore::Exercise* exercise = m_store.find(exerciseName);
+    return exercise && !exercise->history.isEmpty();
+}
+
+void DataCenter::reloadSampleData() {
+    qCDebug(lcData) << "reloadSampleData()";
+    // Sustituye el almacén entero: no cabe dentro de una transacción abierta
+    if (m_batchDepth > 0) {
+        qCWarning(lcData) << "reloadSampleData() durante una transacción";
+        return;
+    }
+    if (clearStorage()) {
+        qCDebug(lcData) << "Datos guardados eliminados, inicializando estructura vacía...";
+    }
+    UndoStack::Step step;
+    step.store = m_store;
+    beginStoreReset();
     loadSampleData();
-    save();
+    writeResetSnapshot();
+    endStoreReset();
+    m_undoStack.push(std::move(step));
+    emit undoChanged();
     emit dataChanged();
 }
 
 void DataCenter::deleteAllExercises() {
-    QFile file(getFilePath());
-    if (file.exists()) {
-        if (file.remove()) {
-            qDebug("Archivo eliminado correctamente, inicializando estructura vacía...");
-            emit showMessage("Datos borrados", "Data deleted", "Todos los datos se han borrado correctamente", "All data has been successfully deleted");
-        } else {
-            qDebug("Error, no se ha podido borrar el archivo...");
-            emit showMessage("Error en el borrado", "Delete error", "Los datos no se han podido eliminar", "The data could not be deleted", "error");
-            return;
-        }
+    if (m_batchDepth > 0) {
+        qCWarning(lcData) << "deleteAllExercises() durante una transacción";
+        return;
+    }
+    if (clearStorage()) {
+        qCDebug(lcData) << "Datos guardados eliminados, inicializando estructura vacía...";
+        emit showMessage("Datos borrados", "Data deleted", "Todos los datos se han borrado correctamente", "All data has been successfully deleted");
+    } else {
+        qCWarning(lcData) << "Error, no se han podido borrar los datos guardados...";
+        emit showMessage("Error en el borrado", "Delete error", "Los datos no se han podido eliminar", "The data could not be deleted", "error");
+        return;
     }
 
+    // El almacén anterior sigue en memoria (y su fichero mapeado) para poder deshacer
+    UndoStack::Step step;
+    step.store = m_store;
+    beginStoreReset();
     loadEmptyData();
+    writeResetSnapshot();
+    endStoreReset();
+    m_undoStack.push(std::move(step));
+    emit undoChanged();
+    emit dataChanged();
+}
+
+QString DataCenter::getDataDirectory() const {
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
 }
 
-QString DataCenter::getFilePath() const {
+QString DataCenter::getLegacyFilePath() const {
     return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/exercises.json";
 }
 
+bool DataCenter::clearStorage() {
+    // En el hilo del worker, después de las escrituras que tenga en cola
+    bool ok = false;
+    QMetaObject::invokeMethod(m_worker, [this, &ok]() {
+        ok = m_worker->clear();
+    }, Qt::BlockingQueuedConnection);
+    return ok;
+}
+
+QString DataCenter::storageBackend() const {
+    return StorageBackend::kindName(m_storageKind);
+}
+
+void DataCenter::setStorageBackend(const QString& name) {
+    // Durante la carga el worker aún puede cambiar de motor
+    if (m_loading)
+        return;
+    const StorageBackend::Kind kind = StorageBackend::kindFromName(name, m_storageKind);
+    if (kind == m_storageKind)
+        return;
+    if (m_batchDepth > 0) {
+        qCWarning(lcData) << "setStorageBackend() durante una transacción";
+        return;
+    }
+
+    // Todo lo pendiente se escribe antes en el motor actual y se copia el
+    // estado completo al nuevo; el diario empieza vacío en los dos
+    flush();
+    const ExerciseStore store = m_store;
+    const qint64 sequence = m_sequence;
+    bool ok = false;
+    QMetaObject::invokeMethod(m_worker, [this, &store, kind, sequence, &ok]() {
+        ok = m_worker->migrate(kind, store, sequence);
+    }, Qt::BlockingQueuedConnection);
+
+    if (!ok) {
+        emit showMessage("Error", "Error", "No se pudieron migrar los datos", "The data could not be migrated", "error");
+        return;
+    }
+
+    // El motor anterior ya está vacío: la elección se escribe a disco ya. Si
+    // aun así se pierde, la carga no encuentra datos en él y migra desde este
+    QSettings settings;
+    settings.setValue(StorageBackend::kSettingsKey, StorageBackend::kindName(kind));
+    settings.sync();
+    m_savedSequence = m_sequence;
+    m_storageKind = kind;
+    remapSnapshot();
+    qCDebug(lcPersistence) << "setStorageBackend() -" << StorageBackend::kindName(kind);
+    emit storageBackendChanged();
+    emit persistenceChanged();
+}
+
 void DataCenter::loadTestData() {
     QDateTime now = QDateTime::currentDateTime();
 
@@ -458,29 +1004,25 @@ void DataCenter::loadTestData() {
         {"Leg Raise", {{"unit", "-"}, {"initial", 0.0}, {"increment", 0.0}}}
     };
 
-    QJsonObject exercises;
+    m_store.clear();
 
     // Función para generar historial de progresión
     auto generateHistory = [&](const QString& name, int daysBack, int entryCount) {
-        QJsonArray history;
         QMap<QString, QVariant> config = exerciseConfigs[name];
         double currentValue = config["initial"].toDouble();
         double increment = config["increment"].toDouble();
 
         for (int i = 0; i < entryCount; ++i) {
-            QDateTime timestamp = now.addDays(-(daysBack - i));
-
-            QJsonObject record{
-                {"timestamp", timestamp.toString(Qt::ISODate)},
-                {"value", currentValue},
-                {"unit", config["unit"].toString()},
-                {"repetitions", (name.contains("Press") || name == "Deadlift") ? 6 :
-                                    (name == "Pull-up") ? 5 :
-                                    (name == "Plank") ? 1 : 12},
-                {"sets", 3}
-            };
+            ExerciseStore::Record record;
+            record.timestamp = now.addDays(-(daysBack - i)).toMSecsSinceEpoch();
+            record.value = currentValue;
+            record.unitId = m_store.internUnit(config["unit"].toString());
+            record.repetitions = (name.contains("Press") || name == "Deadlift") ? 6 :
+                                     (name == "Pull-up") ? 5 :
+                                     (name == "Plank") ? 1 : 12;
+            record.sets = 3;
 
-            history.append(record);
+            m_store.addRecord(name, record);
 
             // Solo incrementar si no es un ejercicio sin peso
             if (increment > 0) {
@@ -492,8 +1034,6 @@ void DataCenter::loadTestData() {
                 }
             }
         }
-
-        return history;
     };
 
     // Generar todos los ejercicios
@@ -504,44 +1044,18 @@ void DataCenter::loadTestData() {
             int entryCount = (exerciseName == "Deadlift") ? 60 :
                                  (exerciseName.contains("Press")) ? 12 : 6;
 
-            QJsonArray history = generateHistory(exerciseName, daysBack, entryCount);
-
-            // Crear objeto de ejercicio
-            QJsonObject exercise;
-            exercise["muscleGroup"] = muscleGroup;
-
-            if (!history.isEmpty()) {
-                QJsonObject lastRecord = history.last().toObject();
-                exercise["currentValue"] = lastRecord["value"].toDouble();
-                exercise["unit"] = lastRecord["unit"].toString();
-                exercise["repetitions"] = lastRecord["repetitions"].toInt();
-                exercise["sets"] = lastRecord["sets"].toInt();
-                exercise["lastUpdated"] = lastRecord["timestamp"].toString();
-            } else {
-                exercise["currentValue"] = 0;
-                exercise["unit"] = "-";
-                exercise["repetitions"] = 0;
-                exercise["sets"] = 0;
-                exercise["lastUpdated"] = "";
-            }
-
-            exercise["history"] = history;
-            exercises[exerciseName] = exercise;
+            // El almacén actualiza los valores actuales con el último registro
+            m_store.setExercise(exerciseName, muscleGroup);
+            generateHistory(exerciseName, daysBack, entryCount);
         }
     }
-
-    m_data = QJsonObject{{"exercises", exercises}};
 }
 
 void DataCenter::loadEmptyData() {
     // Crear estructura vacía
-    m_data = QJsonObject{
-        {"exercises", QJsonObject{}}
-    };
+    m_store.clear();
 
-    save();
-    emit dataChanged();
-    qDebug() << "Estructura vacía lista para ingresar ejercicios manualmente.";
+    qCDebug(lcData) << "Estructura vacía lista para ingresar ejercicios manualmente.";
 }
 
 void DataCenter::loadSampleData() {
@@ -555,125 +1069,321 @@ void DataCenter::loadSampleData() {
         {"Core", {"Plank", "Russian Twist", "Crunch", "Leg Raise", "Hanging Knee Raise"}}
     };
 
-    QJsonObject exercises;
+    m_store.clear();
 
-    // Crear cada ejercicio con estructura vacía
+    // Crear cada ejercicio con estructura vacía (valores a 0, unidad "-", sin historial)
     for (const QString& muscleGroup : muscleGroups.keys()) {
         for (const QString& exerciseName : muscleGroups[muscleGroup]) {
-            QJsonObject exercise;
-            exercise["muscleGroup"] = muscleGroup;
-            exercise["currentValue"] = 0;         // Valor inicial 0
-            exercise["unit"] = "-";               // Unidad no especificada
-            exercise["sets"] = 0;                 // 0 series por defecto
-            exercise["repetitions"] = 0;          // 0 repeticiones por defecto
-            exercise["lastUpdated"] = "";         // Fecha vacía
-            exercise["history"] = QJsonArray();   // Array de historial vacío
-
-            exercises[exerciseName] = exercise;
+            m_store.setExercise(exerciseName, muscleGroup);
         }
     }
 
-    // Crear la estructura principal de datos
-    m_data = QJsonObject{
-        {"exercises", exercises},
-        {"lastSync", QDateTime::currentDateTime().toString(Qt::ISODate)},
-        {"appVersion", "1.0.0"}
-    };
+    m_store.setMetadata("lastSync", QDateTime::currentDateTime().toString(Qt::ISODate));
+    m_store.setMetadata("appVersion", "1.0.0");
 }
-
 QString DataCenter::getMuscleGroup(const QString& exerciseName) const
 {
-    QJsonObject exercises = m_data["exercises"].toObject();
-    if (!exercises.contains(exerciseName)) return "";
+    const ExerciseStore::Exercise* exercise = m_store.find(exerciseName);
+    if (!exercise) return "";
 
-    return exercises[exerciseName].toObject()["muscleGroup"].toString();
+    return m_store.muscleGroup(*exercise);
 }
 
 double DataCenter::getCurrentValue(const QString& exerciseName) const
 {
-    QJsonObject exercises = m_data["exercises"].toObject();
-    if (!exercises.contains(exerciseName)) return 0.0;
+    const ExerciseStore::Exercise* exercise = m_store.find(exerciseName);
+    if (!exercise) return 0.0;
 
-    return exercises[exerciseName].toObject()["currentValue"].toDouble();
+    return exercise->currentValue;
 }
 
 QString DataCenter::getUnit(const QString& exerciseName) const
 {
-    QJsonObject exercises = m_data["exercises"].toObject();
-    if (!exercises.contains(exerciseName)) return "";
+    const ExerciseStore::Exercise* exercise = m_store.find(exerciseName);
+    if (!exercise) return "";
 
-    return exercises[exerciseName].toObject()["unit"].toString();
+    return m_store.unit(exercise->unitId);
 }
 
 int DataCenter::getRepetitions(const QString& exerciseName) const
 {
-    QJsonObject exercises = m_data["exercises"].toObject();
-    if (!exercises.contains(exerciseName)) return 0;
+    const ExerciseStore::Exercise* exercise = m_store.find(exerciseName);
+    if (!exercise) return 0;
 
-    return exercises[exerciseName].toObject()["repetitions"].toInt();
+    return exercise->repetitions;
 }
 
 int DataCenter::getSets(const QString& exerciseName) const
 {
-    QJsonObject exercises = m_data["exercises"].toObject();
-    if (!exercises.contains(exerciseName)) return 0;
+    const ExerciseStore::Exercise* exercise = m_store.find(exerciseName);
+    if (!exercise) return 0;
 
-    return exercises[exerciseName].toObject()["sets"].toInt();
+    return exercise->sets;
 }
 
 QVariantList DataCenter::getExerciseHistoryDetailed(const QString &exerciseName) const {
+    ScopedTimer timer("data.historyDetailed");
     QVariantList historyList;
 
-    if (!m_data.contains("exercises")) return historyList;
+    const ExerciseStore::Exercise* exercise = m_store.find(exerciseName);
+    if (!exercise) return historyList;
 
-    const QJsonObject exercisesObj = m_data["exercises"].toObject();
-    if (!exercisesObj.contains(exerciseName)) return historyList;
+    const ExerciseStore::History& history = exercise->history;
+    historyList.reserve(history.size());
 
-    const QJsonObject exerciseObj = exercisesObj[exerciseName].toObject();
-    const QJsonArray historyArray = exerciseObj["history"].toArray();
-
-    for (const QJsonValueConstRef &entryVal : historyArray) {
-        const QJsonObject entry = entryVal.toObject();
+    for (int i = 0; i < history.size(); ++i) {
         QVariantMap map;
-        map["date"] = entry["timestamp"].toString();
-        map["weight"] = entry["value"].toDouble();
-        map["unit"] = entry["unit"].toString();
-        map["sets"] = entry["sets"].toInt();
-        map["reps"] = entry["repetitions"].toInt();
+        map["date"] = ExerciseStore::formatTimestamp(history.timestampAt(i));
+        map["weight"] = history.valueAt(i);
+        map["unit"] = m_store.unit(history.unitIdAt(i));
+        map["sets"] = history.setsAt(i);
+        map["reps"] = history.repetitionsAt(i);
         historyList.append(map);
     }
 
     return historyList;
 }
 
-void DataCenter::exportData(const QString& filePath) {
-    QFile file(filePath);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(QJsonDocument(m_data).toJson());
-        file.close();
-        qDebug() << "Datos exportados a:" << filePath;
-        emit showMessage("Datos exportados", "Data exported", "Los datos se han guardado en:\n" + filePath, "The data has been saved in:\n" + filePath);
-    } else {
-        qWarning() << "No se pudo exportar los datos";
+HistoryListModel* DataCenter::historyModel(const QString& exerciseName, int period) {
+    QPointer<HistoryListModel>& model = m_historyModels[qMakePair(exerciseName, qMax(0, period))];
+    if (!model) {
+        // Se crea la primera vez que se pide y se comparte después. Al tener
+        // padre, QML no lo destruye; sigue al ejercicio por nombre aunque se
+        // borre y se vuelva a crear
+        model = new HistoryListModel(this, exerciseName, qMax(0, period), this);
+    }
+    return model;
+}
+
+QVariantList DataCenter::getAnalytics() const {
+    const HistoryAnalytics::Result& result = analytics();
+    QVariantList list;
+    list.reserve(result.exercises.size());
+
+    for (int row = 0; row < result.exercises.size(); ++row) {
+        const HistoryAnalytics::ExerciseResult& exercise = result.exercises.at(row);
+        list.append(QVariantMap{
+            {"name", m_store.at(row).name},
+            {"muscleGroup", m_store.muscleGroup(m_store.at(row))},
+            {"count", exercise.count},
+            {"slope", exercise.slope},
+            {"weeklyChange", exercise.weeklyChange},
+            {"mean", exercise.mean},
+            {"best", exercise.best},
+            {"last", exercise.last},
+            {"volume", exercise.volume},
+            {"movingAverage", exercise.count > 0
+                                  ? result.movingAverage.at(exercise.offset + exercise.count - 1) : 0.0}
+        });
+    }
+
+    return list;
+}
+
+QList<double> DataCenter::getMovingAverage(const QString& exerciseName) const {
+    const int row = m_store.indexOf(exerciseName);
+    if (row < 0) return {};
+
+    const HistoryAnalytics::Result& result = analytics();
+    const HistoryAnalytics::ExerciseResult& exercise = result.exercises.at(row);
+    return result.movingAverage.mid(exercise.offset, exercise.count);
+}
+
+int DataCenter::getTrainingDays(const QDate& from, const QDate& to) const {
+    return m_store.rollup().trainingDays(from, to);
+}
+
+QList<int> DataCenter::getDailyActivity(const QDate& from, const QDate& to) const {
+    return m_store.rollup().dailyActivity(from, to);
+}
+
+QVariantList DataCenter::getTrainingSummary(const QString& period, const QDate& from, const QDate& to) const {
+    const TrainingRollup::Period rollupPeriod = period == "month" ? TrainingRollup::Month : TrainingRollup::Week;
+    const QMap<int, QList<TrainingRollup::Bucket>> buckets = m_store.rollup().buckets(rollupPeriod, from, to);
+    const QStringList groups = m_store.muscleGroups();
+
+    QVariantList summary;
+    for (auto it = buckets.cbegin(); it != buckets.cend(); ++it) {
+        const QDate start = TrainingRollup::periodStart(rollupPeriod, it.key());
+        for (int group = 0; group < it.value().size(); ++group) {
+            const TrainingRollup::Bucket& bucket = it.value().at(group);
+            if (bucket.records == 0)
+                continue;
+            summary.append(QVariantMap{
+                {"start", start},
+                {"muscleGroup", groups.value(group)},
+                {"sets", bucket.sets},
+                {"repetitions", bucket.repetitions},
+                {"volume", bucket.volume},
+                {"sessions", bucket.sessions}
+            });
+        }
+    }
+
+    return summary;
+}
+
+void DataCenter::exportData(const QString& filePath, const QVariantMap& options) {
+    QVariantMap exportOptions = options;
+    if (options.value("incremental").toBool())
+        exportOptions["since"] = m_store.metadata().value("lastSync").toString();
+
+    // Se recorre una copia en m_exportPool; la hora se toma antes de copiar
+    // para que el siguiente incremental no se salte nada
+    const QString exportedAt = QDateTime::currentDateTime().toString(Qt::ISODate);
+    const ExerciseStore store = m_store;
+    const qint64 sequence = m_sequence;
+    m_exportPool.start([this, store, filePath, exportOptions, exportedAt, sequence]() {
+        const ExerciseExporter::Result result = ExerciseExporter::write(store, filePath, exportOptions);
+        QMetaObject::invokeMethod(this, [this, filePath, exportedAt, sequence, result]() {
+            finishExport(filePath, exportedAt, sequence, result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void DataCenter::finishExport(const QString& filePath, const QString& exportedAt, qint64 sequence,
+                              const ExerciseExporter::Result& result) {
+    if (!result.ok) {
+        qCWarning(lcData) << "No se pudo exportar los datos:" << result.error;
         emit showMessage("Error", "Error", "No se pudo guardar el archivo", "Could not save the file");
+        return;
+    }
+
+    qCDebug(lcData) << "Datos exportados a:" << filePath << "-" << result.records << "registros," << result.bytes << "bytes";
+    // Si se importó algo mientras se escribía, no está en el fichero
+    if (m_importSequence <= sequence) {
+        commitMutation(QJsonObject{
+            {"op", "setMetadata"},
+            {"key", "lastSync"},
+            {"value", exportedAt}
+        });
     }
+    emit showMessage("Datos exportados", "Data exported", "Los datos se han guardado en:\n" + filePath, "The data has been saved in:\n" + filePath);
+}
+
+void DataCenter::importData(const QUrl &fileUrl, const QVariantMap& options) {
+    if (m_importing)
+        return;
+
+    m_importing = true;
+    m_importProgress = 0.0;
+    emit importingChanged();
+    emit importProgressChanged();
+
+    // La lectura y validación se hacen en m_importPool; aquí sólo se fusiona
+    // el resultado, como una única operación del diario
+    m_importPool.start([this, filePath = fileUrl.toLocalFile(), options]() {
+        const ExerciseImporter::Result result = ExerciseImporter::read(filePath, options, [this](double progress) {
+            QMetaObject::invokeMethod(this, [this, progress]() {
+                m_importProgress = progress;
+                emit importProgressChanged();
+            }, Qt::QueuedConnection);
+        });
+        QMetaObject::invokeMethod(this, [this, result]() {
+            finishImport(result);
+        }, Qt::QueuedConnection);
+    });
 }
 
-void DataCenter::importData(const QUrl &fileUrl) {
-    QFile file(fileUrl.toLocalFile());
-    if (file.open(QIODevice::ReadOnly)) {
-        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-        file.close();
+void DataCenter::finishImport(const ExerciseImporter::Result& result) {
+    // La fusión reinicia los modelos y va al diario por separado: se espera a
+    // que se cierre la transacción (finishPendingImport)
+    if (m_batchDepth > 0) {
+        m_pendingImport = result;
+        return;
+    }
 
-        if (!doc.isNull() && doc.isObject()) {
-            m_data = doc.object();
-            save();
-            emit dataChanged();
-            emit showMessage("Datos importados", "Data imported", "Los datos se han importado correctamente", "The data has been imported successfully");
-        } else {
-            emit showMessage("Error", "Error", "El archivo no contiene datos válidos", "The file does not contain valid data");
+    m_importing = false;
+    m_importProgress = 1.0;
+    emit importingChanged();
+    emit importProgressChanged();
+
+    if (!result.ok) {
+        qCWarning(lcData) << "importData()" << result.error;
+        emit showMessage("Error", "Error", "El archivo no contiene datos válidos", "The file does not contain valid data");
+        return;
+    }
+
+    m_importedRecords = 0;
+    m_importRejected = 0;
+    if (result.records > 0) {
+        commitMutation(QJsonObject{
+            {"op", "import"},
+            {"exercises", result.exercises}
+        });
+    }
+
+    const int duplicates = result.duplicates + (result.records - m_importedRecords - m_importRejected);
+    const int invalid = result.invalid + m_importRejected;
+    qCDebug(lcData) << "importData()" << m_importedRecords << "registros nuevos," << duplicates
+                    << "repetidos," << invalid << "no válidos";
+    emit showMessage("Datos importados", "Data imported",
+                     QString("Registros nuevos: %1\nRepetidos: %2\nNo válidos: %3")
+                         .arg(m_importedRecords).arg(duplicates).arg(invalid),
+                     QString("New records: %1\nDuplicates: %2\nInvalid: %3")
+                         .arg(m_importedRecords).arg(duplicates).arg(invalid));
+}
+
+void DataCenter::finishPendingImport() {
+    if (m_pendingImport && m_batchDepth == 0)
+        finishImport(*std::exchange(m_pendingImport, std::nullopt));
+}
+
+bool DataCenter::applyImport(const QJsonArray& exercises) {
+    // Un solo reinicio de los modelos en vez de una señal por registro
+    const bool notify = !m_resetting;
+    if (notify)
+        beginStoreReset();
+
+    // Se fusiona por nombre y fecha: lo que ya está en el almacén no se duplica
+    int added = 0;
+    int rejected = 0;
+    bool created = false;
+    for (const QJsonValue& value : exercises) {
+        const QJsonObject json = value.toObject();
+        const QString name = json["name"].toString();
+        if (name.isEmpty())
+            continue;
+        if (!m_store.contains(name)) {
+            const int row = m_store.setExercise(name, json["muscleGroup"].toString());
+            recordExercise(UndoStack::Change::AddExercise, row);
+            created = true;
         }
-    } else {
-        emit showMessage("Error", "Error", "No se pudo leer el archivo", "Could not read the file");
+
+        const QJsonArray history = json["history"].toArray();
+        for (const QJsonValue& entry : history) {
+            const QJsonObject recordJson = entry.toObject();
+            ExerciseStore::Record record;
+            record.timestamp = ExerciseStore::parseTimestamp(recordJson["timestamp"].toString());
+            if (record.timestamp == ExerciseStore::kNoTimestamp
+                || m_store.find(name)->history.containsTimestamp(record.timestamp))
+                continue;
+
+            record.value = recordJson["value"].toDouble();
+            record.unitId = m_store.internUnit(recordJson["unit"].toString());
+            record.sets = recordJson["sets"].toInt();
+            record.repetitions = recordJson["repetitions"].toInt();
+            // El importador ya valida series y repeticiones; aquí puede faltar
+            // sitio en la tabla de unidades
+            if (m_store.addRecord(name, record) < 0) {
+                ++rejected;
+                continue;
+            }
+            recordRecord(UndoStack::Change::AddRecord, name, record);
+            ++added;
+        }
+    }
+
+    if (notify)
+        endStoreReset();
+
+    // La exportación incremental selecciona por fecha y los registros
+    // importados pueden ser antiguos: la siguiente vuelve a ser completa
+    if (added > 0) {
+        m_store.removeMetadata("lastSync");
+        m_importSequence = m_sequence + 1;
     }
+    m_importedRecords = added;
+    m_importRejected = rejected;
+    return added > 0 || created;
 }
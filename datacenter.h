@@ -2,21 +2,73 @@
 #define DATACENTER_H
 
 #include <QObject>
+#include <QHash>
 #include <QJsonObject>
+#include <QPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <optional>
+#include "exerciseexporter.h"
+#include "exerciseimporter.h"
+#include "exercisestore.h"
+#include "historyanalytics.h"
+#include "persistenceworker.h"
+#include "undostack.h"
+
+class HistoryListModel;
 
 class DataCenter : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(QJsonObject data READ data NOTIFY dataChanged)
+    // Carga inicial en segundo plano
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    Q_PROPERTY(bool ready READ isReady NOTIFY loadingChanged)
+    Q_PROPERTY(double progress READ progress NOTIFY progressChanged)
+    // Persistencia en segundo plano
+    Q_PROPERTY(int saveDelay READ saveDelay WRITE setSaveDelay NOTIFY saveDelayChanged)
+    Q_PROPERTY(int pendingWrites READ pendingWrites NOTIFY persistenceChanged)
+    Q_PROPERTY(qint64 lastSaveDuration READ lastSaveDuration NOTIFY persistenceChanged)
+    // Importación en segundo plano
+    Q_PROPERTY(bool importing READ isImporting NOTIFY importingChanged)
+    Q_PROPERTY(double importProgress READ importProgress NOTIFY importProgressChanged)
+    // Deshacer/rehacer; el presupuesto es en bytes
+    Q_PROPERTY(bool canUndo READ canUndo NOTIFY undoChanged)
+    Q_PROPERTY(bool canRedo READ canRedo NOTIFY undoChanged)
+    Q_PROPERTY(qint64 undoMemoryBudget READ undoMemoryBudget WRITE setUndoMemoryBudget NOTIFY undoChanged)
+    // Motor de almacenamiento ("binary" o "sqlite"); al cambiarlo se migran los datos
+    Q_PROPERTY(QString storageBackend READ storageBackend WRITE setStorageBackend NOTIFY storageBackendChanged)
 
 public:
     explicit DataCenter(QObject *parent = nullptr);
+    ~DataCenter() override;
 
     QJsonObject data() const;
+    const ExerciseStore& store() const { return m_store; }
+
+    bool isLoading() const { return m_loading; }
+    bool isReady() const { return m_ready; }
+    double progress() const { return m_progress; }
+
+    int saveDelay() const { return m_saveTimer.interval(); }
+    void setSaveDelay(int msecs);
+    int pendingWrites() const { return int(m_sequence - m_savedSequence); }
+    qint64 lastSaveDuration() const { return m_lastSaveDuration; }
+    bool isImporting() const { return m_importing; }
+    double importProgress() const { return m_importProgress; }
+    bool canUndo() const { return m_undoStack.canUndo(); }
+    bool canRedo() const { return m_undoStack.canRedo(); }
+    qint64 undoMemoryBudget() const { return m_undoStack.budget(); }
+    void setUndoMemoryBudget(qint64 bytes);
+    QString storageBackend() const;
+    void setStorageBackend(const QString& name);
 
     // Métodos cambiados de public slots a Q_INVOKABLE
     Q_INVOKABLE void load();
     Q_INVOKABLE void save();
+    Q_INVOKABLE void flush();
+    Q_INVOKABLE void releaseMemory();
     Q_INVOKABLE void addExercise(const QString& name, const QString& muscleGroup,
                                  double value, const QString& unit, int sets, int reps);
     Q_INVOKABLE void addRandomExercises(int number);
@@ -25,6 +77,21 @@ public:
     Q_INVOKABLE void removeHistoryEntry(const QString& exerciseName, int index);
     Q_INVOKABLE void reloadSampleData();
     Q_INVOKABLE void deleteAllExercises();
+    Q_INVOKABLE void undo();
+    Q_INVOKABLE void redo();
+
+    // Transacciones: las mutaciones entre beginBatch() y commit() se aplican
+    // al momento pero van al diario como un solo registro, con un solo aviso a
+    // los modelos (un reinicio) y un solo paso de deshacer. Si alguna falla,
+    // commit() deshace todas y devuelve false. Se pueden anidar.
+    Q_INVOKABLE void beginBatch();
+    Q_INVOKABLE bool commit();
+    Q_INVOKABLE void rollback();
+    bool isBatching() const { return m_batchDepth > 0; }
+    // Desde QML: [{op: "updateExercise", name, value, unit, sets, repetitions}, ...]
+    // con op addExercise (+ muscleGroup), updateExercise, removeExercise o
+    // removeHistoryEntry (name, index)
+    Q_INVOKABLE bool applyBatch(const QVariantList& mutations);
 
     Q_INVOKABLE QString getMuscleGroup(const QString& exerciseName) const;
     Q_INVOKABLE double getCurrentValue(const QString& exerciseName) const;
@@ -35,19 +102,139 @@ public:
 
     // Para las gráficas
     Q_INVOKABLE QVariantList getExerciseHistoryDetailed(const QString& exerciseName) const;
+    // Historial paginado para listas; uno por ejercicio y periodo (meses, 0 todo),
+    // compartido y propiedad de DataCenter
+    Q_INVOKABLE HistoryListModel* historyModel(const QString& exerciseName, int period = 0);
+
+    // Resumen de todos los ejercicios (HistoryAnalytics), en kg si hay peso
+    const HistoryAnalytics::Result& analytics() const { return m_analytics.compute(m_store); }
+    Q_INVOKABLE QVariantList getAnalytics() const;
+    Q_INVOKABLE QList<double> getMovingAverage(const QString& exerciseName) const;
+
+    // Calendario y resúmenes por periodo (TrainingRollup); period es "week" o "month"
+    Q_INVOKABLE int getTrainingDays(const QDate& from, const QDate& to) const;
+    Q_INVOKABLE QList<int> getDailyActivity(const QDate& from, const QDate& to) const;
+    Q_INVOKABLE QVariantList getTrainingSummary(const QString& period, const QDate& from, const QDate& to) const;
 
     // Para importar y exportar datos
-    Q_INVOKABLE void exportData(const QString& filePath);
-    Q_INVOKABLE void importData(const QUrl &fileUrl);
+    // options como en ExerciseExporter; con "incremental" sólo lo posterior a
+    // lastSync, salvo tras una importación, que vuelve a exportarlo todo
+    Q_INVOKABLE void exportData(const QString& filePath, const QVariantMap& options = QVariantMap());
+    // Fusiona con los datos actuales; options como en ExerciseImporter (CSV)
+    Q_INVOKABLE void importData(const QUrl &fileUrl, const QVariantMap& options = QVariantMap());
 
 signals:
     void dataChanged();
+    void loadingChanged();
+    void progressChanged();
+    void saveDelayChanged();
+    void persistenceChanged();
+    void importingChanged();
+    void importProgressChanged();
+    void undoChanged();
+    void storageBackendChanged();
+
+    // Notificaciones por ejercicio (fila en el almacén) para los modelos
+    void exerciseAboutToBeAdded(int row);
+    void exerciseAdded(int row);
+    void exerciseUpdated(int row);
+    void exerciseAboutToBeRemoved(int row);
+    void exerciseRemoved(int row);
+    void historyChanged(int row);
+    // Alta o baja de un registro suelto (índice en el historial cronológico);
+    // llega antes del historyChanged de la misma fila
+    void recordInserted(int row, int index);
+    void recordRemoved(int row, int index);
+    void storeAboutToBeReset();
+    void storeReset();
     void showMessage(QString title, QString englishTitle, QString message, QString englishMessage, QString messageType = "info");
 
 private:
-    QString getFilePath() const;
-    QJsonObject m_data;
-    void loadData();
+    QString getDataDirectory() const;
+    QString getLegacyFilePath() const;
+    bool clearStorage();
+
+    // Estado en memoria; el JSON sólo se genera al exportar
+    ExerciseStore m_store;
+    // Se recalcula sólo si cambió la versión del almacén
+    mutable HistoryAnalytics m_analytics;
+
+    // Cada cambio se añade al diario y se marca el almacén como sucio; tras un
+    // periodo sin cambios (saveDelay) el worker escribe un snapshot nuevo
+    QThread m_ioThread;
+    PersistenceWorker* m_worker = nullptr;
+    QTimer m_saveTimer;
+    qint64 m_sequence = 0;
+    qint64 m_savedSequence = 0;
+    qint64 m_lastSaveDuration = -1;
+
+    // Leer o escribir un fichero grande puede tardar: va en su propio hilo para
+    // no retener al worker, del que save() y clearStorage() esperan respuesta
+    QThreadPool m_importPool;
+    QThreadPool m_exportPool;
+    bool m_importing = false;
+    double m_importProgress = 0.0;
+    int m_importedRecords = 0;
+    int m_importRejected = 0;       // no caben en el almacén (ExerciseStore::Record::fits)
+    qint64 m_importSequence = 0;    // última importación que añadió registros
+    // Importación terminada durante una transacción; se aplica al cerrarla
+    std::optional<ExerciseImporter::Result> m_pendingImport;
+    void finishImport(const ExerciseImporter::Result& result);
+    void finishPendingImport();
+    void finishExport(const QString& filePath, const QString& exportedAt, qint64 sequence,
+                      const ExerciseExporter::Result& result);
+
+    bool m_loading = false;
+    qint64 m_loadStarted = 0;
+    bool m_ready = false;
+    double m_progress = 0.0;
+
+    // Durante un reinicio completo no se emiten notificaciones por ejercicio
+    bool m_resetting = false;
+    void beginStoreReset();
+    void endStoreReset();
+
+    void commitMutation(QJsonObject mutation);
+    void appendToJournal(const QJsonObject& mutation);
+    bool applyMutation(const QJsonObject& mutation);
+    void finishLoad(const PersistenceWorker::LoadResult& result);
+    void setLoading(bool loading);
+    void replayJournal(qint64 snapshotSequence, const QList<QJsonObject>& records);
+    void scheduleSave();
+    void writeSnapshotAsync();
+    void writeResetSnapshot();
+    void onSnapshotWritten(qint64 sequence, qint64 durationMs, bool ok);
+    void remapSnapshot();
+    void onSnapshotMapped(const QSharedPointer<const BinarySnapshot>& snapshot);
+    // Copia en este hilo del motor en uso; el worker la actualiza con backendChanged
+    StorageBackend::Kind m_storageKind = StorageBackend::Binary;
+
+    bool applyAddExercise(const QString& name, const QString& muscleGroup, double value,
+                          const QString& unit, int sets, int reps, const QString& timestamp);
+    bool applyUpdateExercise(const QString& name, double value, const QString& unit,
+                             int sets, int reps, const QString& timestamp);
+    bool applyRemoveExercise(const QString& name);
+    bool applyRemoveHistoryEntry(const QString& exerciseName, int index);
+    bool applyImport(const QJsonArray& exercises);
+
+    // Cada mutación confirmada apunta aquí lo que cambia (ver UndoStack)
+    UndoStack m_undoStack;
+    UndoStack::Step* m_undoRecording = nullptr;
+
+    int m_batchDepth = 0;
+    bool m_batchFailed = false;
+    QJsonArray m_batchMutations;
+    UndoStack::Step m_batchStep;
+    void discardBatch();
+    void recordRecord(UndoStack::Change::Type type, const QString& name, const ExerciseStore::Record& record);
+    void recordExercise(UndoStack::Change::Type type, int row);
+    void applyUndoStep(UndoStack::Step& step);
+    bool applyChanges(UndoStack::Step& step);
+    QJsonArray changesToJson(const UndoStack::Step& step) const;
+    UndoStack::Step changesFromJson(const QJsonArray& changes);
+
+    QHash<QPair<QString, int>, QPointer<HistoryListModel>> m_historyModels;
+
     void loadEmptyData();
     void loadTestData();
     void loadSampleData();
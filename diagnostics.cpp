@@ -0,0 +1,195 @@
+#include "diagnostics.h"
+#include "logging.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QVariantMap>
+#include <algorithm>
+
+namespace {
+
+QByteArray keyFor(const char* name) {
+    // Los nombres son literales: no hace falta copiarlos
+    return QByteArray::fromRawData(name, qstrlen(name));
+}
+
+int bucketFor(qint64 usecs) {
+    int bucket = 0;
+    while (usecs > 1 && bucket < 31) {
+        usecs >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+double toMs(qint64 usecs) {
+    return usecs / 1000.0;
+}
+
+} // namespace
+
+Diagnostics::Diagnostics(QObject* parent) : QObject(parent) {
+    m_clock.start();
+    m_trace.reserve(kMaxTraceEvents);
+}
+
+Diagnostics* Diagnostics::instance() {
+    // Vive hasta el final del proceso; main() la crea en el hilo principal
+    static Diagnostics* diagnostics = new Diagnostics;
+    return diagnostics;
+}
+
+qint64 Diagnostics::Histogram::percentile(double fraction) const {
+    if (count == 0)
+        return 0;
+
+    // Cota superior del cubo donde cae el percentil (precisión de potencia de 2)
+    const qint64 target = qint64(fraction * count + 0.5);
+    qint64 seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += buckets[i];
+        if (seen >= target)
+            return std::min(qint64(1) << (i + 1), max);
+    }
+    return max;
+}
+
+void Diagnostics::addTiming(const char* name, qint64 startUsecs, qint64 durationUsecs) {
+    QMutexLocker locker(&m_mutex);
+
+    Histogram& histogram = m_histograms[keyFor(name)];
+    if (histogram.count == 0 || durationUsecs < histogram.min)
+        histogram.min = durationUsecs;
+    histogram.max = std::max(histogram.max, durationUsecs);
+    histogram.count++;
+    histogram.total += durationUsecs;
+    histogram.buckets[bucketFor(durationUsecs)]++;
+
+    // Buffer circular con los últimos eventos
+    const TraceEvent event{name, startUsecs, durationUsecs, quintptr(QThread::currentThreadId())};
+    if (m_trace.size() < kMaxTraceEvents) {
+        m_trace.append(event);
+    } else {
+        m_trace[m_traceHead] = event;
+        m_traceHead = (m_traceHead + 1) % kMaxTraceEvents;
+    }
+
+    notifyLocked();
+}
+
+void Diagnostics::increment(const char* name, qint64 amount) {
+    QMutexLocker locker(&m_mutex);
+    m_counters[keyFor(name)] += amount;
+    notifyLocked();
+}
+
+void Diagnostics::notifyLocked() {
+    // Como mucho una notificación pendiente: el panel no necesita cada evento
+    if (m_notifyPending)
+        return;
+    m_notifyPending = true;
+
+    QMetaObject::invokeMethod(this, [this]() {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_notifyPending = false;
+        }
+        emit changed();
+    }, Qt::QueuedConnection);
+}
+
+QVariantList Diagnostics::timers() const {
+    QMutexLocker locker(&m_mutex);
+
+    QVariantList result;
+    for (auto it = m_histograms.constBegin(); it != m_histograms.constEnd(); ++it) {
+        const Histogram& h = it.value();
+        result.append(QVariantMap{
+            {"name", QString::fromLatin1(it.key())},
+            {"count", h.count},
+            {"totalMs", toMs(h.total)},
+            {"meanMs", toMs(h.total / std::max<qint64>(1, h.count))},
+            {"minMs", toMs(h.min)},
+            {"maxMs", toMs(h.max)},
+            {"p50Ms", toMs(h.percentile(0.5))},
+            {"p95Ms", toMs(h.percentile(0.95))}
+        });
+    }
+
+    std::sort(result.begin(), result.end(), [](const QVariant& a, const QVariant& b) {
+        return a.toMap()["name"].toString() < b.toMap()["name"].toString();
+    });
+    return result;
+}
+
+QVariantList Diagnostics::counters() const {
+    QMutexLocker locker(&m_mutex);
+
+    QVariantList result;
+    for (auto it = m_counters.constBegin(); it != m_counters.constEnd(); ++it)
+        result.append(QVariantMap{{"name", QString::fromLatin1(it.key())}, {"value", it.value()}});
+
+    std::sort(result.begin(), result.end(), [](const QVariant& a, const QVariant& b) {
+        return a.toMap()["name"].toString() < b.toMap()["name"].toString();
+    });
+    return result;
+}
+
+QString Diagnostics::dumpTrace(const QString& filePath) {
+    QJsonArray events;
+    QJsonObject counters;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (int i = 0; i < m_trace.size(); ++i) {
+            const TraceEvent& event = m_trace.at((m_traceHead + i) % m_trace.size());
+            events.append(QJsonObject{
+                {"name", QString::fromLatin1(event.name)},
+                {"ph", "X"},
+                {"ts", event.start},
+                {"dur", event.duration},
+                {"pid", QCoreApplication::applicationPid()},
+                {"tid", qint64(event.thread)}
+            });
+        }
+        for (auto it = m_counters.constBegin(); it != m_counters.constEnd(); ++it)
+            counters[QString::fromLatin1(it.key())] = it.value();
+    }
+
+    QString path = filePath;
+    if (path.isEmpty()) {
+        const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+        QDir().mkpath(dir);
+        path = dir + "/trace-" + QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss") + ".json";
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(lcData) << "Diagnostics: no se pudo escribir la traza en" << path;
+        return QString();
+    }
+
+    const QJsonObject trace{{"traceEvents", events}, {"counters", counters}};
+    file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    if (!file.commit())
+        return QString();
+
+    qCDebug(lcData) << "Traza guardada en" << path;
+    return path;
+}
+
+void Diagnostics::reset() {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_histograms.clear();
+        m_counters.clear();
+        m_trace.clear();
+        m_traceHead = 0;
+    }
+    emit changed();
+}
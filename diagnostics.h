@@ -0,0 +1,94 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QVariantList>
+#include <array>
+
+// Instrumentación ligera: tiempos (con histograma logarítmico), contadores y
+// una traza con los últimos eventos. Es segura entre hilos (el worker de
+// persistencia también mide) y se expone a QML como singleton para el panel
+// oculto de SettingsPage. Los nombres deben ser literales de cadena.
+class Diagnostics : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariantList timers READ timers NOTIFY changed)
+    Q_PROPERTY(QVariantList counters READ counters NOTIFY changed)
+
+public:
+    static Diagnostics* instance();
+
+    // Microsegundos desde que se creó la instancia
+    qint64 now() const { return m_clock.nsecsElapsed() / 1000; }
+
+    void addTiming(const char* name, qint64 startUsecs, qint64 durationUsecs);
+    void increment(const char* name, qint64 amount = 1);
+
+    QVariantList timers() const;
+    QVariantList counters() const;
+
+    // Escribe la traza en formato Chrome trace (chrome://tracing, Perfetto) y
+    // devuelve la ruta; sin ruta se guarda en el directorio de datos de la app
+    Q_INVOKABLE QString dumpTrace(const QString& filePath = QString());
+    Q_INVOKABLE void reset();
+
+signals:
+    void changed();
+
+private:
+    explicit Diagnostics(QObject* parent = nullptr);
+
+    static constexpr int kBuckets = 32;     // potencias de 2 en µs
+    static constexpr int kMaxTraceEvents = 4096;
+
+    struct Histogram {
+        qint64 count = 0;
+        qint64 total = 0;
+        qint64 min = 0;
+        qint64 max = 0;
+        std::array<qint64, kBuckets> buckets {};
+
+        qint64 percentile(double fraction) const;
+    };
+
+    struct TraceEvent {
+        const char* name;
+        qint64 start;
+        qint64 duration;
+        quintptr thread;
+    };
+
+    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+    QHash<QByteArray, Histogram> m_histograms;
+    QHash<QByteArray, qint64> m_counters;
+    QList<TraceEvent> m_trace;
+    int m_traceHead = 0;
+    bool m_notifyPending = false;
+
+    void notifyLocked();
+};
+
+// Mide el tiempo entre su construcción y su destrucción
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(const char* name)
+        : m_name(name), m_start(Diagnostics::instance()->now()) {}
+    ~ScopedTimer() {
+        Diagnostics* diagnostics = Diagnostics::instance();
+        diagnostics->addTiming(m_name, m_start, diagnostics->now() - m_start);
+    }
+
+private:
+    Q_DISABLE_COPY(ScopedTimer)
+    const char* m_name;
+    qint64 m_start;
+};
+
+#endif // DIAGNOSTICS_H
@@ -0,0 +1,17 @@
+#include "exercisecatalog.h"
+#include <QVariantMap>
+
+namespace ExerciseCatalog {
+
+QVariantList toVariantList() {
+    static const QVariantList list = []() {
+        QVariantList exercises;
+        exercises.reserve(kCount);
+        for (const Entry& entry : kEntries)
+            exercises.append(QVariantMap{{"name", name(entry)}, {"group", QString(groupName(entry.group))}});
+        return exercises;
+    }();
+    return list;
+}
+
+} // namespace ExerciseCatalog
@@ -0,0 +1,52 @@
+#ifndef EXERCISECATALOG_H
+#define EXERCISECATALOG_H
+
+#include <QString>
+#include <QStringView>
+#include <QVariantList>
+
+// Catálogo de ejercicios predefinidos. La tabla (exercisecatalog_table.h) la
+// genera CMake desde data/exerciseList.txt al compilar: ya viene sin
+// duplicados y ordenada por nombre, así que en ejecución no se lee ni se
+// procesa ningún fichero.
+namespace ExerciseCatalog {
+
+enum class MuscleGroup : quint8 {
+    Shoulders,
+    Arms,
+    Chest,
+    Back,
+    Core,
+    Legs
+};
+
+struct Entry {
+    QStringView name;
+    MuscleGroup group;
+};
+
+constexpr QLatin1StringView groupName(MuscleGroup group) {
+    switch (group) {
+    case MuscleGroup::Shoulders: return QLatin1StringView("Shoulders");
+    case MuscleGroup::Arms: return QLatin1StringView("Arms");
+    case MuscleGroup::Chest: return QLatin1StringView("Chest");
+    case MuscleGroup::Back: return QLatin1StringView("Back");
+    case MuscleGroup::Core: return QLatin1StringView("Core");
+    case MuscleGroup::Legs: return QLatin1StringView("Legs");
+    }
+    return QLatin1StringView();
+}
+
+// QString sobre los datos estáticos, sin copiarlos
+inline QString name(const Entry& entry) {
+    return QString::fromRawData(reinterpret_cast<const QChar*>(entry.name.utf16()), entry.name.size());
+}
+
+// Lista [{name, group}] para QML; se construye una vez y se comparte
+QVariantList toVariantList();
+
+} // namespace ExerciseCatalog
+
+#include "exercisecatalog_table.h"
+
+#endif // EXERCISECATALOG_H
@@ -0,0 +1,227 @@
+#include "exerciseexporter.h"
+#include "diagnostics.h"
+#include "gzipstream.h"
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QLocale>
+#include <QSaveFile>
+#include <memory>
+
+namespace {
+
+constexpr qsizetype kBufferSize = 64 * 1024;
+
+// Texto pendiente de escribir: se pasa al fichero (o al compresor) cada vez
+// que supera kBufferSize, así que nunca crece más allá de un registro
+class Sink
+{
+public:
+    Sink(QIODevice* device, bool compress) : m_device(device) {
+        if (compress)
+            m_gzip = std::make_unique<GzipWriter>(device);
+        m_buffer.reserve(kBufferSize + 4096);
+    }
+
+    QByteArray& buffer() { return m_buffer; }
+
+    // Después de cada registro
+    bool commit() { return m_buffer.size() < kBufferSize || flush(); }
+
+    bool finish() { return flush() && (!m_gzip || m_gzip->finish()); }
+
+private:
+    QIODevice* m_device;
+    std::unique_ptr<GzipWriter> m_gzip;
+    QByteArray m_buffer;
+
+    bool flush() {
+        const bool ok = m_gzip ? m_gzip->write(m_buffer) : m_device->write(m_buffer) == m_buffer.size();
+        m_buffer.resize(0); // conserva la capacidad reservada
+        return ok;
+    }
+};
+
+void appendJsonString(QByteArray& out, const QString& text) {
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    const QByteArray utf8 = text.toUtf8();
+    for (const char c : utf8) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (uchar(c) < 0x20) {
+                out += "\\u00";
+                out += hex[uchar(c) >> 4];
+                out += hex[uchar(c) & 0xf];
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+QByteArray csvField(const QString& text) {
+    QByteArray utf8 = text.toUtf8();
+    if (!utf8.contains(',') && !utf8.contains('"') && !utf8.contains('\n') && !utf8.contains('\r'))
+        return utf8;
+    utf8.replace("\"", "\"\"");
+    return '"' + utf8 + '"';
+}
+
+QByteArray number(double value) {
+    return QByteArray::number(value, 'g', QLocale::FloatingPointShortest);
+}
+
+// Primer registro que exportar: todos, o los posteriores a since
+int firstRecord(const ExerciseStore::History& history, qint64 since) {
+    return since == ExerciseStore::kNoTimestamp ? 0 : history.lowerBound(since + 1);
+}
+
+bool writeJson(const ExerciseStore& store, qint64 since, const QString& sinceText, Sink& sink,
+               ExerciseExporter::Result* result) {
+    // Las unidades se codifican una vez
+    const QStringList units = store.units();
+    QList<QByteArray> unitJson;
+    for (const QString& unit : units) {
+        QByteArray encoded;
+        appendJsonString(encoded, unit);
+        unitJson.append(encoded);
+    }
+
+    QByteArray& out = sink.buffer();
+    out += "{\"exercises\":{";
+
+    bool firstExercise = true;
+    for (int row = 0; row < store.count(); ++row) {
+        const ExerciseStore::Exercise& exercise = store.at(row);
+        const ExerciseStore::History& history = exercise.history;
+        const int first = firstRecord(history, since);
+        if (since != ExerciseStore::kNoTimestamp && first == history.size())
+            continue;
+
+        if (!firstExercise)
+            out += ',';
+        firstExercise = false;
+        ++result->exercises;
+
+        appendJsonString(out, exercise.name);
+        out += ":{\"muscleGroup\":";
+        appendJsonString(out, store.muscleGroup(exercise));
+        out += ",\"currentValue\":" + number(exercise.currentValue);
+        out += ",\"unit\":" + unitJson.value(exercise.unitId, "\"\"");
+        out += ",\"sets\":" + QByteArray::number(exercise.sets);
+        out += ",\"repetitions\":" + QByteArray::number(exercise.repetitions);
+        out += ",\"lastUpdated\":";
+        appendJsonString(out, ExerciseStore::formatTimestamp(exercise.lastUpdated));
+        out += ",\"history\":[";
+
+        for (int i = first; i < history.size(); ++i) {
+            if (i > first)
+                out += ',';
+            out += "{\"timestamp\":";
+            appendJsonString(out, ExerciseStore::formatTimestamp(history.timestampAt(i)));
+            out += ",\"value\":" + number(history.valueAt(i));
+            out += ",\"unit\":" + unitJson.value(history.unitIdAt(i), "\"\"");
+            out += ",\"sets\":" + QByteArray::number(history.setsAt(i));
+            out += ",\"repetitions\":" + QByteArray::number(history.repetitionsAt(i));
+            out += '}';
+            ++result->records;
+            if (!sink.commit())
+                return false;
+        }
+        out += "]}";
+    }
+    out += '}';
+
+    // Los metadatos son pocos: se serializan de una vez y se les quitan las llaves
+    QJsonObject metadata = store.metadata();
+    if (!sinceText.isEmpty())
+        metadata["since"] = sinceText;
+    const QByteArray json = QJsonDocument(metadata).toJson(QJsonDocument::Compact);
+    if (json.size() > 2)
+        out += ',' + json.mid(1, json.size() - 2);
+    out += '}';
+    return true;
+}
+
+bool writeCsv(const ExerciseStore& store, qint64 since, Sink& sink, ExerciseExporter::Result* result) {
+    const QStringList units = store.units();
+    QList<QByteArray> unitCsv;
+    for (const QString& unit : units)
+        unitCsv.append(csvField(unit));
+
+    QByteArray& out = sink.buffer();
+    out += "Date,Exercise,Muscle group,Weight,Unit,Sets,Reps\n";
+
+    for (int row = 0; row < store.count(); ++row) {
+        const ExerciseStore::Exercise& exercise = store.at(row);
+        const ExerciseStore::History& history = exercise.history;
+        const int first = firstRecord(history, since);
+        if (first == history.size())
+            continue;
+
+        ++result->exercises;
+        const QByteArray prefix = ',' + csvField(exercise.name) + ',' + csvField(store.muscleGroup(exercise)) + ',';
+        for (int i = first; i < history.size(); ++i) {
+            out += ExerciseStore::formatTimestamp(history.timestampAt(i)).toUtf8();
+            out += prefix;
+            out += number(history.valueAt(i));
+            out += ',' + unitCsv.value(history.unitIdAt(i));
+            out += ',' + QByteArray::number(history.setsAt(i));
+            out += ',' + QByteArray::number(history.repetitionsAt(i));
+            out += '\n';
+            ++result->records;
+            if (!sink.commit())
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+ExerciseExporter::Result ExerciseExporter::write(const ExerciseStore& store, const QString& filePath,
+                                                 const QVariantMap& options) {
+    ScopedTimer timer("export.write");
+    Result result;
+
+    const QFileInfo info(filePath);
+    const bool compressedName = info.suffix().toLower() == "gz";
+    const QString suffix = compressedName ? QFileInfo(info.completeBaseName()).suffix().toLower()
+                                          : info.suffix().toLower();
+    const QString format = options.value("format", suffix == "csv" ? "csv" : "json").toString();
+    const bool compress = options.value("compress", compressedName).toBool();
+    const QString sinceText = options.value("since").toString();
+    const qint64 since = ExerciseStore::parseTimestamp(sinceText);
+
+    // QSaveFile: si algo falla a medias el fichero anterior queda intacto
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        result.error = file.errorString();
+        return result;
+    }
+
+    Sink sink(&file, compress);
+    const bool written = format == "csv" ? writeCsv(store, since, sink, &result)
+                                         : writeJson(store, since, since != ExerciseStore::kNoTimestamp ? sinceText : QString(),
+                                                     sink, &result);
+    if (!written || !sink.finish()) {
+        result.error = file.errorString();
+        file.cancelWriting();
+        return result;
+    }
+
+    result.bytes = file.size();
+    if (!file.commit()) {
+        result.error = file.errorString();
+        return result;
+    }
+
+    result.ok = true;
+    return result;
+}
@@ -0,0 +1,32 @@
+#ifndef EXERCISEEXPORTER_H
+#define EXERCISEEXPORTER_H
+
+#include <QVariantMap>
+#include "exercisestore.h"
+
+// Exportación por streaming, pensada para un hilo secundario con una copia del
+// almacén: cada registro se escribe según se recorre el historial a través de
+// un buffer de tamaño fijo, así que la memoria no depende del historial.
+//
+// Opciones (todas opcionales):
+//   format    "json" (compacto, el formato de la copia de seguridad) o "csv"
+//             (las columnas que reconoce ExerciseImporter); por defecto según
+//             la extensión
+//   compress  gzip; por defecto si el fichero acaba en .gz
+//   since     fecha ISO: sólo los registros posteriores. Lo que se borró
+//             desde entonces no aparece; al importarlo se fusiona con lo que hay
+class ExerciseExporter
+{
+public:
+    struct Result {
+        bool ok = false;
+        QString error;
+        int exercises = 0;
+        int records = 0;
+        qint64 bytes = 0;
+    };
+
+    static Result write(const ExerciseStore& store, const QString& filePath, const QVariantMap& options = QVariantMap());
+};
+
+#endif // EXERCISEEXPORTER_H
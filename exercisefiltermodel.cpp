@@ -0,0 +1,228 @@
+#include "exercisefiltermodel.h"
+#include "textfold.h"
+#include <QDateTime>
+#include <algorithm>
+#include <limits>
+
+namespace {
+// Un bit por grupo muscular en la máscara de filtro
+constexpr int kMaxGroups = 64;
+}
+
+ExerciseFilterModel::ExerciseFilterModel(QObject *parent) : QSortFilterProxyModel(parent) {
+    setDynamicSortFilter(true);
+    sort(0);
+
+    connect(this, &QAbstractItemModel::rowsInserted, this, &ExerciseFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &ExerciseFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::modelReset, this, &ExerciseFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::layoutChanged, this, &ExerciseFilterModel::countChanged);
+}
+
+void ExerciseFilterModel::setExerciseModel(ExerciseModel* model) {
+    if (sourceModel() == model)
+        return;
+    setSourceModel(model);
+}
+
+void ExerciseFilterModel::setSourceModel(QAbstractItemModel* model) {
+    for (const QMetaObject::Connection& connection : std::as_const(m_sourceConnections))
+        disconnect(connection);
+    m_sourceConnections.clear();
+
+    // Se conecta antes que QSortFilterProxyModel para que la caché esté al día
+    // cuando el proxy vuelva a filtrar y ordenar las filas afectadas
+    if (model) {
+        m_sourceConnections = {
+            connect(model, &QAbstractItemModel::modelReset, this, [this, model]() { rebuildEntries(model); }),
+            connect(model, &QAbstractItemModel::rowsInserted, this, &ExerciseFilterModel::onRowsInserted),
+            connect(model, &QAbstractItemModel::rowsRemoved, this, &ExerciseFilterModel::onRowsRemoved),
+            connect(model, &QAbstractItemModel::dataChanged, this, &ExerciseFilterModel::onDataChanged)
+        };
+    }
+
+    // Las entradas tienen que existir antes de que el proxy filtre el modelo nuevo
+    rebuildEntries(model);
+    QSortFilterProxyModel::setSourceModel(model);
+
+    emit exerciseModelChanged();
+    emit countChanged();
+}
+
+void ExerciseFilterModel::setSearchText(const QString& text) {
+    if (m_searchText == text)
+        return;
+
+    m_searchText = text;
+    const QString folded = TextFold::fold(QStringView(text).trimmed());
+    if (folded != m_foldedSearch) {
+        m_foldedSearch = folded;
+        invalidateFilter();
+    }
+    emit searchTextChanged();
+}
+
+void ExerciseFilterModel::setSelectedGroups(const QStringList& groups) {
+    if (m_selectedGroups == groups)
+        return;
+
+    m_selectedGroups = groups;
+    updateGroupMask();
+    emit selectedGroupsChanged();
+}
+
+void ExerciseFilterModel::setSortMode(SortMode mode) {
+    if (m_sortMode == mode)
+        return;
+
+    m_sortMode = mode;
+    invalidate();
+    emit sortModeChanged();
+}
+
+QVariantMap ExerciseFilterModel::groupCounts() const {
+    QVariantMap counts;
+    for (int id = 0; id < m_groups.size(); ++id)
+        counts.insert(m_groups.at(id), m_groupCounts.at(id));
+    return counts;
+}
+
+int ExerciseFilterModel::groupCount(const QString& group) const {
+    const int id = m_groups.indexOf(group);
+    return id >= 0 ? m_groupCounts.at(id) : 0;
+}
+
+bool ExerciseFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const {
+    if (sourceParent.isValid() || sourceRow >= m_entries.size())
+        return false;
+
+    const Entry& entry = m_entries.at(sourceRow);
+    if (!m_foldedSearch.isEmpty())
+        return entry.foldedName.contains(m_foldedSearch);
+
+    if (m_groupMask == 0)
+        return true;
+    return entry.groupId >= 0 && entry.groupId < kMaxGroups && (m_groupMask & (quint64(1) << entry.groupId));
+}
+
+bool ExerciseFilterModel::lessThan(const QModelIndex& left, const QModelIndex& right) const {
+    const Entry& a = m_entries.at(left.row());
+    const Entry& b = m_entries.at(right.row());
+
+    // El proxy ordena de forma ascendente: "menor" significa "va antes"
+    switch (m_sortMode) {
+    case SortByLastUpdated:
+        if (a.lastUpdated != b.lastUpdated)
+            return a.lastUpdated > b.lastUpdated;
+        break;
+    case SortByCurrentValue:
+        if (a.currentValue != b.currentValue)
+            return a.currentValue > b.currentValue;
+        break;
+    case SortByName:
+        break;
+    }
+
+    // Desempate estable: nombre normalizado y después fila del almacén
+    const int byName = a.foldedName.compare(b.foldedName);
+    return byName != 0 ? byName < 0 : left.row() < right.row();
+}
+
+ExerciseFilterModel::Entry ExerciseFilterModel::entryFor(const QAbstractItemModel* model, int sourceRow) {
+    const QModelIndex index = model->index(sourceRow, 0);
+    const QDateTime lastUpdated = index.data(ExerciseModel::LastUpdatedRole).toDateTime();
+
+    Entry entry;
+    entry.foldedName = TextFold::fold(index.data(ExerciseModel::NameRole).toString());
+    entry.groupId = groupIdFor(index.data(ExerciseModel::MuscleGroupRole).toString());
+    entry.lastUpdated = lastUpdated.isValid() ? lastUpdated.toMSecsSinceEpoch()
+                                              : std::numeric_limits<qint64>::min();
+    entry.currentValue = index.data(ExerciseModel::CurrentValueRole).toDouble();
+    return entry;
+}
+
+int ExerciseFilterModel::groupIdFor(const QString& group) {
+    int id = m_groups.indexOf(group);
+    if (id < 0) {
+        id = m_groups.size();
+        m_groups.append(group);
+        m_groupCounts.append(0);
+    }
+    return id;
+}
+
+void ExerciseFilterModel::updateGroupMask() {
+    quint64 mask = 0;
+    for (const QString& group : std::as_const(m_selectedGroups)) {
+        const int id = groupIdFor(group);
+        if (id < kMaxGroups)
+            mask |= quint64(1) << id;
+    }
+
+    if (mask != m_groupMask) {
+        m_groupMask = mask;
+        if (m_foldedSearch.isEmpty())
+            invalidateFilter();
+    }
+}
+
+void ExerciseFilterModel::rebuildEntries(const QAbstractItemModel* model) {
+    m_entries.clear();
+    m_groupCounts.fill(0);
+
+    if (model) {
+        const int rows = model->rowCount();
+        m_entries.reserve(rows);
+        for (int row = 0; row < rows; ++row) {
+            m_entries.append(entryFor(model, row));
+            m_groupCounts[m_entries.last().groupId]++;
+        }
+    }
+
+    emit groupCountsChanged();
+}
+
+void ExerciseFilterModel::onRowsInserted(const QModelIndex& parent, int first, int last) {
+    if (parent.isValid())
+        return;
+
+    for (int row = first; row <= last; ++row) {
+        m_entries.insert(row, entryFor(sourceModel(), row));
+        m_groupCounts[m_entries.at(row).groupId]++;
+    }
+    emit groupCountsChanged();
+}
+
+void ExerciseFilterModel::onRowsRemoved(const QModelIndex& parent, int first, int last) {
+    if (parent.isValid())
+        return;
+
+    for (int row = first; row <= last; ++row)
+        m_groupCounts[m_entries.at(row).groupId]--;
+    m_entries.remove(first, last - first + 1);
+    emit groupCountsChanged();
+}
+
+void ExerciseFilterModel::onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                                        const QList<int>& roles) {
+    // Un cambio sólo de historial no afecta al filtro ni al orden
+    static const QList<int> relevant = {ExerciseModel::NameRole, ExerciseModel::MuscleGroupRole,
+                                        ExerciseModel::LastUpdatedRole, ExerciseModel::CurrentValueRole};
+    if (!roles.isEmpty() && std::none_of(roles.begin(), roles.end(), [](int role) { return relevant.contains(role); }))
+        return;
+
+    bool groupsChanged = false;
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const Entry entry = entryFor(sourceModel(), row);
+        Entry& cached = m_entries[row];
+        if (entry.groupId != cached.groupId) {
+            m_groupCounts[cached.groupId]--;
+            m_groupCounts[entry.groupId]++;
+            groupsChanged = true;
+        }
+        cached = entry;
+    }
+
+    if (groupsChanged)
+        emit groupCountsChanged();
+}
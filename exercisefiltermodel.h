@@ -0,0 +1,94 @@
+#ifndef EXERCISEFILTERMODEL_H
+#define EXERCISEFILTERMODEL_H
+
+#include <QSortFilterProxyModel>
+#include <QStringList>
+#include <QVariantMap>
+#include "exercisemodel.h"
+
+// Filtro y orden de la lista de MenuPage. Por cada fila de ExerciseModel se
+// guarda el nombre ya normalizado (TextFold), el bit de su grupo muscular y
+// las claves de orden, así que decidir si una fila se ve es una comparación
+// de bits o una búsqueda de subcadena, sin JS por delegado. La caché y los
+// contadores por grupo se actualizan con las señales del modelo origen.
+class ExerciseFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+    Q_PROPERTY(ExerciseModel* exerciseModel READ exerciseModel WRITE setExerciseModel NOTIFY exerciseModelChanged)
+    // Con texto de búsqueda se ignoran los grupos, como hacía MenuPage
+    Q_PROPERTY(QString searchText READ searchText WRITE setSearchText NOTIFY searchTextChanged)
+    // Sin grupos seleccionados se muestran todos
+    Q_PROPERTY(QStringList selectedGroups READ selectedGroups WRITE setSelectedGroups NOTIFY selectedGroupsChanged)
+    Q_PROPERTY(SortMode sortMode READ sortMode WRITE setSortMode NOTIFY sortModeChanged)
+    // Ejercicios por grupo muscular (sin filtrar), para MuscleGroupFilter
+    Q_PROPERTY(QVariantMap groupCounts READ groupCounts NOTIFY groupCountsChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum SortMode {
+        SortByName,         // alfabético, sin distinguir mayúsculas ni tildes
+        SortByLastUpdated,  // lo más reciente primero
+        SortByCurrentValue  // el valor más alto primero
+    };
+    Q_ENUM(SortMode)
+
+    explicit ExerciseFilterModel(QObject *parent = nullptr);
+
+    ExerciseModel* exerciseModel() const { return qobject_cast<ExerciseModel*>(sourceModel()); }
+    void setExerciseModel(ExerciseModel* model);
+    void setSourceModel(QAbstractItemModel* model) override;
+
+    QString searchText() const { return m_searchText; }
+    void setSearchText(const QString& text);
+    QStringList selectedGroups() const { return m_selectedGroups; }
+    void setSelectedGroups(const QStringList& groups);
+    SortMode sortMode() const { return m_sortMode; }
+    void setSortMode(SortMode mode);
+
+    QVariantMap groupCounts() const;
+    Q_INVOKABLE int groupCount(const QString& group) const;
+    int count() const { return rowCount(); }
+
+signals:
+    void exerciseModelChanged();
+    void searchTextChanged();
+    void selectedGroupsChanged();
+    void sortModeChanged();
+    void groupCountsChanged();
+    void countChanged();
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
+private:
+    // Lo que necesitan el filtro y el orden de cada fila del modelo origen
+    struct Entry {
+        QString foldedName;
+        int groupId = -1;
+        qint64 lastUpdated = 0;
+        double currentValue = 0;
+    };
+
+    QList<Entry> m_entries;           // indexado por fila del modelo origen
+    QStringList m_groups;             // id de grupo -> nombre; el id es su bit
+    QList<int> m_groupCounts;         // ejercicios por id de grupo
+    QList<QMetaObject::Connection> m_sourceConnections;
+
+    QString m_searchText;
+    QString m_foldedSearch;
+    QStringList m_selectedGroups;
+    quint64 m_groupMask = 0;
+    SortMode m_sortMode = SortByName;
+
+    Entry entryFor(const QAbstractItemModel* model, int sourceRow);
+    int groupIdFor(const QString& group);
+    void updateGroupMask();
+
+    void rebuildEntries(const QAbstractItemModel* model);
+    void onRowsInserted(const QModelIndex& parent, int first, int last);
+    void onRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QList<int>& roles);
+};
+
+#endif // EXERCISEFILTERMODEL_H
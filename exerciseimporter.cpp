@@ -0,0 +1,414 @@
+#include "exerciseimporter.h"
+#include "exercisestore.h"
+#include "gzipstream.h"
+#include "logging.h"
+#include <QBuffer>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Series y repeticiones se guardan en 16 bits
+constexpr int kMaxCount = ExerciseStore::kMaxCount;
+// Máximo de avisos por importación: un fichero mal mapeado los daría todos
+constexpr int kMaxWarnings = 10;
+
+struct PendingRecord {
+    qint64 timestamp = ExerciseStore::kNoTimestamp;
+    double value = 0;
+    QString unit;
+    int sets = 0;
+    int repetitions = 0;
+};
+
+struct PendingExercise {
+    QString muscleGroup;
+    QList<PendingRecord> records;
+    QHash<qint64, int> byTimestamp; // fecha -> posición en records
+};
+
+// Acumula los registros válidos por ejercicio en el orden en que aparecen
+class Collector
+{
+public:
+    explicit Collector(ExerciseImporter::Result* result) : m_result(result) {}
+
+    // setPerRow: cada fila es una serie y las de la misma fecha se juntan
+    void add(const QString& name, const QString& muscleGroup, const PendingRecord& record, bool setPerRow) {
+        auto it = m_exercises.find(name);
+        if (it == m_exercises.end()) {
+            it = m_exercises.insert(name, PendingExercise());
+            it->muscleGroup = muscleGroup;
+            m_order.append(name);
+        }
+
+        PendingExercise& exercise = it.value();
+        const auto existing = exercise.byTimestamp.constFind(record.timestamp);
+        if (existing == exercise.byTimestamp.constEnd()) {
+            exercise.byTimestamp.insert(record.timestamp, int(exercise.records.size()));
+            exercise.records.append(record);
+            ++m_result->records;
+            return;
+        }
+
+        if (!setPerRow) {
+            ++m_result->duplicates;
+            return;
+        }
+
+        PendingRecord& merged = exercise.records[existing.value()];
+        merged.sets = std::min(kMaxCount, merged.sets + 1);
+        if (record.value > merged.value
+            || (record.value == merged.value && record.repetitions > merged.repetitions)) {
+            merged.value = record.value;
+            merged.repetitions = record.repetitions;
+            merged.unit = record.unit;
+        }
+    }
+
+    QJsonArray toJson() {
+        QJsonArray exercises;
+        for (const QString& name : std::as_const(m_order)) {
+            PendingExercise& exercise = m_exercises[name];
+            std::stable_sort(exercise.records.begin(), exercise.records.end(),
+                             [](const PendingRecord& a, const PendingRecord& b) { return a.timestamp < b.timestamp; });
+
+            QJsonArray history;
+            for (const PendingRecord& record : std::as_const(exercise.records)) {
+                history.append(QJsonObject{
+                    {"timestamp", ExerciseStore::formatTimestamp(record.timestamp)},
+                    {"value", record.value},
+                    {"unit", record.unit},
+                    {"sets", record.sets},
+                    {"repetitions", record.repetitions}
+                });
+            }
+
+            exercises.append(QJsonObject{
+                {"name", name},
+                {"muscleGroup", exercise.muscleGroup},
+                {"history", history}
+            });
+        }
+        return exercises;
+    }
+
+private:
+    ExerciseImporter::Result* m_result;
+    QHash<QString, PendingExercise> m_exercises;
+    QStringList m_order;
+};
+
+bool validCount(double count) {
+    return std::isfinite(count) && count >= 0 && count <= kMaxCount && count == std::floor(count);
+}
+
+bool validValue(double value) {
+    return std::isfinite(value) && value >= 0;
+}
+
+void warnInvalid(ExerciseImporter::Result* result, const QString& where, const char* reason) {
+    ++result->invalid;
+    if (result->invalid <= kMaxWarnings)
+        qCWarning(lcData) << "importData() registro descartado:" << where << reason;
+}
+
+// Avisa del progreso sólo cuando avanza al menos un 1%
+class ProgressReporter
+{
+public:
+    explicit ProgressReporter(const ExerciseImporter::Progress& progress) : m_progress(progress) {}
+    void report(double value) {
+        if (m_progress && value - m_last >= 0.01) {
+            m_last = value;
+            m_progress(value);
+        }
+    }
+
+private:
+    const ExerciseImporter::Progress& m_progress;
+    double m_last = 0;
+};
+
+} // namespace
+
+QHash<QString, QStringList> ExerciseImporter::defaultColumns() {
+    return {
+        {"name", {"exercise", "exercise name", "ejercicio", "name", "nombre"}},
+        {"muscleGroup", {"muscle group", "muscle", "grupo muscular", "grupo"}},
+        {"timestamp", {"date", "fecha", "timestamp", "time", "datetime"}},
+        {"value", {"weight", "peso", "value", "valor", "load"}},
+        {"unit", {"unit", "weight unit", "unidad"}},
+        {"sets", {"sets", "series"}},
+        {"repetitions", {"reps", "repetitions", "repeticiones"}}
+    };
+}
+
+QStringList ExerciseImporter::splitCsvLine(const QString& line, QChar delimiter) {
+    QStringList fields;
+    QString field;
+    bool quoted = false;
+
+    for (qsizetype i = 0; i < line.size(); ++i) {
+        const QChar c = line.at(i);
+        if (quoted) {
+            if (c == u'"') {
+                // "" dentro de un campo entre comillas es una comilla literal
+                if (i + 1 < line.size() && line.at(i + 1) == u'"') {
+                    field.append(u'"');
+                    ++i;
+                } else {
+                    quoted = false;
+                }
+            } else {
+                field.append(c);
+            }
+        } else if (c == u'"') {
+            quoted = true;
+        } else if (c == delimiter) {
+            fields.append(field);
+            field.clear();
+        } else if (c != u'\r' && c != u'\n') {
+            field.append(c);
+        }
+    }
+
+    fields.append(field);
+    return fields;
+}
+
+ExerciseImporter::Result ExerciseImporter::read(const QString& filePath, const QVariantMap& options,
+                                                const Progress& progress) {
+    // "copia.json.gz" se trata como "copia.json"
+    QFileInfo info(filePath);
+    if (info.suffix().toLower() == "gz")
+        info.setFile(info.completeBaseName());
+
+    QString format = options.value("format").toString().toLower();
+    if (format.isEmpty())
+        format = info.suffix().toLower() == "csv" ? "csv" : "json";
+
+    Result result;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.error = "No se pudo leer el archivo: " + file.errorString();
+        return result;
+    }
+
+    // Un .gz (como los de ExerciseExporter) se descomprime entero en memoria
+    if (Gzip::isCompressed(file.peek(2))) {
+        bool ok = false;
+        QByteArray data = Gzip::uncompress(file.readAll(), &ok);
+        if (!ok) {
+            result.error = "El archivo comprimido está dañado";
+            return result;
+        }
+        if (format != "csv")
+            return readJson(data, progress);
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::ReadOnly);
+        return readCsv(&buffer, options, progress);
+    }
+
+    if (format == "csv")
+        return readCsv(&file, options, progress);
+
+    // Mapeado se evita copiar el fichero entero; QJsonDocument necesita el
+    // documento completo, pero esto ya no se hace en el hilo de la interfaz
+    const uchar* mapped = file.map(0, file.size());
+    if (mapped)
+        return readJson(QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), qsizetype(file.size())), progress);
+    return readJson(file.readAll(), progress);
+}
+
+ExerciseImporter::Result ExerciseImporter::readJson(const QByteArray& bytes, const Progress& progress) {
+    Result result;
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(bytes, &parseError);
+    if (doc.isNull() || !doc.isObject() || !doc.object()["exercises"].isObject()) {
+        result.error = "El archivo no contiene datos válidos: " + parseError.errorString();
+        return result;
+    }
+
+    ProgressReporter reporter(progress);
+    reporter.report(0.3);
+
+    Collector collector(&result);
+    const QJsonObject exercises = doc.object()["exercises"].toObject();
+    int done = 0;
+    for (auto it = exercises.constBegin(); it != exercises.constEnd(); ++it, ++done) {
+        reporter.report(0.3 + 0.7 * done / exercises.size());
+
+        const QString name = it.key().trimmed();
+        if (name.isEmpty() || !it.value().isObject()) {
+            warnInvalid(&result, it.key(), "ejercicio sin nombre o mal formado");
+            continue;
+        }
+
+        const QJsonObject json = it.value().toObject();
+        const QString muscleGroup = json["muscleGroup"].toString();
+        const QJsonArray history = json["history"].toArray();
+        for (const QJsonValue& value : history) {
+            const QJsonObject entry = value.toObject();
+            PendingRecord record;
+            record.timestamp = ExerciseStore::parseTimestamp(entry["timestamp"].toString());
+            record.value = entry["value"].toDouble(-1);
+            record.unit = entry["unit"].toString();
+            // Igual que ExerciseStore::fromJson: sin series se asumen 3
+            const double sets = entry.contains("sets") ? entry["sets"].toDouble(-1) : 3;
+            const double repetitions = entry["repetitions"].toDouble(-1);
+
+            if (record.timestamp == ExerciseStore::kNoTimestamp) {
+                warnInvalid(&result, name, "fecha no válida");
+            } else if (!validValue(record.value)) {
+                warnInvalid(&result, name, "valor no válido");
+            } else if (!validCount(sets) || !validCount(repetitions)) {
+                warnInvalid(&result, name, "series o repeticiones no válidas");
+            } else {
+                record.sets = int(sets);
+                record.repetitions = int(repetitions);
+                collector.add(name, muscleGroup, record, false);
+            }
+        }
+    }
+
+    result.exercises = collector.toJson();
+    result.ok = true;
+    reporter.report(1.0);
+    return result;
+}
+
+ExerciseImporter::Result ExerciseImporter::readCsv(QIODevice* file, const QVariantMap& options,
+                                                   const Progress& progress) {
+    Result result;
+    QString header = QString::fromUtf8(file->readLine());
+    if (header.startsWith(QChar(0xFEFF)))
+        header.remove(0, 1);
+
+    const QString configuredDelimiter = options.value("delimiter").toString();
+    QChar delimiter = configuredDelimiter.isEmpty() ? QChar() : configuredDelimiter.at(0);
+    if (delimiter.isNull()) {
+        delimiter = u',';
+        if (header.count(u';') > header.count(delimiter)) delimiter = u';';
+        if (header.count(u'\t') > header.count(delimiter)) delimiter = u'\t';
+    }
+
+    QStringList headers = splitCsvLine(header, delimiter);
+    for (QString& name : headers)
+        name = name.trimmed().toLower();
+
+    // Columna de cada campo: la configurada o, si no, una cabecera conocida
+    const QVariantMap configured = options.value("columns").toMap();
+    const QHash<QString, QStringList> defaults = defaultColumns();
+    QHash<QString, int> columns;
+    for (auto it = defaults.cbegin(); it != defaults.cend(); ++it) {
+        const QStringList candidates = configured.contains(it.key())
+                                           ? QStringList{configured.value(it.key()).toString().trimmed().toLower()}
+                                           : it.value();
+        for (const QString& candidate : candidates) {
+            const int index = int(headers.indexOf(candidate));
+            if (index >= 0) {
+                columns.insert(it.key(), index);
+                break;
+            }
+        }
+    }
+
+    if (!columns.contains("name") || !columns.contains("timestamp")
+        || (!columns.contains("value") && !columns.contains("repetitions"))) {
+        result.error = "Faltan columnas obligatorias (ejercicio, fecha y peso o repeticiones)";
+        return result;
+    }
+
+    const QString dateFormat = options.value("dateFormat").toString();
+    const QString defaultUnit = options.value("unit", QStringLiteral("kg")).toString();
+    const QString defaultGroup = options.value("muscleGroup").toString();
+    const bool setPerRow = !columns.contains("sets");
+    // Con ";" o tabulador la coma suele ser el separador decimal
+    const bool decimalComma = delimiter != u',';
+
+    const auto field = [&columns](const QStringList& fields, const char* name) {
+        const int index = columns.value(QLatin1String(name), -1);
+        return index >= 0 && index < fields.size() ? fields.at(index).trimmed() : QString();
+    };
+    const auto number = [decimalComma](QString text, double fallback) {
+        if (text.isEmpty())
+            return fallback;
+        if (decimalComma)
+            text.replace(u',', u'.');
+        bool ok = false;
+        const double value = text.toDouble(&ok);
+        return ok ? value : -1.0;
+    };
+    const auto timestamp = [&dateFormat](const QString& text) {
+        if (!dateFormat.isEmpty()) {
+            const QDateTime dateTime = QDateTime::fromString(text, dateFormat);
+            return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : ExerciseStore::kNoTimestamp;
+        }
+        qint64 parsed = ExerciseStore::parseTimestamp(text);
+        if (parsed != ExerciseStore::kNoTimestamp)
+            return parsed;
+        for (const char* format : {"yyyy-MM-dd HH:mm:ss", "yyyy-MM-dd HH:mm", "yyyy-MM-dd",
+                                   "dd/MM/yyyy HH:mm:ss", "dd/MM/yyyy HH:mm", "dd/MM/yyyy"}) {
+            const QDateTime dateTime = QDateTime::fromString(text, QLatin1String(format));
+            if (dateTime.isValid())
+                return dateTime.toMSecsSinceEpoch();
+        }
+        return ExerciseStore::kNoTimestamp;
+    };
+
+    ProgressReporter reporter(progress);
+    Collector collector(&result);
+    const double size = std::max<qint64>(1, file->size());
+    int lineNumber = 1;
+
+    while (!file->atEnd()) {
+        // Un campo entre comillas puede llevar saltos de línea
+        QString line = QString::fromUtf8(file->readLine());
+        ++lineNumber;
+        while (line.count(u'"') % 2 != 0 && !file->atEnd())
+            line += QString::fromUtf8(file->readLine());
+        reporter.report(file->pos() / size);
+
+        if (line.trimmed().isEmpty())
+            continue;
+
+        const QStringList fields = splitCsvLine(line, delimiter);
+        const QString where = QString("línea %1").arg(lineNumber);
+        const QString name = field(fields, "name");
+
+        PendingRecord record;
+        record.timestamp = timestamp(field(fields, "timestamp"));
+        record.value = number(field(fields, "value"), 0);
+        record.unit = columns.contains("unit") ? field(fields, "unit") : defaultUnit;
+        if (record.unit.isEmpty())
+            record.unit = defaultUnit;
+        const double sets = setPerRow ? 1 : number(field(fields, "sets"), 1);
+        const double repetitions = number(field(fields, "repetitions"), 0);
+
+        if (name.isEmpty()) {
+            warnInvalid(&result, where, "sin ejercicio");
+        } else if (record.timestamp == ExerciseStore::kNoTimestamp) {
+            warnInvalid(&result, where, "fecha no válida");
+        } else if (!validValue(record.value)) {
+            warnInvalid(&result, where, "peso no válido");
+        } else if (!validCount(sets) || !validCount(repetitions)) {
+            warnInvalid(&result, where, "series o repeticiones no válidas");
+        } else {
+            record.sets = int(sets);
+            record.repetitions = int(repetitions);
+            const QString group = columns.contains("muscleGroup") ? field(fields, "muscleGroup") : defaultGroup;
+            collector.add(name, group, record, setPerRow);
+        }
+    }
+
+    result.exercises = collector.toJson();
+    result.ok = true;
+    reporter.report(1.0);
+    return result;
+}
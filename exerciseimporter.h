@@ -0,0 +1,57 @@
+#ifndef EXERCISEIMPORTER_H
+#define EXERCISEIMPORTER_H
+
+#include <QHash>
+#include <QIODevice>
+#include <QJsonArray>
+#include <QStringList>
+#include <QVariantMap>
+#include <functional>
+
+// Lectura de ficheros a importar, pensada para un hilo secundario. Acepta la
+// copia de seguridad JSON de la app y CSV de otras apps de gimnasio. Cada
+// registro se valida por separado: los que no son válidos se cuentan y se
+// descartan sin abortar la importación. Los repetidos dentro del fichero
+// (mismo ejercicio y fecha) se detectan con un hash.
+//
+// El resultado está en el formato de la operación "import" del diario; la
+// fusión con lo que ya hay en el almacén la hace DataCenter.
+//
+// Opciones (todas opcionales):
+//   format       "json" o "csv"; por defecto según la extensión (sin el .gz:
+//                los ficheros gzip se detectan por su cabecera)
+//   delimiter    separador del CSV; por defecto "," o ";" según la cabecera
+//   columns      campo -> nombre de columna: name, muscleGroup, timestamp,
+//                value, unit, sets, repetitions
+//   dateFormat   formato de fecha de QDateTime si no es ISO
+//   unit         unidad si no hay columna de unidad ("kg")
+//   muscleGroup  grupo muscular si no hay columna
+//
+// En un CSV sin columna de series cada fila es una serie: las filas del mismo
+// ejercicio y fecha se juntan en un registro con la serie más pesada.
+class ExerciseImporter
+{
+public:
+    struct Result {
+        bool ok = false;
+        QString error;
+        QJsonArray exercises; // [{name, muscleGroup, history: [...]}]
+        int records = 0;
+        int duplicates = 0;
+        int invalid = 0;
+    };
+
+    using Progress = std::function<void(double)>;
+
+    static Result read(const QString& filePath, const QVariantMap& options, const Progress& progress = {});
+
+    // Campos que admite "columns", con las cabeceras que se reconocen sin configurar
+    static QHash<QString, QStringList> defaultColumns();
+    static QStringList splitCsvLine(const QString& line, QChar delimiter);
+
+private:
+    static Result readJson(const QByteArray& bytes, const Progress& progress);
+    static Result readCsv(QIODevice* file, const QVariantMap& options, const Progress& progress);
+};
+
+#endif // EXERCISEIMPORTER_H
@@ -1,99 +1,108 @@
 #include "exercisemodel.h"
-#include <algorithm>
-#include <qjsonarray.h>
-#include <QJsonDocument>
+#include "diagnostics.h"
+#include "historylistmodel.h"
+#include <QDateTime>
 
-QJsonObject ExerciseModel::Exercise::toJson() const {
-    QJsonObject obj;
-    obj["name"] = name;
-    obj["muscleGroup"] = muscleGroup;
-    obj["currentValue"] = currentValue;
-    obj["unit"] = unit;
-    obj["sets"] = sets;
-    obj["repetitions"] = repetitions;
-    obj["lastUpdated"] = lastUpdated.toString(Qt::ISODate);
-
-    QJsonArray historyArray;
-    for (const auto& record : history) {
-        historyArray.append(record.toJson());
-    }
-    obj["history"] = historyArray;
+ExerciseModel::ExerciseModel(QObject *parent) : QAbstractListModel(parent) {}
 
-    return obj;
-}
+void ExerciseModel::setDataCenter(DataCenter* dataCenter) {
+    if (m_dataCenter == dataCenter)
+        return;
 
-ExerciseModel::Exercise ExerciseModel::Exercise::fromJson(const QString& key, const QJsonObject& json) {
-    Exercise exercise;
-    exercise.name = key;
-    exercise.muscleGroup = json["muscleGroup"].toString();
-    exercise.currentValue = json["currentValue"].toDouble();
-    exercise.unit = json["unit"].toString();
-    exercise.sets = json.contains("sets") ? json["sets"].toInt() : 3;
-    exercise.repetitions = json["repetitions"].toInt();
-    exercise.lastUpdated = QDateTime::fromString(json["lastUpdated"].toString(), Qt::ISODate);
+    beginResetModel();
 
-    QJsonArray historyArray = json["history"].toArray();
-    for (const QJsonValue& value : historyArray) {
-        exercise.history.append(HistoryRecord::fromJson(value.toObject()));
+    if (m_dataCenter)
+        disconnect(m_dataCenter, nullptr, this, nullptr);
+
+    m_dataCenter = dataCenter;
+
+    if (m_dataCenter) {
+        connect(m_dataCenter, &DataCenter::exerciseAboutToBeAdded, this, [this](int row) {
+            beginInsertRows(QModelIndex(), row, row);
+        });
+        connect(m_dataCenter, &DataCenter::exerciseAdded, this, [this]() {
+            endInsertRows();
+            emit modelChanged();
+        });
+        connect(m_dataCenter, &DataCenter::exerciseAboutToBeRemoved, this, [this](int row) {
+            beginRemoveRows(QModelIndex(), row, row);
+        });
+        connect(m_dataCenter, &DataCenter::exerciseRemoved, this, [this]() {
+            endRemoveRows();
+            emit modelChanged();
+        });
+        connect(m_dataCenter, &DataCenter::exerciseUpdated, this, &ExerciseModel::onExerciseUpdated);
+        connect(m_dataCenter, &DataCenter::historyChanged, this, &ExerciseModel::onHistoryChanged);
+        connect(m_dataCenter, &DataCenter::storeAboutToBeReset, this, [this]() {
+            m_resetStarted = Diagnostics::instance()->now();
+            beginResetModel();
+        });
+        connect(m_dataCenter, &DataCenter::storeReset, this, [this]() {
+            endResetModel();
+            emit modelChanged();
+            Diagnostics* diagnostics = Diagnostics::instance();
+            diagnostics->addTiming("model.reset", m_resetStarted, diagnostics->now() - m_resetStarted);
+        });
     }
 
-    return exercise;
+    endResetModel();
+    emit modelChanged();
+    emit dataCenterChanged();
 }
 
-QJsonObject ExerciseModel::HistoryRecord::toJson() const {
-    QJsonObject obj;
-    obj["timestamp"] = timestamp.toString(Qt::ISODate);
-    obj["value"] = value;
-    obj["unit"] = unit;
-    obj["sets"] = sets;
-    obj["repetitions"] = repetitions;
-    return obj;
+void ExerciseModel::onExerciseUpdated(int row) {
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, {MuscleGroupRole, CurrentValueRole, UnitRole,
+                                        SetsRole, RepetitionsRole, LastUpdatedRole});
 }
 
-ExerciseModel::HistoryRecord ExerciseModel::HistoryRecord::fromJson(const QJsonObject& json) {
-    HistoryRecord record;
-    record.timestamp = QDateTime::fromString(json["timestamp"].toString(), Qt::ISODate);
-    record.value = json["value"].toDouble();
-    record.unit = json["unit"].toString();
-    record.sets = json.contains("sets") ? json["sets"].toInt() : 3;
-    record.repetitions = json["repetitions"].toInt();
-    return record;
+void ExerciseModel::onHistoryChanged(int row) {
+    const QModelIndex changed = index(row);
+    // HistoryRole no cambia: el modelo del historial se actualiza por su cuenta
+    emit dataChanged(changed, changed, {PersonalRecordRole, PersonalRecordDateRole,
+                                        OneRepMaxRole, TotalVolumeRole, SessionCountRole,
+                                        FirstUpdatedRole, TrendRole});
 }
 
-ExerciseModel::ExerciseModel(QObject *parent) : QAbstractListModel(parent) {}
-
 int ExerciseModel::rowCount(const QModelIndex& parent) const {
-    Q_UNUSED(parent)
-    return m_exercises.count();
+    if (parent.isValid() || !m_dataCenter)
+        return 0;
+    return m_dataCenter->store().count();
 }
 
 QVariant ExerciseModel::data(const QModelIndex& index, int role) const {
-    if (!index.isValid() || index.row() >= m_exercises.count())
+    if (!index.isValid() || !m_dataCenter || index.row() >= m_dataCenter->store().count())
         return QVariant();
 
-    const Exercise& exercise = m_exercises.at(index.row());
+    const ExerciseStore& store = m_dataCenter->store();
+    const ExerciseStore::Exercise& exercise = store.at(index.row());
 
     switch (role) {
     case NameRole: return exercise.name;
-    case MuscleGroupRole: return exercise.muscleGroup;
+    case MuscleGroupRole: return store.muscleGroup(exercise);
     case CurrentValueRole: return exercise.currentValue;
-    case UnitRole: return exercise.unit;
+    case UnitRole: return store.unit(exercise.unitId);
     case SetsRole: return exercise.sets;
     case RepetitionsRole: return exercise.repetitions;
-    case LastUpdatedRole: return exercise.lastUpdated;
-    case HistoryRole: {
-        QVariantList history;
-        for (const auto& record : exercise.history) {
-            history.append(QVariantMap{
-                {"timestamp", record.timestamp},
-                {"value", record.value},
-                {"unit", record.unit},
-                {"repetitions", record.repetitions},
-                {"sets", record.sets}
-            });
-        }
-        return history;
+    case LastUpdatedRole:
+        return exercise.lastUpdated == ExerciseStore::kNoTimestamp
+                   ? QDateTime() : QDateTime::fromMSecsSinceEpoch(exercise.lastUpdated);
+    case HistoryRole:
+        // Modelo paginado compartido (ver HistoryListModel): no copia el historial
+        Diagnostics::instance()->increment("model.historyRole");
+        return QVariant::fromValue(m_dataCenter->historyModel(exercise.name));
+    case PersonalRecordRole: return store.stats(index.row()).personalRecord();
+    case PersonalRecordDateRole: {
+        const ExerciseStats& stats = store.stats(index.row());
+        return stats.recordCount() > 0 ? QDateTime::fromMSecsSinceEpoch(stats.personalRecordTimestamp()) : QDateTime();
     }
+    case OneRepMaxRole: return store.stats(index.row()).oneRepMax();
+    case TotalVolumeRole: return store.stats(index.row()).totalVolume();
+    case SessionCountRole: return store.stats(index.row()).sessionCount();
+    case FirstUpdatedRole:
+        return exercise.history.isEmpty()
+                   ? QDateTime() : QDateTime::fromMSecsSinceEpoch(exercise.history.timestampAt(0));
+    case TrendRole: return store.stats(index.row()).trend();
     default: return QVariant();
     }
 }
@@ -107,91 +116,13 @@ QHash<int, QByteArray> ExerciseModel::roleNames() const {
         {SetsRole, "sets"},
         {RepetitionsRole, "repetitions"},
         {LastUpdatedRole, "lastUpdated"},
-        {HistoryRole, "history"}
+        {HistoryRole, "history"},
+        {PersonalRecordRole, "personalRecord"},
+        {PersonalRecordDateRole, "personalRecordDate"},
+        {OneRepMaxRole, "oneRepMax"},
+        {TotalVolumeRole, "totalVolume"},
+        {SessionCountRole, "sessionCount"},
+        {FirstUpdatedRole, "firstUpdated"},
+        {TrendRole, "trend"}
     };
 }
-
-void ExerciseModel::loadFromJson(const QJsonObject& json) {
-    beginResetModel();
-    m_exercises.clear();
-
-    qDebug() << "Cargando datos en ExerciseModel...";
-    qDebug() << "Datos recibidos:" << QJsonDocument(json).toJson(QJsonDocument::Indented);
-
-    QJsonObject exercisesObj = json["exercises"].toObject();
-    for (const QString& key : exercisesObj.keys()) {
-        const QJsonObject& exerciseData = exercisesObj[key].toObject();
-        m_exercises.append(Exercise::fromJson(key, exerciseData));
-    }
-
-    endResetModel();
-
-    qDebug() << "Modelo actualizado. Total ejercicios:" << m_exercises.count();
-}
-
-QJsonObject ExerciseModel::toJson() const {
-    QJsonObject root;
-    QJsonObject exercisesObject;
-    for (const auto& exercise : m_exercises) {
-        exercisesObject[exercise.name] = exercise.toJson();
-    }
-    root["exercises"] = exercisesObject;
-
-    return root;
-}
-
-void ExerciseModel::addExercise(const QString& name, const QString& muscleGroup,
-                                double value, const QString& unit, int sets, int reps) {
-    beginInsertRows(QModelIndex(), rowCount(), rowCount());
-
-    Exercise newExercise;
-    newExercise.name = name;
-    newExercise.muscleGroup = muscleGroup;
-    newExercise.currentValue = value;
-    newExercise.unit = unit;
-    newExercise.sets = sets;
-    newExercise.repetitions = reps;
-    newExercise.lastUpdated = QDateTime::currentDateTime();
-
-    m_exercises.append(newExercise);
-    endInsertRows();
-}
-
-void ExerciseModel::updateExercise(int index, double value, const QString& unit, int sets, int reps) {
-    if (index < 0 || index >= m_exercises.count())
-        return;
-
-    // Guardar registro actual en historial
-    HistoryRecord currentRecord;
-    currentRecord.timestamp = m_exercises[index].lastUpdated;
-    currentRecord.value = m_exercises[index].currentValue;
-    currentRecord.unit = m_exercises[index].unit;
-    currentRecord.sets = m_exercises[index].sets;
-    currentRecord.repetitions = m_exercises[index].repetitions;
-
-    m_exercises[index].history.prepend(currentRecord);
-
-    // Actualizar valores
-    m_exercises[index].currentValue = value;
-    m_exercises[index].sets = sets;
-    m_exercises[index].unit = unit;
-    m_exercises[index].repetitions = reps;
-    m_exercises[index].lastUpdated = QDateTime::currentDateTime();
-
-    // Ordenar historial
-    std::sort(m_exercises[index].history.begin(), m_exercises[index].history.end(),
-              [](const HistoryRecord& a, const HistoryRecord& b) {
-                  return a.timestamp > b.timestamp;
-              });
-
-    emit dataChanged(createIndex(index, 0), createIndex(index, 0));
-}
-
-void ExerciseModel::removeExercise(int index) {
-    if (index < 0 || index >= m_exercises.count())
-        return;
-
-    beginRemoveRows(QModelIndex(), index, index);
-    m_exercises.removeAt(index);
-    endRemoveRows();
-}
@@ -2,40 +2,19 @@
 #define EXERCISEMODEL_H
 
 #include <QAbstractListModel>
-#include <QDateTime>
-#include <QJsonObject>
+#include <QPointer>
+#include "datacenter.h"
 
+// Vista de lista sobre el almacén de DataCenter: no copia los datos, lee
+// directamente de las columnas y traduce las notificaciones por ejercicio
+// en inserciones, borrados y cambios de filas concretas.
 class ExerciseModel : public QAbstractListModel
 {
     Q_OBJECT
     Q_PROPERTY(int count READ rowCount NOTIFY modelChanged)
+    Q_PROPERTY(DataCenter* dataCenter READ dataCenter WRITE setDataCenter NOTIFY dataCenterChanged)
 
 public:
-    struct HistoryRecord {
-        QDateTime timestamp;
-        double value;
-        QString unit;
-        int sets;
-        int repetitions;
-
-        QJsonObject toJson() const;
-        static HistoryRecord fromJson(const QJsonObject& json);
-    };
-
-    struct Exercise {
-        QString name;
-        QString muscleGroup;
-        double currentValue;
-        QString unit;
-        int repetitions;
-        int sets;
-        QDateTime lastUpdated;
-        QList<HistoryRecord> history;
-
-        QJsonObject toJson() const;
-        static Exercise fromJson(const QString& key, const QJsonObject& json);
-    };
-
     enum Roles {
         NameRole = Qt::UserRole + 1,
         MuscleGroupRole,
@@ -44,28 +23,37 @@ public:
         SetsRole,
         RepetitionsRole,
         LastUpdatedRole,
-        HistoryRole
+        HistoryRole,
+        // Agregados de ExerciseStats: se leen sin recorrer el historial
+        PersonalRecordRole,
+        PersonalRecordDateRole,
+        OneRepMaxRole,
+        TotalVolumeRole,
+        SessionCountRole,
+        FirstUpdatedRole,
+        TrendRole
     };
 
     explicit ExerciseModel(QObject *parent = nullptr);
 
+    DataCenter* dataCenter() const { return m_dataCenter; }
+    void setDataCenter(DataCenter* dataCenter);
+
     // QAbstractItemModel interface
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role) const override;
     QHash<int, QByteArray> roleNames() const override;
 
-    Q_INVOKABLE void loadFromJson(const QJsonObject& json);
-    Q_INVOKABLE QJsonObject toJson() const;
-    Q_INVOKABLE void addExercise(const QString& name, const QString& muscleGroup,
-                                 double value, const QString& unit, int sets, int reps);
-    Q_INVOKABLE void updateExercise(int index, double value, const QString& unit, int sets, int reps);
-    Q_INVOKABLE void removeExercise(int index);
-
 signals:
     void modelChanged();
+    void dataCenterChanged();
 
 private:
-    QList<Exercise> m_exercises;
+    QPointer<DataCenter> m_dataCenter;
+    qint64 m_resetStarted = 0;
+
+    void onExerciseUpdated(int row);
+    void onHistoryChanged(int row);
 };
 
 #endif // EXERCISEMODEL_H
@@ -2,26 +2,21 @@
 #define EXERCISEPROVIDER_H
 
 #include <QObject>
-#include <QStringList>
+#include <QVariantList>
 
+// Catálogo de ejercicios para QML. Los datos vienen de la tabla compilada
+// (ExerciseCatalog), así que están disponibles desde la construcción.
 class ExerciseProvider : public QObject {
     Q_OBJECT
-    Q_PROPERTY(QVariantList exercises READ exercises NOTIFY exercisesChanged)
+    Q_PROPERTY(QVariantList exercises READ exercises CONSTANT)
+    Q_PROPERTY(bool ready READ isReady CONSTANT)
 
 public:
     explicit ExerciseProvider(QObject *parent = nullptr);
 
     QVariantList exercises() const;
-
-signals:
-    void exercisesChanged();
-
-private:
-    QVariantList m_exercises;
-    void loadExercisesFromFile();
-    bool existsExercise(const QString &name, const QString &group) const;
+    bool isReady() const { return true; }
 };
 
 
 #endif // EXERCISEPROVIDER_H
-
@@ -0,0 +1,249 @@
+#include "exercisesearchindex.h"
+#include "diagnostics.h"
+#include "exercisecatalog.h"
+#include "logging.h"
+#include "textfold.h"
+#include <QFile>
+#include <QTextStream>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Puntuaciones: cuanto antes empieza la coincidencia, más arriba
+constexpr int kNameStartScore = 1000;
+constexpr int kWordStartScore = 800;
+constexpr int kAllWordsScore = 600;
+constexpr int kContainsScore = 400;
+// Un alias nunca supera a una coincidencia directa
+constexpr int kAliasScoreLimit = kContainsScore - 1;
+
+// Una consulta con más palabras que bits en la máscara se corta
+constexpr int kMaxQueryWords = 32;
+
+bool isWordStart(QStringView text, int position) {
+    return position == 0 || !text.at(position - 1).isLetterOrNumber();
+}
+
+template <typename Callback>
+void forEachWord(QStringView text, Callback callback) {
+    int start = -1;
+    for (int i = 0; i <= text.size(); ++i) {
+        const bool letter = i < text.size() && text.at(i).isLetterOrNumber();
+        if (letter && start < 0) {
+            start = i;
+        } else if (!letter && start >= 0) {
+            callback(text.mid(start, i - start), start);
+            start = -1;
+        }
+    }
+}
+
+} // namespace
+
+quint64 ExerciseSearchIndex::trigramKey(QStringView text) {
+    return (quint64(text.at(0).unicode()) << 32) | (quint64(text.at(1).unicode()) << 16) | text.at(2).unicode();
+}
+
+ExerciseSearchIndex ExerciseSearchIndex::build(const QString& aliasesPath) {
+    ScopedTimer timer("search.build");
+    ExerciseSearchIndex index;
+    index.m_entries.reserve(ExerciseCatalog::kCount);
+
+    for (const ExerciseCatalog::Entry& exercise : ExerciseCatalog::kEntries) {
+        Entry entry;
+        entry.name = ExerciseCatalog::name(exercise);
+        entry.group = QString(ExerciseCatalog::groupName(exercise.group));
+        entry.folded = TextFold::fold(exercise.name);
+        index.m_entries.append(entry);
+    }
+
+    for (int i = 0; i < index.m_entries.size(); ++i) {
+        const QString& folded = index.m_entries.at(i).folded;
+
+        forEachWord(folded, [&](QStringView word, int position) {
+            index.m_tokens.append({word.toString(), i, position});
+        });
+
+        for (int p = 0; p + 3 <= folded.size(); ++p) {
+            QList<int>& postings = index.m_trigrams[trigramKey(QStringView(folded).mid(p, 3))];
+            if (postings.isEmpty() || postings.last() != i)
+                postings.append(i);
+        }
+    }
+
+    std::sort(index.m_tokens.begin(), index.m_tokens.end(), [](const Token& a, const Token& b) {
+        return a.text < b.text;
+    });
+
+    index.m_alphabetical.resize(index.m_entries.size());
+    std::iota(index.m_alphabetical.begin(), index.m_alphabetical.end(), 0);
+    std::sort(index.m_alphabetical.begin(), index.m_alphabetical.end(), [&index](int a, int b) {
+        return index.m_entries.at(a).folded < index.m_entries.at(b).folded;
+    });
+
+    index.loadAliases(aliasesPath);
+
+    qCDebug(lcCatalog) << "Índice de búsqueda:" << index.m_entries.size() << "ejercicios,"
+                       << index.m_tokens.size() << "palabras," << index.m_trigrams.size() << "trigramas,"
+                       << index.m_aliasGroups.size() << "grupos de alias";
+    return index;
+}
+
+void ExerciseSearchIndex::loadAliases(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qCWarning(lcCatalog) << "No se pudo abrir el fichero de alias:" << path;
+        return;
+    }
+
+    QHash<QString, QList<int>> byName;
+    for (int i = 0; i < m_entries.size(); ++i)
+        byName[m_entries.at(i).folded].append(i);
+
+    // Cada línea: "Press militar = Overhead Press = Military Press"
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QStringList names = in.readLine().split('=', Qt::SkipEmptyParts);
+        QList<int> members;
+        for (const QString& name : names)
+            members.append(byName.value(TextFold::fold(QStringView(name).trimmed())));
+
+        if (members.size() < 2)
+            continue;
+
+        const int group = m_aliasGroups.size();
+        for (int member : std::as_const(members))
+            m_entries[member].aliasGroup = group;
+        m_aliasGroups.append(members);
+    }
+}
+
+void ExerciseSearchIndex::search(QStringView query, int limit, Scratch* scratch) const {
+    scratch->results.clear();
+
+    const QString folded = TextFold::fold(query.trimmed());
+    if (folded.isEmpty()) {
+        for (int entry : m_alphabetical)
+            scratch->results.append({entry, 0, -1, 0, false});
+        return;
+    }
+
+    // Sólo se limpia lo que tocó la búsqueda anterior
+    if (scratch->best.size() != m_entries.size()) {
+        scratch->best = QList<Result>(m_entries.size());
+        scratch->masks = QList<quint32>(m_entries.size(), 0);
+        scratch->touched.clear();
+    }
+    for (int entry : std::as_const(scratch->touched)) {
+        scratch->best[entry] = Result();
+        scratch->masks[entry] = 0;
+    }
+    scratch->touched.clear();
+
+    auto touch = [scratch](int entry) {
+        if (scratch->best.at(entry).score == 0 && scratch->masks.at(entry) == 0)
+            scratch->touched.append(entry);
+    };
+    auto offer = [scratch, &touch](const Result& result) {
+        touch(result.entry);
+        Result& best = scratch->best[result.entry];
+        if (result.score > best.score)
+            best = result;
+    };
+
+    // 1. Subcadena completa, a partir de los trigramas de la consulta
+    if (folded.size() >= 3) {
+        const QList<int>* candidates = nullptr;
+        for (int p = 0; p + 3 <= folded.size(); ++p) {
+            const auto it = m_trigrams.constFind(trigramKey(QStringView(folded).mid(p, 3)));
+            if (it == m_trigrams.constEnd()) {
+                candidates = nullptr;
+                break;
+            }
+            if (!candidates || it->size() < candidates->size())
+                candidates = &it.value();
+        }
+
+        if (candidates) {
+            for (int entry : *candidates) {
+                const QString& name = m_entries.at(entry).folded;
+                const int position = int(name.indexOf(folded));
+                if (position < 0)
+                    continue;
+                const int score = position == 0 ? kNameStartScore
+                                  : isWordStart(name, position) ? kWordStartScore : kContainsScore;
+                offer({entry, score, position, int(folded.size()), false});
+            }
+        }
+    }
+
+    // 2. Cada palabra de la consulta es prefijo de alguna palabra del nombre
+    QVarLengthArray<QStringView, 8> words;
+    forEachWord(folded, [&words](QStringView word, int) {
+        if (words.size() < kMaxQueryWords)
+            words.append(word);
+    });
+
+    const quint32 allWords = words.size() >= 32 ? ~quint32(0) : (quint32(1) << words.size()) - 1;
+    for (int w = 0; w < words.size(); ++w) {
+        const QStringView word = words.at(w);
+        auto it = std::lower_bound(m_tokens.cbegin(), m_tokens.cend(), word, [](const Token& token, QStringView text) {
+            return QStringView(token.text) < text;
+        });
+        for (; it != m_tokens.cend() && QStringView(it->text).startsWith(word); ++it) {
+            touch(it->entry);
+            quint32& mask = scratch->masks[it->entry];
+            mask |= quint32(1) << w;
+
+            if (mask == allWords) {
+                const int score = words.size() == 1 ? (it->position == 0 ? kNameStartScore : kWordStartScore)
+                                                    : kAllWordsScore;
+                const int start = words.size() == 1 ? it->position : -1;
+                Result& best = scratch->best[it->entry];
+                if (score > best.score)
+                    best = {it->entry, score, start, start >= 0 ? int(word.size()) : 0, false};
+            }
+        }
+    }
+
+    // 3. Alias de lo encontrado, por debajo de cualquier coincidencia directa
+    const int direct = int(scratch->touched.size());
+    for (int i = 0; i < direct; ++i) {
+        const Result match = scratch->best.at(scratch->touched.at(i));
+        if (match.score == 0 || match.viaAlias)
+            continue;
+        const int aliasGroup = m_entries.at(match.entry).aliasGroup;
+        if (aliasGroup < 0)
+            continue;
+        for (int member : m_aliasGroups.at(aliasGroup)) {
+            if (member != match.entry)
+                offer({member, std::min(match.score / 2, kAliasScoreLimit), -1, 0, true});
+        }
+    }
+
+    for (int entry : std::as_const(scratch->touched)) {
+        const Result& result = scratch->best.at(entry);
+        if (result.score > 0)
+            scratch->results.append(result);
+    }
+
+    // Relevancia, después nombres más cortos (más parecidos a lo escrito) y orden alfabético
+    auto ranking = [this](const Result& a, const Result& b) {
+        if (a.score != b.score)
+            return a.score > b.score;
+        const QString& nameA = m_entries.at(a.entry).folded;
+        const QString& nameB = m_entries.at(b.entry).folded;
+        if (nameA.size() != nameB.size())
+            return nameA.size() < nameB.size();
+        return nameA < nameB;
+    };
+
+    if (limit > 0 && scratch->results.size() > limit) {
+        std::partial_sort(scratch->results.begin(), scratch->results.begin() + limit, scratch->results.end(), ranking);
+        scratch->results.resize(limit);
+    } else {
+        std::sort(scratch->results.begin(), scratch->results.end(), ranking);
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef EXERCISESEARCHINDEX_H
+#define EXERCISESEARCHINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+// Índice de búsqueda del catálogo de ejercicios para el autocompletado. Se
+// construye una vez a partir del catálogo compilado y después sólo se lee,
+// así que puede compartirse entre hilos. Los nombres se guardan normalizados
+// (TextFold) y se indexan de dos formas:
+//
+//  - palabras ordenadas, para encontrar por prefijo con una búsqueda binaria
+//    ("pr inc" -> "Press inclinado");
+//  - trigramas, para encontrar cualquier subcadena de 3 o más caracteres sin
+//    recorrer todo el catálogo.
+//
+// Los nombres equivalentes en español e inglés (data/exerciseAliases.txt)
+// se enlazan: si uno coincide, el otro aparece detrás de los directos.
+class ExerciseSearchIndex
+{
+public:
+    struct Entry {
+        QString name;
+        QString group;
+        QString folded;
+        int aliasGroup = -1;
+    };
+
+    struct Result {
+        int entry = -1;
+        int score = 0;
+        int matchStart = -1;  // posición de la coincidencia en el nombre (-1 si es por alias)
+        int matchLength = 0;
+        bool viaAlias = false;
+    };
+
+    // Memoria de trabajo de un consumidor: se reutiliza entre búsquedas para
+    // no reservar nada proporcional al catálogo en cada pulsación
+    struct Scratch {
+        QList<Result> best;    // por entrada; score 0 = sin coincidencia
+        QList<quint32> masks;  // palabras de la consulta encontradas por entrada
+        QList<int> touched;
+        QList<Result> results; // salida de search()
+    };
+
+    static ExerciseSearchIndex build(const QString& aliasesPath);
+
+    int size() const { return m_entries.size(); }
+    const Entry& entry(int i) const { return m_entries.at(i); }
+
+    // Deja en scratch->results como mucho limit resultados ordenados por
+    // relevancia (limit <= 0: sin límite). Sin consulta, todo el catálogo
+    // en orden alfabético.
+    void search(QStringView query, int limit, Scratch* scratch) const;
+
+private:
+    struct Token {
+        QString text;
+        int entry;
+        int position;
+    };
+
+    QList<Entry> m_entries;
+    QList<int> m_alphabetical;
+    QList<Token> m_tokens;                 // ordenadas por texto
+    QHash<quint64, QList<int>> m_trigrams; // trigrama -> entradas, sin repetir
+    QList<QList<int>> m_aliasGroups;
+
+    void loadAliases(const QString& path);
+    static quint64 trigramKey(QStringView text);
+};
+
+#endif // EXERCISESEARCHINDEX_H
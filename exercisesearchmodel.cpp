@@ -0,0 +1,94 @@
+#include "exercisesearchmodel.h"
+#include "diagnostics.h"
+#include <QPromise>
+#include <QThreadPool>
+#include <memory>
+
+ExerciseSearchModel::ExerciseSearchModel(QObject *parent) : QAbstractListModel(parent) {
+    connect(&m_watcher, &QFutureWatcherBase::finished, this, [this]() {
+        m_index = m_watcher.result();
+        refresh();
+        emit readyChanged();
+    });
+    m_watcher.setFuture(sharedIndex());
+}
+
+QFuture<QSharedPointer<const ExerciseSearchIndex>> ExerciseSearchModel::sharedIndex() {
+    // Se construye una sola vez, en un hilo del pool, la primera vez que se pide
+    static const QFuture<QSharedPointer<const ExerciseSearchIndex>> future = []() {
+        auto promise = std::make_shared<QPromise<QSharedPointer<const ExerciseSearchIndex>>>();
+        QFuture<QSharedPointer<const ExerciseSearchIndex>> result = promise->future();
+        promise->start();
+        QThreadPool::globalInstance()->start([promise]() {
+            promise->addResult(QSharedPointer<const ExerciseSearchIndex>(
+                new ExerciseSearchIndex(ExerciseSearchIndex::build(":/data/exerciseAliases.txt"))));
+            promise->finish();
+        });
+        return result;
+    }();
+    return future;
+}
+
+void ExerciseSearchModel::setQuery(const QString& query) {
+    if (m_query == query)
+        return;
+    m_query = query;
+    refresh();
+    emit queryChanged();
+}
+
+void ExerciseSearchModel::setLimit(int limit) {
+    if (m_limit == limit)
+        return;
+    m_limit = limit;
+    refresh();
+    emit limitChanged();
+}
+
+void ExerciseSearchModel::refresh() {
+    if (!m_index)
+        return;
+
+    const int previousCount = count();
+    beginResetModel();
+    {
+        ScopedTimer timer("search.query");
+        m_index->search(m_query, m_limit, &m_scratch);
+    }
+    endResetModel();
+
+    if (count() != previousCount)
+        emit countChanged();
+}
+
+int ExerciseSearchModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant ExerciseSearchModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || !m_index || index.row() >= count())
+        return QVariant();
+
+    const ExerciseSearchIndex::Result& result = m_scratch.results.at(index.row());
+    const ExerciseSearchIndex::Entry& entry = m_index->entry(result.entry);
+
+    switch (role) {
+    case NameRole: return entry.name;
+    case GroupRole: return entry.group;
+    // Las posiciones son del nombre normalizado; sólo valen si mide lo mismo
+    case MatchStartRole: return entry.folded.size() == entry.name.size() ? result.matchStart : -1;
+    case MatchLengthRole: return result.matchLength;
+    case AliasRole: return result.viaAlias;
+    default: return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ExerciseSearchModel::roleNames() const {
+    return {
+        {NameRole, "name"},
+        {GroupRole, "group"},
+        {MatchStartRole, "matchStart"},
+        {MatchLengthRole, "matchLength"},
+        {AliasRole, "alias"}
+    };
+}
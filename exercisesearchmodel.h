@@ -0,0 +1,61 @@
+#ifndef EXERCISESEARCHMODEL_H
+#define EXERCISESEARCHMODEL_H
+
+#include <QAbstractListModel>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include "exercisesearchindex.h"
+
+// Resultados del autocompletado de NewExerciseDialog: los mejores "limit"
+// ejercicios del catálogo para la consulta actual. El índice se construye una
+// sola vez por proceso en segundo plano y lo comparten todas las instancias.
+class ExerciseSearchModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+    // Sólo se aplica con consulta; sin ella se lista el catálogo completo
+    Q_PROPERTY(int limit READ limit WRITE setLimit NOTIFY limitChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged)
+
+public:
+    enum Roles {
+        NameRole = Qt::UserRole + 1,
+        GroupRole,
+        MatchStartRole,   // -1 si no hay tramo que resaltar
+        MatchLengthRole,
+        AliasRole         // encontrado por su nombre en el otro idioma
+    };
+
+    explicit ExerciseSearchModel(QObject *parent = nullptr);
+
+    QString query() const { return m_query; }
+    void setQuery(const QString& query);
+    int limit() const { return m_limit; }
+    void setLimit(int limit);
+    int count() const { return int(m_scratch.results.size()); }
+    bool isReady() const { return !m_index.isNull(); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    static QFuture<QSharedPointer<const ExerciseSearchIndex>> sharedIndex();
+
+signals:
+    void queryChanged();
+    void limitChanged();
+    void countChanged();
+    void readyChanged();
+
+private:
+    QSharedPointer<const ExerciseSearchIndex> m_index;
+    ExerciseSearchIndex::Scratch m_scratch;
+    QFutureWatcher<QSharedPointer<const ExerciseSearchIndex>> m_watcher;
+    QString m_query;
+    int m_limit = 50;
+
+    void refresh();
+};
+
+#endif // EXERCISESEARCHMODEL_H
@@ -0,0 +1,89 @@
+#include "exercisestats.h"
+#include <QDateTime>
+#include <limits>
+
+void ExerciseStats::reset() {
+    invalidate();
+    m_valid = true;
+}
+
+qint64 ExerciseStats::dayOf(qint64 timestamp) {
+    return QDateTime::fromMSecsSinceEpoch(timestamp).date().toJulianDay();
+}
+
+double ExerciseStats::estimateOneRepMax(double weight, int repetitions) {
+    if (weight <= 0 || repetitions <= 0)
+        return 0;
+    if (repetitions == 1)
+        return weight;
+    if (repetitions <= 10)
+        return weight * 36.0 / (37.0 - repetitions);
+    return weight * (1.0 + repetitions / 30.0);
+}
+
+double ExerciseStats::slope(const qint64* timestamps, const double* values, int count) {
+    if (count < 2)
+        return 0;
+
+    // Fechas relativas al primer punto y en semanas para no perder precisión
+    constexpr double msPerWeek = 7.0 * 24 * 60 * 60 * 1000;
+    double sumT = 0, sumV = 0, sumTT = 0, sumTV = 0;
+    for (int i = 0; i < count; ++i) {
+        const double t = (timestamps[i] - timestamps[0]) / msPerWeek;
+        sumT += t;
+        sumV += values[i];
+        sumTT += t * t;
+        sumTV += t * values[i];
+    }
+
+    const double denominator = count * sumTT - sumT * sumT;
+    if (qFuzzyIsNull(denominator))
+        return 0;
+    return (count * sumTV - sumT * sumV) / denominator;
+}
+
+qint64 ExerciseStats::personalRecordTimestamp() const {
+    if (m_values.empty())
+        return std::numeric_limits<qint64>::min();
+    return *m_values.rbegin()->second.begin();
+}
+
+void ExerciseStats::add(qint64 timestamp, double value, int sets, int repetitions, bool weighted) {
+    const double metric = weighted ? value : repetitions;
+    ++m_records;
+    m_values[metric].insert(timestamp);
+    if (weighted) {
+        const double estimate = estimateOneRepMax(value, repetitions);
+        if (estimate > 0)
+            ++m_oneRepMax[estimate];
+    }
+    m_volume += value * sets * repetitions;
+    ++m_days[dayOf(timestamp)];
+}
+
+void ExerciseStats::remove(qint64 timestamp, double value, int sets, int repetitions, bool weighted) {
+    const double metric = weighted ? value : repetitions;
+    --m_records;
+
+    const auto values = m_values.find(metric);
+    if (values != m_values.end()) {
+        const auto it = values->second.find(timestamp);
+        if (it != values->second.end())
+            values->second.erase(it);
+        if (values->second.empty())
+            m_values.erase(values);
+    }
+
+    if (weighted) {
+        const auto it = m_oneRepMax.find(estimateOneRepMax(value, repetitions));
+        if (it != m_oneRepMax.end() && --it->second == 0)
+            m_oneRepMax.erase(it);
+    }
+
+    // Sin registros se parte de cero para no arrastrar errores de redondeo
+    m_volume = m_records > 0 ? m_volume - value * sets * repetitions : 0;
+
+    const auto day = m_days.find(dayOf(timestamp));
+    if (day != m_days.end() && --day.value() == 0)
+        m_days.erase(day);
+}
@@ -0,0 +1,62 @@
+#ifndef EXERCISESTATS_H
+#define EXERCISESTATS_H
+
+#include <QHash>
+#include <QtGlobal>
+#include <map>
+#include <set>
+
+// Agregados de un ejercicio (récord, 1RM estimado, volumen, sesiones y
+// tendencia) que se mantienen al añadir o borrar registros sin recorrer el
+// historial: cada registro suma o resta su aportación. Los máximos se guardan
+// como multiconjuntos ordenados, así que borrar el récord sólo cuesta buscar
+// el siguiente (O(log n)).
+//
+// El valor de cada registro es el peso en kg (el almacén lo normaliza con
+// HistoryAnalytics::unitFactor), o las repeticiones si no tiene unidad, igual
+// que en el gráfico. El volumen sale en kg, como en el análisis y los resúmenes.
+class ExerciseStats
+{
+public:
+    // Registros más recientes con los que se calcula la tendencia
+    static constexpr int kTrendWindow = 8;
+
+    bool isValid() const { return m_valid; }
+    void invalidate() { *this = ExerciseStats(); }
+    // Sin registros pero válido (ejercicio nuevo o historial vaciado)
+    void reset();
+
+    void add(qint64 timestamp, double value, int sets, int repetitions, bool weighted);
+    void remove(qint64 timestamp, double value, int sets, int repetitions, bool weighted);
+    // La tendencia depende del orden del historial: la calcula el almacén
+    void setTrend(double perWeek) { m_trend = perWeek; }
+
+    int recordCount() const { return m_records; }
+    double personalRecord() const { return m_values.empty() ? 0 : m_values.rbegin()->first; }
+    // Primer registro con el valor del récord
+    qint64 personalRecordTimestamp() const;
+    double oneRepMax() const { return m_oneRepMax.empty() ? 0 : m_oneRepMax.rbegin()->first; }
+    double totalVolume() const { return m_volume; }
+    // Días distintos con algún registro
+    int sessionCount() const { return int(m_days.size()); }
+    // Pendiente de la recta de mínimos cuadrados de los últimos registros, por semana
+    double trend() const { return m_trend; }
+
+    // Brzycki hasta 10 repeticiones, Epley a partir de ahí (Brzycki se dispara
+    // cerca de las 37). Sin peso o sin repeticiones no hay estimación.
+    static double estimateOneRepMax(double weight, int repetitions);
+    static double slope(const qint64* timestamps, const double* values, int count);
+
+private:
+    bool m_valid = false;
+    int m_records = 0;
+    std::map<double, std::multiset<qint64>> m_values; // valor -> fechas
+    std::map<double, int> m_oneRepMax;                // estimación -> veces
+    double m_volume = 0;
+    QHash<qint64, int> m_days;                        // día juliano -> registros
+    double m_trend = 0;
+
+    static qint64 dayOf(qint64 timestamp);
+};
+
+#endif // EXERCISESTATS_H
@@ -0,0 +1,551 @@
+#include "exercisestore.h"
+#include "historyanalytics.h"
+#include "isodate.h"
+#include "logging.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <algorithm>
+#include <atomic>
+
+int StringPool::intern(const QString& value) {
+    auto it = m_ids.constFind(value);
+    if (it != m_ids.constEnd())
+        return it.value();
+
+    const int id = m_values.size();
+    if (id >= m_capacity)
+        return -1;
+    m_values.append(value);
+    m_ids.insert(value, id);
+    return id;
+}
+
+ExerciseStore::Record ExerciseStore::History::at(int i) const {
+    Record record;
+    record.timestamp = timestampAt(i);
+    record.value = valueAt(i);
+    record.sets = setsAt(i);
+    record.repetitions = repetitionsAt(i);
+    record.unitId = unitIdAt(i);
+    return record;
+}
+
+int ExerciseStore::History::lowerBound(qint64 timestamp) const {
+    int low = 0, high = size();
+    while (low < high) {
+        const int middle = low + (high - low) / 2;
+        if (timestampAt(middle) < timestamp)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+bool ExerciseStore::History::containsTimestamp(qint64 timestamp) const {
+    const int index = lowerBound(timestamp);
+    return index < size() && timestampAt(index) == timestamp;
+}
+
+int ExerciseStore::History::indexOf(const Record& record) const {
+    for (int i = lowerBound(record.timestamp); i < size() && timestampAt(i) == record.timestamp; ++i) {
+        if (valueAt(i) == record.value && setsAt(i) == record.sets
+            && repetitionsAt(i) == record.repetitions && unitIdAt(i) == record.unitId)
+            return i;
+    }
+    return -1;
+}
+
+void ExerciseStore::History::materialize() {
+    if (!mapped)
+        return;
+
+    const SnapshotRecord* records = mapped;
+    const int count = mappedCount;
+    mapped = nullptr;
+    mappedCount = 0;
+
+    timestamps.resize(count);
+    values.resize(count);
+    sets.resize(count);
+    repetitions.resize(count);
+    unitIds.resize(count);
+    for (int i = 0; i < count; ++i) {
+        timestamps[i] = records[i].timestamp;
+        values[i] = records[i].value;
+        sets[i] = records[i].sets;
+        repetitions[i] = records[i].repetitions;
+        unitIds[i] = records[i].unitId;
+    }
+}
+
+int ExerciseStore::History::insert(const Record& record) {
+    materialize();
+
+    // Inserción ordenada: los registros con la misma fecha quedan en orden de llegada.
+    // Lo normal es que el registro nuevo sea el más reciente y vaya al final.
+    int i = timestamps.size();
+    if (!timestamps.isEmpty() && record.timestamp < timestamps.constLast()) {
+        const auto pos = std::upper_bound(timestamps.cbegin(), timestamps.cend(), record.timestamp);
+        i = int(pos - timestamps.cbegin());
+    }
+
+    timestamps.insert(i, record.timestamp);
+    values.insert(i, record.value);
+    sets.insert(i, qint16(record.sets));
+    repetitions.insert(i, qint16(record.repetitions));
+    unitIds.insert(i, quint8(record.unitId));
+    return i;
+}
+
+void ExerciseStore::History::removeAt(int i) {
+    materialize();
+    timestamps.removeAt(i);
+    values.removeAt(i);
+    sets.removeAt(i);
+    repetitions.removeAt(i);
+    unitIds.removeAt(i);
+}
+
+void ExerciseStore::History::clear() {
+    mapped = nullptr;
+    mappedCount = 0;
+    timestamps.clear();
+    values.clear();
+    sets.clear();
+    repetitions.clear();
+    unitIds.clear();
+}
+
+ExerciseStore::ExerciseStore() {
+    // El id 0 es siempre la unidad "sin unidad"
+    m_units.intern("-");
+    touch();
+}
+
+void ExerciseStore::touch() {
+    // Contador global: dos almacenes distintos nunca comparten versión
+    static std::atomic<quint64> next{1};
+    m_version = next++;
+}
+
+const ExerciseStore::Exercise* ExerciseStore::find(const QString& name) const {
+    const int row = indexOf(name);
+    return row < 0 ? nullptr : &m_exercises.at(row);
+}
+
+int ExerciseStore::insertionRow(const QString& name) const {
+    const auto pos = std::lower_bound(m_exercises.cbegin(), m_exercises.cend(), name,
+                                      [](const Exercise& e, const QString& n) { return e.name < n; });
+    return int(pos - m_exercises.cbegin());
+}
+
+void ExerciseStore::rebuildIndex(int fromRow) {
+    for (int row = fromRow; row < m_exercises.size(); ++row)
+        m_index[m_exercises.at(row).name] = row;
+}
+
+const ExerciseStats& ExerciseStore::stats(int row) const {
+    const Exercise& exercise = m_exercises.at(row);
+    if (!exercise.stats.isValid())
+        exercise.stats = computeStats(exercise.history);
+    return exercise.stats;
+}
+
+ExerciseStats ExerciseStore::computeStats(const History& history) const {
+    // Un factor por unidad, no una comparación de cadenas por registro
+    double factors[kMaxUnits];
+    for (int id = 0; id < m_units.size(); ++id)
+        factors[id] = unitFactor(id);
+
+    ExerciseStats stats;
+    stats.reset();
+    for (int i = 0; i < history.size(); ++i) {
+        const int unitId = history.unitIdAt(i);
+        stats.add(history.timestampAt(i), history.valueAt(i) * factors[unitId], history.setsAt(i),
+                  history.repetitionsAt(i), unitId != 0);
+    }
+
+    stats.setTrend(trendOf(history));
+    return stats;
+}
+
+void ExerciseStore::rollupRecord(int muscleGroupId, const Record& record, bool add) {
+    if (record.timestamp == kNoTimestamp)
+        return;
+
+    const double volume = record.value * unitFactor(record.unitId) * record.sets * record.repetitions;
+    if (add)
+        m_rollup.add(record.timestamp, muscleGroupId, record.sets, record.repetitions, volume);
+    else
+        m_rollup.remove(record.timestamp, muscleGroupId, record.sets, record.repetitions, volume);
+}
+
+void ExerciseStore::rollupHistory(const Exercise& exercise, bool add) {
+    for (int i = 0; i < exercise.history.size(); ++i)
+        rollupRecord(exercise.muscleGroupId, exercise.history.at(i), add);
+}
+
+double ExerciseStore::unitFactor(int unitId) const {
+    return HistoryAnalytics::unitFactor(m_units.at(unitId));
+}
+
+double ExerciseStore::trendOf(const History& history) const {
+    // Sólo los últimos kTrendWindow registros: coste constante
+    const int count = std::min(history.size(), ExerciseStats::kTrendWindow);
+    qint64 timestamps[ExerciseStats::kTrendWindow];
+    double values[ExerciseStats::kTrendWindow];
+    for (int i = 0; i < count; ++i) {
+        const int index = history.size() - count + i;
+        timestamps[i] = history.timestampAt(index);
+        const int unitId = history.unitIdAt(index);
+        values[i] = unitId != 0 ? history.valueAt(index) * unitFactor(unitId) : history.repetitionsAt(index);
+    }
+    return ExerciseStats::slope(timestamps, values, count);
+}
+
+void ExerciseStore::refreshCurrent(Exercise& exercise) const {
+    const History& history = exercise.history;
+    if (history.isEmpty()) {
+        exercise.currentValue = 0;
+        exercise.unitId = 0;
+        exercise.sets = 0;
+        exercise.repetitions = 0;
+        exercise.lastUpdated = kNoTimestamp;
+        return;
+    }
+
+    const int last = history.size() - 1;
+    exercise.currentValue = history.valueAt(last);
+    exercise.unitId = history.unitIdAt(last);
+    exercise.sets = history.setsAt(last);
+    exercise.repetitions = history.repetitionsAt(last);
+    exercise.lastUpdated = history.timestampAt(last);
+}
+
+int ExerciseStore::setExercise(const QString& name, const QString& muscleGroup) {
+    int row = indexOf(name);
+    if (row < 0) {
+        row = insertionRow(name);
+        Exercise exercise;
+        exercise.name = name;
+        m_exercises.insert(row, exercise);
+        rebuildIndex(row);
+    }
+
+    Exercise& exercise = m_exercises[row];
+    rollupHistory(exercise, false);
+    exercise.muscleGroupId = m_muscleGroups.intern(muscleGroup);
+    exercise.history.clear();
+    exercise.stats.reset();
+    refreshCurrent(exercise);
+    touch();
+    return row;
+}
+
+int ExerciseStore::addRecord(const QString& name, const Record& record) {
+    const int row = indexOf(name);
+    if (row < 0 || !record.fits())
+        return -1;
+
+    Exercise& exercise = m_exercises[row];
+    exercise.history.insert(record);
+    rollupRecord(exercise.muscleGroupId, record, true);
+    if (exercise.stats.isValid()) {
+        exercise.stats.add(record.timestamp, record.value * unitFactor(record.unitId), record.sets,
+                           record.repetitions, record.unitId != 0);
+        exercise.stats.setTrend(trendOf(exercise.history));
+    }
+    refreshCurrent(exercise);
+    touch();
+    return row;
+}
+
+int ExerciseStore::removeRecord(const QString& name, int index) {
+    const int row = indexOf(name);
+    if (row < 0)
+        return -1;
+
+    Exercise& exercise = m_exercises[row];
+    if (index < 0 || index >= exercise.history.size())
+        return -1;
+
+    const Record removed = exercise.history.at(index);
+    rollupRecord(exercise.muscleGroupId, removed, false);
+    if (exercise.stats.isValid()) {
+        exercise.stats.remove(removed.timestamp, removed.value * unitFactor(removed.unitId), removed.sets,
+                              removed.repetitions, removed.unitId != 0);
+    }
+    exercise.history.removeAt(index);
+    if (exercise.stats.isValid())
+        exercise.stats.setTrend(trendOf(exercise.history));
+    refreshCurrent(exercise);
+    touch();
+    return row;
+}
+
+int ExerciseStore::removeExercise(const QString& name) {
+    const int row = indexOf(name);
+    if (row < 0)
+        return -1;
+
+    rollupHistory(m_exercises.at(row), false);
+    m_exercises.removeAt(row);
+    m_index.remove(name);
+    rebuildIndex(row);
+    touch();
+    return row;
+}
+
+int ExerciseStore::insertExercise(const Exercise& exercise) {
+    if (contains(exercise.name))
+        return -1;
+
+    const int row = insertionRow(exercise.name);
+    m_exercises.insert(row, exercise);
+    rebuildIndex(row);
+
+    Exercise& inserted = m_exercises[row];
+    // Una vista mapeada sólo es válida con el snapshot de este almacén
+    inserted.history.materialize();
+    rollupHistory(inserted, true);
+    refreshCurrent(inserted);
+    touch();
+    return row;
+}
+
+void ExerciseStore::adoptExercises(QList<Exercise> exercises, const QByteArray& rollup) {
+    // El orden del motor (p. ej. la colación de SQLite) puede no ser el de QString
+    const auto byName = [](const Exercise& a, const Exercise& b) { return a.name < b.name; };
+    if (!std::is_sorted(exercises.cbegin(), exercises.cend(), byName))
+        std::sort(exercises.begin(), exercises.end(), byName);
+
+    m_exercises = std::move(exercises);
+    m_index.clear();
+    rebuildIndex(0);
+    for (Exercise& exercise : m_exercises)
+        refreshCurrent(exercise);
+
+    m_rollup = TrainingRollup();
+    const auto intern = [this](const QString& group) { return m_muscleGroups.intern(group); };
+    if (rollup.isEmpty() || !TrainingRollup::deserialize(rollup, intern, &m_rollup)) {
+        m_rollup = TrainingRollup();
+        for (const Exercise& exercise : std::as_const(m_exercises))
+            rollupHistory(exercise, true);
+    }
+    touch();
+}
+
+void ExerciseStore::clear() {
+    m_exercises.clear();
+    m_index.clear();
+    m_metadata = QJsonObject();
+    m_snapshot.reset();
+    m_rollup = TrainingRollup();
+    touch();
+}
+
+QStringList ExerciseStore::units() const {
+    return m_units.values();
+}
+
+qint64 ExerciseStore::parseTimestamp(const QString& text) {
+    if (text.isEmpty())
+        return kNoTimestamp;
+
+    qint64 msecs = 0;
+    if (IsoDate::parse(QStringView(text), &msecs))
+        return msecs;
+
+    // Formatos ISO poco habituales que no cubre el parser rápido
+    const QDateTime dateTime = QDateTime::fromString(text, Qt::ISODate);
+    return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : kNoTimestamp;
+}
+
+QString ExerciseStore::formatTimestamp(qint64 timestamp) {
+    if (timestamp == kNoTimestamp)
+        return QString();
+
+    return IsoDate::format(timestamp);
+}
+
+ExerciseStore ExerciseStore::fromJson(const QJsonObject& root) {
+    ExerciseStore store;
+
+    const QJsonObject exercises = root["exercises"].toObject();
+    store.m_exercises.reserve(exercises.size());
+
+    for (auto it = exercises.constBegin(); it != exercises.constEnd(); ++it) {
+        const QJsonObject json = it.value().toObject();
+        const QJsonArray historyArray = json["history"].toArray();
+
+        Exercise exercise;
+        exercise.name = it.key();
+        exercise.muscleGroupId = store.m_muscleGroups.intern(json["muscleGroup"].toString());
+
+        // Las fechas se interpretan una sola vez, antes de ordenar
+        QList<Record> records;
+        records.reserve(historyArray.size());
+        int rejected = 0;
+        for (const QJsonValue& value : historyArray) {
+            const QJsonObject entry = value.toObject();
+            Record record;
+            record.timestamp = parseTimestamp(entry["timestamp"].toString());
+            record.value = entry["value"].toDouble();
+            record.sets = entry.contains("sets") ? entry["sets"].toInt() : 3;
+            record.repetitions = entry["repetitions"].toInt();
+            record.unitId = store.m_units.intern(entry["unit"].toString());
+            if (!record.fits()) {
+                ++rejected;
+                continue;
+            }
+            records.append(record);
+        }
+        if (rejected > 0)
+            qCWarning(lcData) << "fromJson()" << exercise.name << "-" << rejected << "registros fuera de rango descartados";
+
+        const auto byTimestamp = [](const Record& a, const Record& b) {
+            return a.timestamp < b.timestamp;
+        };
+        if (!std::is_sorted(records.cbegin(), records.cend(), byTimestamp))
+            std::stable_sort(records.begin(), records.end(), byTimestamp);
+
+        History& history = exercise.history;
+        history.timestamps.reserve(records.size());
+        history.values.reserve(records.size());
+        history.sets.reserve(records.size());
+        history.repetitions.reserve(records.size());
+        history.unitIds.reserve(records.size());
+        for (const Record& record : records) {
+            history.timestamps.append(record.timestamp);
+            history.values.append(record.value);
+            history.sets.append(qint16(record.sets));
+            history.repetitions.append(qint16(record.repetitions));
+            history.unitIds.append(quint8(record.unitId));
+        }
+
+        store.refreshCurrent(exercise);
+        store.rollupHistory(exercise, true);
+        store.m_exercises.append(exercise);
+    }
+
+    // QJsonObject no garantiza el mismo orden que QString::operator<
+    std::sort(store.m_exercises.begin(), store.m_exercises.end(),
+              [](const Exercise& a, const Exercise& b) { return a.name < b.name; });
+    store.rebuildIndex(0);
+
+    for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+        if (it.key() != "exercises")
+            store.m_metadata[it.key()] = it.value();
+    }
+
+    return store;
+}
+
+ExerciseStore ExerciseStore::fromSnapshot(const QSharedPointer<const BinarySnapshot>& snapshot) {
+    ExerciseStore store;
+    store.m_snapshot = snapshot;
+
+    // El snapshot guarda la tabla de unidades en el orden de sus ids (empieza
+    // por "-"), así que internarla en orden conserva los ids de los registros
+    const QStringList units = snapshot->units();
+    for (const QString& unit : units)
+        store.m_units.intern(unit);
+
+    const int count = snapshot->exerciseCount();
+    store.m_exercises.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const BinarySnapshot::DirectoryEntry& entry = snapshot->entry(i);
+        Exercise exercise;
+        exercise.name = snapshot->exerciseName(i);
+        exercise.muscleGroupId = store.m_muscleGroups.intern(snapshot->muscleGroup(i));
+        // El resumen viene del directorio: los registros no se tocan hasta que se piden
+        exercise.currentValue = entry.currentValue;
+        exercise.unitId = entry.unitId;
+        exercise.sets = entry.sets;
+        exercise.repetitions = entry.repetitions;
+        exercise.lastUpdated = entry.lastUpdated;
+        exercise.history.mapped = snapshot->records(i);
+        exercise.history.mappedCount = snapshot->recordCount(i);
+        store.m_exercises.append(exercise);
+    }
+
+    // El escritor ya los guarda ordenados por nombre
+    store.rebuildIndex(0);
+    store.m_metadata = snapshot->metadata();
+
+    // Snapshots de la versión 1 no llevan resúmenes: se rehacen una vez
+    // recorriendo los registros y el siguiente snapshot ya los guarda
+    const auto intern = [&store](const QString& group) { return store.m_muscleGroups.intern(group); };
+    if (!TrainingRollup::deserialize(snapshot->rollup(), intern, &store.m_rollup)) {
+        for (const Exercise& exercise : std::as_const(store.m_exercises))
+            store.rollupHistory(exercise, true);
+    }
+    return store;
+}
+
+int ExerciseStore::materializedCount() const {
+    int count = 0;
+    for (const Exercise& exercise : m_exercises) {
+        if (!exercise.history.isMapped() && !exercise.history.isEmpty())
+            ++count;
+    }
+    return count;
+}
+
+void ExerciseStore::remap(const QSharedPointer<const BinarySnapshot>& snapshot) {
+    // Sólo es válido si el snapshot se escribió a partir de este mismo estado
+    if (snapshot->exerciseCount() != m_exercises.size())
+        return;
+
+    for (int i = 0; i < m_exercises.size(); ++i) {
+        History& history = m_exercises[i].history;
+        if (snapshot->exerciseName(i) != m_exercises.at(i).name
+            || snapshot->recordCount(i) != history.size())
+            return;
+    }
+
+    // Las columnas en memoria se liberan; el sistema puede descartar las páginas
+    // mapeadas cuando necesite memoria y releerlas del fichero si se vuelven a pedir
+    for (Exercise& exercise : m_exercises) {
+        const int row = int(&exercise - m_exercises.data());
+        exercise.history.clear();
+        exercise.history.mapped = snapshot->records(row);
+        exercise.history.mappedCount = snapshot->recordCount(row);
+    }
+    m_snapshot = snapshot;
+}
+
+QJsonObject ExerciseStore::exerciseToJson(const Exercise& exercise) const {
+    QJsonArray historyArray;
+    for (int i = 0; i < exercise.history.size(); ++i) {
+        const Record record = exercise.history.at(i);
+        historyArray.append(QJsonObject{
+            {"timestamp", formatTimestamp(record.timestamp)},
+            {"value", record.value},
+            {"unit", unit(record.unitId)},
+            {"sets", record.sets},
+            {"repetitions", record.repetitions}
+        });
+    }
+
+    return QJsonObject{
+        {"muscleGroup", muscleGroup(exercise)},
+        {"currentValue", exercise.currentValue},
+        {"unit", unit(exercise.unitId)},
+        {"sets", exercise.sets},
+        {"repetitions", exercise.repetitions},
+        {"lastUpdated", formatTimestamp(exercise.lastUpdated)},
+        {"history", historyArray}
+    };
+}
+
+QJsonObject ExerciseStore::toJson() const {
+    QJsonObject exercises;
+    for (int row = 0; row < m_exercises.size(); ++row)
+        exercises[m_exercises.at(row).name] = exerciseToJson(row);
+
+    QJsonObject root = m_metadata;
+    root["exercises"] = exercises;
+    return root;
+}
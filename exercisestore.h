@@ -0,0 +1,190 @@
+#ifndef EXERCISESTORE_H
+#define EXERCISESTORE_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <limits>
+#include "binarysnapshot.h"
+#include "exercisestats.h"
+#include "trainingrollup.h"
+
+// Tabla de cadenas internadas (grupos musculares, unidades): cada valor
+// distinto se guarda una sola vez y los registros sólo llevan su id.
+// Con capacidad, intern() devuelve -1 para un valor nuevo si ya está llena.
+class StringPool
+{
+public:
+    explicit StringPool(int capacity = std::numeric_limits<int>::max()) : m_capacity(capacity) {}
+
+    int intern(const QString& value);
+    int find(const QString& value) const { return m_ids.value(value, -1); }
+    QString at(int id) const { return id >= 0 && id < m_values.size() ? m_values.at(id) : QString(); }
+    int size() const { return m_values.size(); }
+    QStringList values() const { return m_values; }
+
+private:
+    QStringList m_values;
+    QHash<QString, int> m_ids;
+    int m_capacity;
+};
+
+// Almacén en memoria de ejercicios. Los ejercicios se guardan ordenados por
+// nombre con un índice hash para búsquedas O(1); el historial de cada uno se
+// guarda por columnas contiguas ordenadas cronológicamente (más antiguo primero).
+// El JSON sólo se usa en la frontera de persistencia (fromJson/toJson).
+class ExerciseStore
+{
+public:
+    static constexpr qint64 kNoTimestamp = std::numeric_limits<qint64>::min();
+    // El historial guarda series y repeticiones en 16 bits y la unidad en 8
+    static constexpr int kMaxCount = std::numeric_limits<qint16>::max();
+    static constexpr int kMaxUnits = std::numeric_limits<quint8>::max() + 1;
+
+    struct Record {
+        qint64 timestamp = kNoTimestamp; // ms desde epoch
+        double value = 0;
+        int sets = 0;
+        int repetitions = 0;
+        int unitId = 0;
+
+        // Cabe en las columnas del historial sin truncarse
+        bool fits() const {
+            return sets >= 0 && sets <= kMaxCount && repetitions >= 0 && repetitions <= kMaxCount
+                && unitId >= 0 && unitId < kMaxUnits;
+        }
+    };
+
+    // Historial de un ejercicio. Recién cargado de un snapshot binario es una
+    // vista sobre los registros mapeados; la primera mutación lo copia a columnas.
+    struct History {
+        QList<qint64> timestamps;
+        QList<double> values;
+        QList<qint16> sets;
+        QList<qint16> repetitions;
+        QList<quint8> unitIds;
+
+        const SnapshotRecord* mapped = nullptr;
+        int mappedCount = 0;
+
+        int size() const { return mapped ? mappedCount : int(timestamps.size()); }
+        bool isEmpty() const { return size() == 0; }
+        bool isMapped() const { return mapped != nullptr; }
+
+        qint64 timestampAt(int i) const { return mapped ? mapped[i].timestamp : timestamps.at(i); }
+        double valueAt(int i) const { return mapped ? mapped[i].value : values.at(i); }
+        int setsAt(int i) const { return mapped ? mapped[i].sets : sets.at(i); }
+        int repetitionsAt(int i) const { return mapped ? mapped[i].repetitions : repetitions.at(i); }
+        int unitIdAt(int i) const { return mapped ? mapped[i].unitId : unitIds.at(i); }
+
+        Record at(int i) const;
+        // Búsqueda binaria: el historial está ordenado por fecha
+        int lowerBound(qint64 timestamp) const;
+        bool containsTimestamp(qint64 timestamp) const;
+        // Posición de un registro igual en todos sus campos, o -1
+        int indexOf(const Record& record) const;
+        int insert(const Record& record);
+        void removeAt(int i);
+        void clear();
+        void materialize();
+    };
+
+    struct Exercise {
+        QString name;
+        int muscleGroupId = 0;
+        double currentValue = 0;
+        int unitId = 0;
+        int sets = 0;
+        int repetitions = 0;
+        qint64 lastUpdated = kNoTimestamp;
+        History history;
+        // Se calculan la primera vez que se piden y luego se actualizan con
+        // cada registro añadido o borrado (ver stats())
+        mutable ExerciseStats stats;
+    };
+
+    ExerciseStore();
+
+    int count() const { return m_exercises.size(); }
+    // Cambia con cada mutación; distinto entre almacenes creados por separado
+    quint64 version() const { return m_version; }
+    int indexOf(const QString& name) const { return m_index.value(name, -1); }
+    bool contains(const QString& name) const { return m_index.contains(name); }
+    const Exercise& at(int row) const { return m_exercises.at(row); }
+    const Exercise* find(const QString& name) const;
+    int insertionRow(const QString& name) const;
+    // Agregados del ejercicio; el primer acceso recorre el historial una vez
+    const ExerciseStats& stats(int row) const;
+    // Pesos en kg (HistoryAnalytics::unitFactor), como el análisis y los resúmenes
+    ExerciseStats computeStats(const History& history) const;
+
+    QString muscleGroup(const Exercise& exercise) const { return m_muscleGroups.at(exercise.muscleGroupId); }
+    QString unit(int unitId) const { return m_units.at(unitId); }
+    QStringList muscleGroups() const { return m_muscleGroups.values(); }
+    int internMuscleGroup(const QString& group) { return m_muscleGroups.intern(group); }
+    // -1 si la tabla de unidades está llena (kMaxUnits)
+    int internUnit(const QString& unit) { return m_units.intern(unit); }
+
+    // Mutaciones: devuelven la fila afectada o -1 si no se pudo aplicar
+    // (addRecord rechaza los registros que no caben: Record::fits)
+    int setExercise(const QString& name, const QString& muscleGroup);
+    int addRecord(const QString& name, const Record& record);
+    int removeRecord(const QString& name, int index);
+    int removeExercise(const QString& name);
+    // Vuelve a poner un ejercicio completo (deshacer un borrado); comparte sus columnas
+    int insertExercise(const Exercise& exercise);
+    // Carga en bloque desde un motor de persistencia: historiales en columnas
+    // y con ids de este almacén. Los resúmenes salen de rollup (serialize) si
+    // es válido; si no, se rehacen recorriendo los registros
+    void adoptExercises(QList<Exercise> exercises, const QByteArray& rollup);
+    void clear();
+
+    // Resúmenes por día, semana y mes; se actualizan con cada mutación
+    const TrainingRollup& rollup() const { return m_rollup; }
+
+    // Valores no relacionados con ejercicios (lastSync, appVersion...)
+    QJsonObject metadata() const { return m_metadata; }
+    void setMetadata(const QString& key, const QJsonValue& value) { m_metadata[key] = value; }
+    void removeMetadata(const QString& key) { m_metadata.remove(key); }
+
+    static ExerciseStore fromJson(const QJsonObject& root);
+    static ExerciseStore fromSnapshot(const QSharedPointer<const BinarySnapshot>& snapshot);
+    QJsonObject toJson() const;
+
+    // Ejercicios cuyo historial ya no está mapeado y ocupa memoria propia
+    int materializedCount() const;
+    // Vuelve a apuntar los historiales a un snapshot escrito desde este estado
+    void remap(const QSharedPointer<const BinarySnapshot>& snapshot);
+
+    // Tabla de unidades completa: su orden define los ids que guarda el snapshot
+    QStringList units() const;
+    QJsonObject exerciseToJson(int row) const { return exerciseToJson(m_exercises.at(row)); }
+    QJsonObject exerciseToJson(const Exercise& exercise) const;
+
+    static qint64 parseTimestamp(const QString& text);
+    static QString formatTimestamp(qint64 timestamp);
+
+private:
+    QList<Exercise> m_exercises;
+    QHash<QString, int> m_index;
+    StringPool m_muscleGroups;
+    StringPool m_units{kMaxUnits};
+    QJsonObject m_metadata;
+    QSharedPointer<const BinarySnapshot> m_snapshot; // mantiene vivo el mapeo
+    quint64 m_version = 0;
+    TrainingRollup m_rollup;
+
+    void touch();
+
+    void rebuildIndex(int fromRow);
+    void refreshCurrent(Exercise& exercise) const;
+    double trendOf(const History& history) const;
+    double unitFactor(int unitId) const;
+    void rollupRecord(int muscleGroupId, const Record& record, bool add);
+    void rollupHistory(const Exercise& exercise, bool add);
+};
+
+#endif // EXERCISESTORE_H
@@ -0,0 +1,100 @@
+#include "gzipstream.h"
+#include <algorithm>
+
+namespace {
+constexpr int kChunk = 64 * 1024;
+// 15 bits de ventana + 16: cabecera y pie gzip en vez de zlib
+constexpr int kGzipWindowBits = 15 + 16;
+// + 32: detecta gzip o zlib al descomprimir
+constexpr int kAutoWindowBits = 15 + 32;
+}
+
+GzipWriter::GzipWriter(QIODevice* device, int level) : m_device(device), m_output(kChunk, Qt::Uninitialized) {
+    m_ok = deflateInit2(&m_stream, level, Z_DEFLATED, kGzipWindowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+}
+
+GzipWriter::~GzipWriter() {
+    deflateEnd(&m_stream);
+}
+
+bool GzipWriter::deflateInput(int flush) {
+    int status = Z_OK;
+    do {
+        m_stream.next_out = reinterpret_cast<Bytef*>(m_output.data());
+        m_stream.avail_out = uInt(m_output.size());
+        status = deflate(&m_stream, flush);
+        if (status == Z_STREAM_ERROR)
+            return false;
+
+        const qint64 produced = m_output.size() - qint64(m_stream.avail_out);
+        if (produced > 0 && m_device->write(m_output.constData(), produced) != produced)
+            return false;
+    } while (m_stream.avail_out == 0);
+
+    return flush != Z_FINISH || status == Z_STREAM_END;
+}
+
+bool GzipWriter::write(const char* data, qint64 size) {
+    if (!m_ok || m_finished)
+        return false;
+
+    // avail_in es de 32 bits: bloques grandes se pasan por partes
+    while (size > 0) {
+        const uInt part = uInt(std::min<qint64>(size, kChunk));
+        m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        m_stream.avail_in = part;
+        if (!deflateInput(Z_NO_FLUSH)) {
+            m_ok = false;
+            return false;
+        }
+        data += part;
+        size -= part;
+    }
+    return true;
+}
+
+bool GzipWriter::finish() {
+    if (!m_ok || m_finished)
+        return false;
+
+    m_finished = true;
+    m_stream.next_in = nullptr;
+    m_stream.avail_in = 0;
+    m_ok = deflateInput(Z_FINISH);
+    return m_ok;
+}
+
+bool Gzip::isCompressed(const QByteArray& data) {
+    return data.size() >= 2 && uchar(data.at(0)) == 0x1f && uchar(data.at(1)) == 0x8b;
+}
+
+QByteArray Gzip::uncompress(const QByteArray& data, bool* ok) {
+    QByteArray result;
+    z_stream stream {};
+    bool success = inflateInit2(&stream, kAutoWindowBits) == Z_OK;
+
+    if (success) {
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.constData()));
+        stream.avail_in = uInt(data.size());
+
+        int status = Z_OK;
+        while (status == Z_OK) {
+            const qsizetype offset = result.size();
+            result.resize(offset + kChunk);
+            stream.next_out = reinterpret_cast<Bytef*>(result.data() + offset);
+            stream.avail_out = kChunk;
+            status = inflate(&stream, Z_NO_FLUSH);
+            result.resize(offset + kChunk - qsizetype(stream.avail_out));
+            if (status == Z_BUF_ERROR && stream.avail_in > 0)
+                status = Z_OK; // sólo faltaba sitio en la salida
+        }
+        success = status == Z_STREAM_END;
+        inflateEnd(&stream);
+    }
+
+    if (!success)
+        result.clear();
+    if (ok)
+        *ok = success;
+    return result;
+}
@@ -0,0 +1,40 @@
+#ifndef GZIPSTREAM_H
+#define GZIPSTREAM_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <zlib.h>
+
+// Compresión gzip por bloques sobre un QIODevice: cada write() comprime y
+// escribe lo que puede, así que la memoria no depende del tamaño total. El
+// resultado es un .gz normal que se abre con cualquier descompresor.
+class GzipWriter
+{
+public:
+    explicit GzipWriter(QIODevice* device, int level = Z_DEFAULT_COMPRESSION);
+    ~GzipWriter();
+
+    bool write(const char* data, qint64 size);
+    bool write(const QByteArray& data) { return write(data.constData(), data.size()); }
+    // Vacía lo pendiente y escribe el pie gzip; después no se puede escribir más
+    bool finish();
+
+private:
+    Q_DISABLE_COPY(GzipWriter)
+
+    QIODevice* m_device;
+    z_stream m_stream {};
+    bool m_ok = false;
+    bool m_finished = false;
+    QByteArray m_output;
+
+    bool deflateInput(int flush);
+};
+
+namespace Gzip {
+bool isCompressed(const QByteArray& data);
+// Descomprime un .gz completo (o un flujo zlib); vacío y ok = false si está dañado
+QByteArray uncompress(const QByteArray& data, bool* ok = nullptr);
+}
+
+#endif // GZIPSTREAM_H
@@ -0,0 +1,184 @@
+#include "historyanalytics.h"
+#include "diagnostics.h"
+#include <algorithm>
+
+namespace {
+
+constexpr double kMsPerWeek = 7.0 * 24 * 60 * 60 * 1000;
+constexpr int kLanes = 4;
+
+struct Sums {
+    double weeks = 0;
+    double values = 0;
+    double weeksSquared = 0;
+    double weeksByValues = 0;
+    double volume = 0;
+    double max = 0;
+};
+
+// Sumas de la regresión, volumen y máximo de una serie (n >= 1). Cada magnitud
+// lleva kLanes acumuladores independientes: con uno solo la suma es una cadena
+// de dependencias y el compilador no puede vectorizarla sin -ffast-math
+Sums accumulate(const double* weeks, const double* values, const double* volumes, int n) {
+    double t[kLanes] = {}, v[kLanes] = {}, tt[kLanes] = {}, tv[kLanes] = {}, volume[kLanes] = {};
+    double max[kLanes];
+    std::fill(max, max + kLanes, values[0]);
+
+    int i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (int k = 0; k < kLanes; ++k) {
+            const double week = weeks[i + k];
+            const double value = values[i + k];
+            t[k] += week;
+            v[k] += value;
+            tt[k] += week * week;
+            tv[k] += week * value;
+            volume[k] += volumes[i + k];
+            max[k] = std::max(max[k], value);
+        }
+    }
+    for (; i < n; ++i) {
+        t[0] += weeks[i];
+        v[0] += values[i];
+        tt[0] += weeks[i] * weeks[i];
+        tv[0] += weeks[i] * values[i];
+        volume[0] += volumes[i];
+        max[0] = std::max(max[0], values[i]);
+    }
+
+    Sums sums;
+    sums.max = max[0];
+    for (int k = 0; k < kLanes; ++k) {
+        sums.weeks += t[k];
+        sums.values += v[k];
+        sums.weeksSquared += tt[k];
+        sums.weeksByValues += tv[k];
+        sums.volume += volume[k];
+        sums.max = std::max(sums.max, max[k]);
+    }
+    return sums;
+}
+
+void movingAverage(const double* values, int n, double* result) {
+    constexpr int window = HistoryAnalytics::kMovingAverageWindow;
+    double sum = 0;
+    for (int i = 0; i < n; ++i) {
+        sum += values[i];
+        if (i >= window)
+            sum -= values[i - window];
+        result[i] = sum / std::min(i + 1, window);
+    }
+}
+
+} // namespace
+
+double HistoryAnalytics::unitFactor(const QString& unit) {
+    if (unit.compare(QLatin1String("lb"), Qt::CaseInsensitive) == 0
+        || unit.compare(QLatin1String("lbs"), Qt::CaseInsensitive) == 0)
+        return 0.45359237;
+    return 1.0;
+}
+
+int HistoryAnalytics::gather(const ExerciseStore& store, const double* factors) {
+    int total = 0;
+    for (int row = 0; row < store.count(); ++row)
+        total += store.at(row).history.size();
+
+    m_weeks.resize(total);
+    m_values.resize(total);
+    m_volumes.resize(total);
+    double* weeks = m_weeks.data();
+    double* values = m_values.data();
+    double* volumes = m_volumes.data();
+
+    // Sin unidad (id 0) el valor del gráfico son las repeticiones
+    int offset = 0;
+    for (int row = 0; row < store.count(); ++row) {
+        const ExerciseStore::History& history = store.at(row).history;
+        const int n = history.size();
+        if (n == 0)
+            continue;
+
+        const qint64 origin = history.timestampAt(0);
+        if (history.isMapped()) {
+            const SnapshotRecord* records = history.mapped;
+            for (int i = 0; i < n; ++i) {
+                const SnapshotRecord& record = records[i];
+                const double weight = record.value * factors[record.unitId];
+                weeks[offset + i] = (record.timestamp - origin) / kMsPerWeek;
+                values[offset + i] = record.unitId != 0 ? weight : double(record.repetitions);
+                volumes[offset + i] = weight * record.sets * record.repetitions;
+            }
+        } else {
+            const qint64* timestamps = history.timestamps.constData();
+            const double* raw = history.values.constData();
+            const qint16* sets = history.sets.constData();
+            const qint16* repetitions = history.repetitions.constData();
+            const quint8* unitIds = history.unitIds.constData();
+            for (int i = 0; i < n; ++i) {
+                const double weight = raw[i] * factors[unitIds[i]];
+                weeks[offset + i] = (timestamps[i] - origin) / kMsPerWeek;
+                values[offset + i] = unitIds[i] != 0 ? weight : double(repetitions[i]);
+                volumes[offset + i] = weight * sets[i] * repetitions[i];
+            }
+        }
+        offset += n;
+    }
+    return total;
+}
+
+const HistoryAnalytics::Result& HistoryAnalytics::compute(const ExerciseStore& store) {
+    if (m_result.version == store.version())
+        return m_result;
+
+    ScopedTimer timer("analytics.compute");
+
+    // Los ids de unidad caben en un byte: tabla fija sin comprobar límites
+    double factors[256];
+    std::fill(factors, factors + 256, 1.0);
+    const QStringList units = store.units();
+    for (int id = 0; id < std::min(int(units.size()), 256); ++id)
+        factors[id] = unitFactor(units.at(id));
+
+    const int total = gather(store, factors);
+
+    m_result.exercises.resize(store.count());
+    m_result.movingAverage.resize(total);
+    m_result.totalVolume = 0;
+    m_result.recordCount = total;
+
+    const double* weeks = m_weeks.constData();
+    const double* values = m_values.constData();
+    const double* volumes = m_volumes.constData();
+    double* averages = m_result.movingAverage.data();
+
+    int offset = 0;
+    for (int row = 0; row < store.count(); ++row) {
+        ExerciseResult& result = m_result.exercises[row];
+        result = ExerciseResult();
+        result.offset = offset;
+        const int n = store.at(row).history.size();
+        result.count = n;
+        if (n == 0)
+            continue;
+
+        const Sums sums = accumulate(weeks + offset, values + offset, volumes + offset, n);
+        result.mean = sums.values / n;
+        result.best = sums.max;
+        result.last = values[offset + n - 1];
+        result.volume = sums.volume;
+
+        const double denominator = n * sums.weeksSquared - sums.weeks * sums.weeks;
+        if (n > 1 && !qFuzzyIsNull(denominator))
+            result.slope = (n * sums.weeksByValues - sums.weeks * sums.values) / denominator;
+        result.intercept = (sums.values - result.slope * sums.weeks) / n;
+        result.weeklyChange = result.mean != 0 ? result.slope / result.mean : 0;
+
+        movingAverage(values + offset, n, averages + offset);
+        m_result.totalVolume += sums.volume;
+        offset += n;
+    }
+
+    m_result.version = store.version();
+    return m_result;
+}
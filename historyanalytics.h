@@ -0,0 +1,57 @@
+#ifndef HISTORYANALYTICS_H
+#define HISTORYANALYTICS_H
+
+#include <QList>
+#include "exercisestore.h"
+
+// Análisis de todo el historial de una pasada para el resumen general: media
+// móvil, regresión lineal del valor en el tiempo, volumen y valores
+// normalizados a kg para comparar ejercicios. Primero copia los registros a
+// columnas de trabajo contiguas (ya normalizadas) y luego cada ejercicio se
+// procesa con bucles sin ramas sobre arrays, que el compilador vectoriza.
+//
+// El resultado se guarda junto a la versión del almacén y sólo se recalcula
+// cuando ésta cambia.
+class HistoryAnalytics
+{
+public:
+    static constexpr int kMovingAverageWindow = 5;
+
+    struct ExerciseResult {
+        int offset = 0;            // inicio de su serie en movingAverage
+        int count = 0;
+        double slope = 0;          // por semana, en la unidad normalizada
+        double intercept = 0;      // valor de la recta en el primer registro
+        double mean = 0;
+        double best = 0;
+        double last = 0;
+        double volume = 0;         // valor×series×repeticiones, en kg si hay peso
+        double weeklyChange = 0;   // slope / mean: comparable entre ejercicios
+    };
+
+    struct Result {
+        quint64 version = 0;
+        QList<ExerciseResult> exercises; // misma fila que en el almacén
+        QList<double> movingAverage;     // series de todos los ejercicios seguidas
+        double totalVolume = 0;
+        int recordCount = 0;
+    };
+
+    const Result& compute(const ExerciseStore& store);
+    void invalidate() { m_result.version = 0; }
+
+    // Factor para pasar a kg; 1 para kg y para unidades que no son de peso
+    static double unitFactor(const QString& unit);
+
+private:
+    Result m_result;
+
+    // Columnas de trabajo: se reutilizan entre cálculos
+    QList<double> m_weeks;   // semanas desde el primer registro del ejercicio
+    QList<double> m_values;  // peso normalizado, o repeticiones sin unidad
+    QList<double> m_volumes;
+
+    int gather(const ExerciseStore& store, const double* factors);
+};
+
+#endif // HISTORYANALYTICS_H
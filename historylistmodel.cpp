@@ -0,0 +1,156 @@
+#include "historylistmodel.h"
+#include "historyseriesmodel.h"
+
+HistoryListModel::HistoryListModel(DataCenter* dataCenter, const QString& exerciseName, int period,
+                                   QObject *parent)
+    : QAbstractListModel(parent), m_dataCenter(dataCenter), m_exerciseName(exerciseName), m_period(period) {
+    connect(dataCenter, &DataCenter::recordInserted, this, &HistoryListModel::onRecordInserted);
+    connect(dataCenter, &DataCenter::recordRemoved, this, &HistoryListModel::onRecordRemoved);
+    connect(dataCenter, &DataCenter::historyChanged, this, &HistoryListModel::onHistoryChanged);
+    connect(dataCenter, &DataCenter::exerciseAdded, this, &HistoryListModel::onExercisesMoved);
+    connect(dataCenter, &DataCenter::exerciseRemoved, this, &HistoryListModel::onExercisesMoved);
+    connect(dataCenter, &DataCenter::storeReset, this, &HistoryListModel::reload);
+    reload();
+}
+
+const ExerciseStore::History* HistoryListModel::history() const {
+    if (!m_dataCenter || m_row < 0 || m_row >= m_dataCenter->store().count())
+        return nullptr;
+    return &m_dataCenter->store().at(m_row).history;
+}
+
+void HistoryListModel::reload() {
+    beginResetModel();
+    m_targeted = false;
+    m_row = m_dataCenter ? m_dataCenter->store().indexOf(m_exerciseName) : -1;
+    const ExerciseStore::History* current = history();
+    m_cutoff = HistorySeriesModel::periodCutoff(m_period);
+    m_first = current && m_cutoff != ExerciseStore::kNoTimestamp ? current->lowerBound(m_cutoff) : 0;
+    m_size = current ? current->size() - m_first : 0;
+    // Se conservan las páginas ya cargadas para no perder la posición de la vista
+    m_loaded = qMin(qMax(m_loaded, kPageSize), m_size);
+    endResetModel();
+    emit countChanged();
+}
+
+void HistoryListModel::onExercisesMoved() {
+    // Las filas del almacén se desplazan al añadir o borrar otros ejercicios
+    const int row = m_dataCenter->store().indexOf(m_exerciseName);
+    if ((row >= 0) != (m_row >= 0)) {
+        reload();
+        return;
+    }
+    m_row = row;
+}
+
+void HistoryListModel::onRecordInserted(int row, int index) {
+    if (row != m_row)
+        return;
+
+    m_targeted = true;
+    // Anterior al periodo: sólo desplaza el comienzo de la ventana
+    const ExerciseStore::History* current = history();
+    if (current && index < current->size() && current->timestampAt(index) < m_cutoff) {
+        ++m_first;
+        return;
+    }
+    ++m_size;
+    const int modelRow = historyIndex(index);
+    // Más allá de lo cargado sólo cambia lo que queda por pedir con fetchMore
+    if (modelRow <= m_loaded && modelRow < m_size) {
+        beginInsertRows(QModelIndex(), modelRow, modelRow);
+        ++m_loaded;
+        endInsertRows();
+    }
+    emit countChanged();
+}
+
+void HistoryListModel::onRecordRemoved(int row, int index) {
+    if (row != m_row)
+        return;
+
+    m_targeted = true;
+    if (index < m_first) {
+        --m_first;
+        return;
+    }
+    const int modelRow = historyIndex(index);
+    --m_size;
+    if (modelRow >= 0 && modelRow < m_loaded) {
+        beginRemoveRows(QModelIndex(), modelRow, modelRow);
+        --m_loaded;
+        endRemoveRows();
+    }
+    emit countChanged();
+}
+
+void HistoryListModel::onHistoryChanged(int row) {
+    if (row != m_row)
+        return;
+
+    // Las altas y bajas sueltas ya llegaron por recordInserted/recordRemoved;
+    // cualquier otro cambio (sustituir el ejercicio) recarga
+    const bool targeted = m_targeted;
+    m_targeted = false;
+    const ExerciseStore::History* current = history();
+    if (!targeted || !current || current->size() != m_first + m_size)
+        reload();
+}
+
+int HistoryListModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid())
+        return 0;
+    return m_loaded;
+}
+
+bool HistoryListModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() && m_loaded < m_size;
+}
+
+void HistoryListModel::fetchMore(const QModelIndex& parent) {
+    if (parent.isValid())
+        return;
+
+    const int page = qMin(kPageSize, m_size - m_loaded);
+    if (page <= 0)
+        return;
+
+    beginInsertRows(QModelIndex(), m_loaded, m_loaded + page - 1);
+    m_loaded += page;
+    endInsertRows();
+    emit countChanged();
+}
+
+QVariant HistoryListModel::data(const QModelIndex& index, int role) const {
+    const ExerciseStore::History* current = history();
+    if (!index.isValid() || !current || index.row() >= m_loaded)
+        return QVariant();
+
+    const int i = historyIndex(index.row());
+    if (i < m_first || i >= current->size())
+        return QVariant();
+
+    switch (role) {
+    case DateRole: return ExerciseStore::formatTimestamp(current->timestampAt(i));
+    case TimestampRole: return double(current->timestampAt(i));
+    case WeightRole: return current->valueAt(i);
+    case UnitRole: return m_dataCenter->store().unit(current->unitIdAt(i));
+    case SetsRole: return current->setsAt(i);
+    case RepsRole: return current->repetitionsAt(i);
+    case HistoryIndexRole: return i;
+    default: return QVariant();
+    }
+}
+
+QHash<int, QByteArray> HistoryListModel::roleNames() const {
+    // Mismos nombres que HistorySeriesModel: los usa HistoryDelegate
+    return {
+        {DateRole, "date"},
+        {TimestampRole, "timestamp"},
+        {WeightRole, "weight"},
+        {UnitRole, "unit"},
+        {SetsRole, "sets"},
+        {RepsRole, "reps"},
+        {HistoryIndexRole, "historyIndex"}
+    };
+}
@@ -0,0 +1,79 @@
+#ifndef HISTORYLISTMODEL_H
+#define HISTORYLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include "datacenter.h"
+
+// Historial de un ejercicio para listas (HistoryDialog), del más reciente al
+// más antiguo. No copia nada: cada rol se lee del almacén al pedirlo. Las
+// filas se cargan por páginas con canFetchMore/fetchMore según se desplaza la
+// vista, y las altas y bajas de un registro (DataCenter::recordInserted y
+// recordRemoved) se notifican fila a fila.
+//
+// Con period (meses, como HistorySeriesModel) sólo se ven los registros de
+// ese periodo; el corte se calcula al recargar.
+//
+// Se crean con DataCenter::historyModel(), que guarda uno por ejercicio y
+// periodo y lo comparte entre quienes lo piden.
+class HistoryListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString exerciseName READ exerciseName CONSTANT)
+    Q_PROPERTY(int period READ period CONSTANT)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY countChanged)
+
+public:
+    static constexpr int kPageSize = 50;
+
+    enum Roles {
+        DateRole = Qt::UserRole + 1,
+        TimestampRole,
+        WeightRole,
+        UnitRole,
+        SetsRole,
+        RepsRole,
+        // Posición en el historial cronológico: la que espera removeHistoryEntry
+        HistoryIndexRole
+    };
+
+    HistoryListModel(DataCenter* dataCenter, const QString& exerciseName, int period = 0,
+                     QObject *parent = nullptr);
+
+    QString exerciseName() const { return m_exerciseName; }
+    int period() const { return m_period; }
+    int count() const { return m_loaded; }
+    int totalCount() const { return m_size; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    void countChanged();
+
+private:
+    QPointer<DataCenter> m_dataCenter;
+    QString m_exerciseName;
+    int m_period = 0;
+    int m_row = -1;    // fila del ejercicio en el almacén
+    qint64 m_cutoff = ExerciseStore::kNoTimestamp;
+    int m_first = 0;   // primer registro del periodo en el historial
+    int m_size = 0;    // registros del periodo la última vez que se miró
+    int m_loaded = 0;  // filas ya entregadas a la vista
+    bool m_targeted = false;  // el próximo historyChanged ya se notificó por registro
+
+    const ExerciseStore::History* history() const;
+    int historyIndex(int row) const { return m_first + m_size - 1 - row; }
+
+    void reload();
+    void onExercisesMoved();
+    void onRecordInserted(int row, int index);
+    void onRecordRemoved(int row, int index);
+    void onHistoryChanged(int row);
+};
+
+#endif // HISTORYLISTMODEL_H
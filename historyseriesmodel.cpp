@@ -0,0 +1,319 @@
+#include "historyseriesmodel.h"
+#include "diagnostics.h"
+#include <QDateTime>
+#include <algorithm>
+
+HistorySeriesModel::HistorySeriesModel(QObject *parent) : QAbstractListModel(parent) {}
+
+void HistorySeriesModel::setDataCenter(DataCenter* dataCenter) {
+    if (m_dataCenter == dataCenter)
+        return;
+
+    if (m_dataCenter)
+        disconnect(m_dataCenter, nullptr, this, nullptr);
+
+    m_dataCenter = dataCenter;
+
+    if (m_dataCenter) {
+        connect(m_dataCenter, &DataCenter::historyChanged, this, &HistorySeriesModel::onHistoryChanged);
+        connect(m_dataCenter, &DataCenter::exerciseAdded, this, &HistorySeriesModel::onExercisesMoved);
+        connect(m_dataCenter, &DataCenter::exerciseRemoved, this, &HistorySeriesModel::onExercisesMoved);
+        connect(m_dataCenter, &DataCenter::storeReset, this, &HistorySeriesModel::reload);
+    }
+
+    reload();
+    emit dataCenterChanged();
+}
+
+void HistorySeriesModel::setExerciseName(const QString& name) {
+    if (m_exerciseName == name)
+        return;
+    m_exerciseName = name;
+    reload();
+    emit exerciseNameChanged();
+}
+
+void HistorySeriesModel::setSampleBudget(int points) {
+    // 0 dibuja todo; por debajo de kMinSampleBudget no caben los extremos y un tramo
+    points = points <= 0 ? 0 : std::max(kMinSampleBudget, points);
+    if (m_sampleBudget == points)
+        return;
+    m_sampleBudget = points;
+    updateSample();
+    emit sampleBudgetChanged();
+}
+
+void HistorySeriesModel::setHighlightedRow(int row) {
+    if (m_highlightedRow == row)
+        return;
+    m_highlightedRow = row;
+    updateSample();
+    emit highlightedRowChanged();
+}
+
+void HistorySeriesModel::setPeriod(int months) {
+    if (m_period == months)
+        return;
+    m_period = months;
+    applyWindow(cutoffIndex());
+    emit periodChanged();
+}
+
+const ExerciseStore::Exercise* HistorySeriesModel::exercise() const {
+    if (!m_dataCenter || m_row < 0 || m_row >= m_dataCenter->store().count())
+        return nullptr;
+    return &m_dataCenter->store().at(m_row);
+}
+
+double HistorySeriesModel::chartValue(const ExerciseStore::History& history, int i) const {
+    return m_weighted ? history.valueAt(i) : history.repetitionsAt(i);
+}
+
+qint64 HistorySeriesModel::periodCutoff(int months) {
+    if (months <= 0)
+        return ExerciseStore::kNoTimestamp;
+    return QDateTime::currentDateTime().addMonths(-months).toMSecsSinceEpoch();
+}
+
+int HistorySeriesModel::cutoffIndex() const {
+    const double cutoff = double(periodCutoff(m_period));
+    return int(std::lower_bound(m_timestamps.cbegin(), m_timestamps.cend(), cutoff) - m_timestamps.cbegin());
+}
+
+void HistorySeriesModel::reload() {
+    ScopedTimer timer("series.reload");
+    beginResetModel();
+
+    m_timestamps.clear();
+    m_values.clear();
+    m_sampler.invalidate();
+    m_row = m_dataCenter ? m_dataCenter->store().indexOf(m_exerciseName) : -1;
+
+    if (const ExerciseStore::Exercise* current = exercise()) {
+        const ExerciseStore& store = m_dataCenter->store();
+        const ExerciseStore::History& history = current->history;
+        // Sin unidad ("-") el gráfico muestra repeticiones
+        m_weighted = store.unit(current->unitId) != QLatin1String("-");
+
+        m_timestamps.reserve(history.size());
+        m_values.reserve(history.size());
+        for (int i = 0; i < history.size(); ++i) {
+            m_timestamps.append(double(history.timestampAt(i)));
+            m_values.append(chartValue(history, i));
+        }
+    }
+
+    m_first = cutoffIndex();
+    updateStats();
+    endResetModel();
+    updateSample();
+    emit seriesChanged();
+}
+
+void HistorySeriesModel::onExercisesMoved() {
+    // Las filas del almacén se desplazan al añadir o borrar otros ejercicios
+    const int row = m_dataCenter->store().indexOf(m_exerciseName);
+    if ((row >= 0) != (m_row >= 0)) {
+        reload();
+        return;
+    }
+    m_row = row;
+}
+
+void HistorySeriesModel::onHistoryChanged(int row) {
+    if (row != m_row)
+        return;
+
+    const ExerciseStore::Exercise* current = exercise();
+    if (!current || (m_dataCenter->store().unit(current->unitId) != QLatin1String("-")) != m_weighted) {
+        reload();
+        return;
+    }
+
+    // Cada mutación inserta o borra un único registro: se localiza comparando
+    // con las columnas actuales y sólo se notifica esa fila
+    const ExerciseStore::History& history = current->history;
+    const int oldSize = int(m_timestamps.size());
+    const int newSize = history.size();
+    if (qAbs(newSize - oldSize) != 1) {
+        reload();
+        return;
+    }
+
+    auto same = [&](int oldIndex, int newIndex) {
+        return m_timestamps.at(oldIndex) == double(history.timestampAt(newIndex))
+               && m_values.at(oldIndex) == chartValue(history, newIndex);
+    };
+
+    const int common = std::min(oldSize, newSize);
+    int changed = 0;
+    while (changed < common && same(changed, changed))
+        ++changed;
+
+    const bool inserted = newSize > oldSize;
+    for (int i = changed; i < common; ++i) {
+        if (inserted ? !same(i, i + 1) : !same(i + 1, i)) {
+            reload();
+            return;
+        }
+    }
+
+    // Un registro anterior al corte sólo desplaza el inicio de la ventana
+    const bool appended = inserted && changed == oldSize;
+    const bool inWindow = inserted ? history.timestampAt(changed) >= periodCutoff(m_period) : changed >= m_first;
+    const int windowRow = changed - m_first;
+
+    if (inserted) {
+        if (inWindow) beginInsertRows(QModelIndex(), windowRow, windowRow);
+        m_timestamps.insert(changed, double(history.timestampAt(changed)));
+        m_values.insert(changed, chartValue(history, changed));
+        if (inWindow) endInsertRows();
+        else ++m_first;
+    } else {
+        if (inWindow) beginRemoveRows(QModelIndex(), windowRow, windowRow);
+        m_timestamps.remove(changed);
+        m_values.remove(changed);
+        if (inWindow) endRemoveRows();
+        else --m_first;
+    }
+
+    // Lo habitual es añadir el registro más reciente: los extremos se
+    // actualizan sin recorrer la ventana
+    if (appended) m_sampler.append(m_values);
+    else m_sampler.invalidate();
+
+    if (appended && inWindow && count() > 1) {
+        const double value = m_values.last();
+        m_min = std::min(m_min, value);
+        if (value > m_max) {
+            m_max = value;
+            m_recordIndex = int(m_values.size()) - 1;
+        }
+    } else {
+        updateStats();
+    }
+
+    updateSample();
+    emit seriesChanged();
+}
+
+void HistorySeriesModel::applyWindow(int first) {
+    if (first == m_first)
+        return;
+
+    if (first < m_first) {
+        beginInsertRows(QModelIndex(), 0, m_first - first - 1);
+        m_first = first;
+        endInsertRows();
+    } else {
+        beginRemoveRows(QModelIndex(), 0, first - m_first - 1);
+        m_first = first;
+        endRemoveRows();
+    }
+
+    updateStats();
+    updateSample();
+    emit seriesChanged();
+}
+
+void HistorySeriesModel::updateStats() {
+    m_recordIndex = -1;
+    m_min = 0;
+    m_max = 0;
+    if (count() == 0)
+        return;
+
+    m_recordIndex = m_first;
+    m_min = m_max = m_values.at(m_first);
+    for (int i = m_first + 1; i < m_values.size(); ++i) {
+        const double value = m_values.at(i);
+        m_min = std::min(m_min, value);
+        if (value > m_max) {
+            m_max = value;
+            m_recordIndex = i;
+        }
+    }
+}
+
+void HistorySeriesModel::updateSample() {
+    QList<int> keep = {m_recordIndex};
+    if (m_highlightedRow >= 0 && m_highlightedRow < count())
+        keep.append(m_first + m_highlightedRow);
+
+    QList<int> rows = m_sampler.sample(m_values, m_first, m_sampleBudget, keep);
+    QList<double> timestamps, values;
+    timestamps.reserve(rows.size());
+    values.reserve(rows.size());
+    for (int& index : rows) {
+        timestamps.append(m_timestamps.at(index));
+        values.append(m_values.at(index));
+        index -= m_first;
+    }
+
+    if (rows == m_sampleRows && timestamps == m_sampleTimestamps && values == m_sampleValues)
+        return;
+    m_sampleRows = rows;
+    m_sampleTimestamps = timestamps;
+    m_sampleValues = values;
+    emit sampleChanged();
+}
+
+bool HistorySeriesModel::hasDataForPeriod(int months) const {
+    if (months <= 0)
+        return true;
+    return !m_timestamps.isEmpty() && m_timestamps.last() >= double(periodCutoff(months));
+}
+
+int HistorySeriesModel::lowerBound(double timestamp) const {
+    const auto begin = m_timestamps.cbegin() + m_first;
+    return int(std::lower_bound(begin, m_timestamps.cend(), timestamp) - begin);
+}
+
+QVariantMap HistorySeriesModel::get(int row) const {
+    const QHash<int, QByteArray> roles = roleNames();
+    QVariantMap item;
+    for (auto it = roles.cbegin(); it != roles.cend(); ++it)
+        item.insert(QString::fromLatin1(it.value()), data(index(row), it.key()));
+    return item;
+}
+
+int HistorySeriesModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid())
+        return 0;
+    return count();
+}
+
+QVariant HistorySeriesModel::data(const QModelIndex& index, int role) const {
+    const ExerciseStore::Exercise* current = exercise();
+    if (!index.isValid() || !current || index.row() >= count())
+        return QVariant();
+
+    const int i = m_first + index.row();
+    const ExerciseStore::History& history = current->history;
+    if (i >= history.size())
+        return QVariant();
+
+    switch (role) {
+    case DateRole: return ExerciseStore::formatTimestamp(history.timestampAt(i));
+    case TimestampRole: return m_timestamps.at(i);
+    case WeightRole: return history.valueAt(i);
+    case UnitRole: return m_dataCenter->store().unit(history.unitIdAt(i));
+    case SetsRole: return history.setsAt(i);
+    case RepsRole: return history.repetitionsAt(i);
+    case ValueRole: return m_values.at(i);
+    default: return QVariant();
+    }
+}
+
+QHash<int, QByteArray> HistorySeriesModel::roleNames() const {
+    // Mismos nombres que el ListModel que usaba GraphPage (HistoryDelegate)
+    return {
+        {DateRole, "date"},
+        {TimestampRole, "timestamp"},
+        {WeightRole, "weight"},
+        {UnitRole, "unit"},
+        {SetsRole, "sets"},
+        {RepsRole, "reps"},
+        {ValueRole, "value"}
+    };
+}
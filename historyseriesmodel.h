@@ -0,0 +1,148 @@
+#ifndef HISTORYSERIESMODEL_H
+#define HISTORYSERIESMODEL_H
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include "datacenter.h"
+#include "seriesdownsampler.h"
+
+// Historial de un ejercicio para GraphPage. Guarda las fechas (ms desde epoch)
+// y los valores del gráfico (peso, o repeticiones si el ejercicio no tiene
+// unidad) en columnas contiguas ordenadas cronológicamente. Las filas del
+// modelo son la ventana del periodo seleccionado: el corte se busca con una
+// búsqueda binaria y los extremos de la ventana se calculan al cambiar los
+// datos, no en cada repintado. Sigue los cambios de ese ejercicio en
+// DataCenter insertando o borrando sólo la fila afectada.
+//
+// Para dibujar, sample* es la ventana reducida a sampleBudget puntos
+// (SeriesDownsampler); el récord y la fila resaltada siempre están incluidos.
+class HistorySeriesModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(DataCenter* dataCenter READ dataCenter WRITE setDataCenter NOTIFY dataCenterChanged)
+    Q_PROPERTY(QString exerciseName READ exerciseName WRITE setExerciseName NOTIFY exerciseNameChanged)
+    // Meses hacia atrás desde hoy; 0 = todo el historial
+    Q_PROPERTY(int period READ period WRITE setPeriod NOTIFY periodChanged)
+    Q_PROPERTY(int count READ count NOTIFY seriesChanged)
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY seriesChanged)
+    Q_PROPERTY(bool weighted READ isWeighted NOTIFY seriesChanged)
+    // Ventana actual, listas para leerlas una vez por repintado
+    Q_PROPERTY(QList<double> timestamps READ timestamps NOTIFY seriesChanged)
+    Q_PROPERTY(QList<double> values READ values NOTIFY seriesChanged)
+    Q_PROPERTY(double minValue READ minValue NOTIFY seriesChanged)
+    Q_PROPERTY(double maxValue READ maxValue NOTIFY seriesChanged)
+    Q_PROPERTY(double firstValue READ firstValue NOTIFY seriesChanged)
+    Q_PROPERTY(double lastValue READ lastValue NOTIFY seriesChanged)
+    Q_PROPERTY(double firstTimestamp READ firstTimestamp NOTIFY seriesChanged)
+    Q_PROPERTY(double lastTimestamp READ lastTimestamp NOTIFY seriesChanged)
+    // Primer registro con el valor máximo de la ventana
+    Q_PROPERTY(double recordTimestamp READ recordTimestamp NOTIFY seriesChanged)
+    // Puntos que caben en el gráfico; 0 = sin reducir
+    Q_PROPERTY(int sampleBudget READ sampleBudget WRITE setSampleBudget NOTIFY sampleBudgetChanged)
+    Q_PROPERTY(int highlightedRow READ highlightedRow WRITE setHighlightedRow NOTIFY highlightedRowChanged)
+    Q_PROPERTY(QList<int> sampleRows READ sampleRows NOTIFY sampleChanged)
+    Q_PROPERTY(QList<double> sampleTimestamps READ sampleTimestamps NOTIFY sampleChanged)
+    Q_PROPERTY(QList<double> sampleValues READ sampleValues NOTIFY sampleChanged)
+
+public:
+    // Menos puntos no dejan sitio a los extremos de la ventana y un tramo
+    static constexpr int kMinSampleBudget = 6;
+
+    enum Roles {
+        DateRole = Qt::UserRole + 1,
+        TimestampRole,
+        WeightRole,
+        UnitRole,
+        SetsRole,
+        RepsRole,
+        ValueRole
+    };
+
+    explicit HistorySeriesModel(QObject *parent = nullptr);
+
+    DataCenter* dataCenter() const { return m_dataCenter; }
+    void setDataCenter(DataCenter* dataCenter);
+    QString exerciseName() const { return m_exerciseName; }
+    void setExerciseName(const QString& name);
+    int period() const { return m_period; }
+    void setPeriod(int months);
+
+    int count() const { return int(m_timestamps.size()) - m_first; }
+    int totalCount() const { return int(m_timestamps.size()); }
+    bool isWeighted() const { return m_weighted; }
+
+    QList<double> timestamps() const { return m_timestamps.mid(m_first); }
+    QList<double> values() const { return m_values.mid(m_first); }
+    double minValue() const { return m_min; }
+    double maxValue() const { return m_max; }
+    double firstValue() const { return count() > 0 ? m_values.at(m_first) : 0; }
+    double lastValue() const { return count() > 0 ? m_values.last() : 0; }
+    double firstTimestamp() const { return count() > 0 ? m_timestamps.at(m_first) : 0; }
+    double lastTimestamp() const { return count() > 0 ? m_timestamps.last() : 0; }
+    double recordTimestamp() const { return m_recordIndex >= 0 ? m_timestamps.at(m_recordIndex) : 0; }
+
+    int sampleBudget() const { return m_sampleBudget; }
+    void setSampleBudget(int points);
+    int highlightedRow() const { return m_highlightedRow; }
+    void setHighlightedRow(int row);
+    QList<int> sampleRows() const { return m_sampleRows; }
+    QList<double> sampleTimestamps() const { return m_sampleTimestamps; }
+    QList<double> sampleValues() const { return m_sampleValues; }
+
+    // O(1): el historial está ordenado, basta con mirar el último registro
+    Q_INVOKABLE bool hasDataForPeriod(int months) const;
+    // Primera fila de la ventana con fecha >= timestamp (count si no hay)
+    Q_INVOKABLE int lowerBound(double timestamp) const;
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    static qint64 periodCutoff(int months);
+
+signals:
+    void dataCenterChanged();
+    void exerciseNameChanged();
+    void periodChanged();
+    void seriesChanged();
+    void sampleBudgetChanged();
+    void highlightedRowChanged();
+    void sampleChanged();
+
+private:
+    QPointer<DataCenter> m_dataCenter;
+    QString m_exerciseName;
+    int m_period = 0;
+    int m_row = -1; // fila del ejercicio en el almacén
+
+    // Historial completo; las filas del modelo empiezan en m_first
+    QList<double> m_timestamps;
+    QList<double> m_values;
+    bool m_weighted = true;
+    int m_first = 0;
+
+    double m_min = 0;
+    double m_max = 0;
+    int m_recordIndex = -1;
+
+    SeriesDownsampler m_sampler;
+    int m_sampleBudget = 0;
+    int m_highlightedRow = -1;
+    QList<int> m_sampleRows; // filas de la ventana
+    QList<double> m_sampleTimestamps;
+    QList<double> m_sampleValues;
+
+    const ExerciseStore::Exercise* exercise() const;
+    double chartValue(const ExerciseStore::History& history, int i) const;
+    int cutoffIndex() const;
+
+    void reload();
+    void onHistoryChanged(int row);
+    void onExercisesMoved();
+    void applyWindow(int first);
+    void updateStats();
+    void updateSample();
+};
+
+#endif // HISTORYSERIESMODEL_H
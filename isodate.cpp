@@ -0,0 +1,255 @@
+#include "isodate.h"
+#include <QDate>
+#include <QDateTime>
+#include <QTime>
+#include <array>
+#include <limits>
+
+namespace {
+
+constexpr qint64 kMsecsPerDay = 86400000;
+constexpr int kUnknownOffset = std::numeric_limits<int>::min();
+
+// Días desde 1970-01-01 de una fecha del calendario gregoriano y viceversa
+// (algoritmos de Howard Hinnant, sin tablas ni bucles)
+qint64 daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    const qint64 era = (year >= 0 ? year : year - 399) / 400;
+    const int yoe = int(year - era * 400);
+    const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void civilFromDays(qint64 days, int* year, int* month, int* day) {
+    days += 719468;
+    const qint64 era = (days >= 0 ? days : days - 146096) / 146097;
+    const int doe = int(days - era * 146097);
+    const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int mp = (5 * doy + 2) / 153;
+    *day = doy - (153 * mp + 2) / 5 + 1;
+    *month = mp < 10 ? mp + 3 : mp - 9;
+    *year = int(yoe + era * 400) + (*month <= 2);
+}
+
+qint64 floorDiv(qint64 a, qint64 b) {
+    return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+int daysInMonth(int year, int month) {
+    static constexpr int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month == 2 && (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)))
+        return 29;
+    return days[month - 1];
+}
+
+// Caché de desfases locales por mes. Si el desfase al principio y al final
+// del mes coincide se considera constante todo el mes; si no, el mes tiene un
+// cambio de horario y se marca como desconocido.
+class OffsetCache
+{
+public:
+    int offset(qint64 monthKey, bool localMonth) {
+        Entry& entry = m_entries[size_t(monthKey) % m_entries.size()];
+        if (entry.key != monthKey || entry.local != localMonth) {
+            entry.key = monthKey;
+            entry.local = localMonth;
+            entry.offset = compute(monthKey, localMonth);
+        }
+        return entry.offset;
+    }
+
+private:
+    struct Entry {
+        qint64 key = std::numeric_limits<qint64>::min();
+        bool local = false;
+        int offset = kUnknownOffset;
+    };
+    std::array<Entry, 16> m_entries;
+
+    static int compute(qint64 monthKey, bool localMonth) {
+        const int year = int(floorDiv(monthKey, 12));
+        const int month = int(monthKey - qint64(year) * 12) + 1;
+        const QDate first(year, month, 1);
+        const QDate next = first.addMonths(1);
+
+        int start, end;
+        if (localMonth) {
+            start = first.startOfDay().offsetFromUtc();
+            end = next.startOfDay().offsetFromUtc();
+        } else {
+            start = QDateTime::fromMSecsSinceEpoch(daysFromCivil(year, month, 1) * kMsecsPerDay).offsetFromUtc();
+            end = QDateTime::fromMSecsSinceEpoch(daysFromCivil(next.year(), next.month(), 1) * kMsecsPerDay - 1).offsetFromUtc();
+        }
+        return start == end ? start : kUnknownOffset;
+    }
+};
+
+OffsetCache& offsetCache() {
+    thread_local OffsetCache cache;
+    return cache;
+}
+
+template <typename Char>
+bool parseImpl(const Char* s, qsizetype n, qint64* msecs) {
+    qsizetype pos = 0;
+    auto number = [&](int count, int* out) {
+        int value = 0;
+        for (int k = 0; k < count; ++k, ++pos) {
+            if (pos >= n || s[pos] < '0' || s[pos] > '9')
+                return false;
+            value = value * 10 + int(s[pos] - '0');
+        }
+        *out = value;
+        return true;
+    };
+    auto accept = [&](char c) {
+        if (pos < n && s[pos] == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    };
+
+    int year, month, day;
+    if (!number(4, &year) || !accept('-') || !number(2, &month) || !accept('-') || !number(2, &day))
+        return false;
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month))
+        return false;
+
+    int hour = 0, minute = 0, second = 0, millis = 0;
+    if (pos < n && (s[pos] == 'T' || s[pos] == ' ')) {
+        ++pos;
+        if (!number(2, &hour) || !accept(':') || !number(2, &minute))
+            return false;
+        if (accept(':') && !number(2, &second))
+            return false;
+        if (accept('.') || accept(',')) {
+            // Se usan los tres primeros decimales y se ignoran el resto
+            int digits = 0;
+            while (pos < n && s[pos] >= '0' && s[pos] <= '9') {
+                if (digits < 3)
+                    millis = millis * 10 + int(s[pos] - '0');
+                ++digits;
+                ++pos;
+            }
+            if (digits == 0)
+                return false;
+            for (; digits < 3; ++digits)
+                millis *= 10;
+        }
+        if (hour > 23 || minute > 59 || second > 59)
+            return false;
+    }
+
+    const qint64 wall = daysFromCivil(year, month, day) * kMsecsPerDay
+                        + ((hour * 60 + minute) * 60 + second) * 1000LL + millis;
+
+    if (pos == n) {
+        // Hora local
+        const int offset = offsetCache().offset(qint64(year) * 12 + month - 1, true);
+        if (offset == kUnknownOffset) {
+            *msecs = QDateTime(QDate(year, month, day), QTime(hour, minute, second, millis)).toMSecsSinceEpoch();
+        } else {
+            *msecs = wall - offset * 1000LL;
+        }
+        return true;
+    }
+
+    if (accept('Z')) {
+        *msecs = wall;
+        return pos == n;
+    }
+
+    int sign = 0;
+    if (accept('+'))
+        sign = 1;
+    else if (accept('-'))
+        sign = -1;
+    else
+        return false;
+
+    int offsetHours = 0, offsetMinutes = 0;
+    if (!number(2, &offsetHours))
+        return false;
+    if (pos < n) {
+        accept(':');
+        if (!number(2, &offsetMinutes))
+            return false;
+    }
+    if (pos != n || offsetHours > 23 || offsetMinutes > 59)
+        return false;
+
+    *msecs = wall - sign * (offsetHours * 3600 + offsetMinutes * 60) * 1000LL;
+    return true;
+}
+
+template <typename Char>
+int formatImpl(qint64 msecs, Char* out) {
+    const qint64 utcDays = floorDiv(msecs, kMsecsPerDay);
+    int year, month, day;
+    civilFromDays(utcDays, &year, &month, &day);
+
+    int offset = offsetCache().offset(qint64(year) * 12 + month - 1, false);
+    if (offset == kUnknownOffset)
+        offset = QDateTime::fromMSecsSinceEpoch(msecs).offsetFromUtc();
+
+    const qint64 local = msecs + offset * 1000LL;
+    const qint64 days = floorDiv(local, kMsecsPerDay);
+    const qint64 msOfDay = local - days * kMsecsPerDay;
+    civilFromDays(days, &year, &month, &day);
+    if (year < 0 || year > 9999)
+        return 0;
+
+    const int seconds = int(msOfDay / 1000);
+    auto put = [&out](int pos, int value, int width) {
+        for (int k = width - 1; k >= 0; --k) {
+            out[pos + k] = Char('0' + value % 10);
+            value /= 10;
+        }
+    };
+
+    put(0, year, 4);
+    out[4] = Char('-');
+    put(5, month, 2);
+    out[7] = Char('-');
+    put(8, day, 2);
+    out[10] = Char('T');
+    put(11, seconds / 3600, 2);
+    out[13] = Char(':');
+    put(14, seconds / 60 % 60, 2);
+    out[16] = Char(':');
+    put(17, seconds % 60, 2);
+    return IsoDate::kFormattedLength;
+}
+
+} // namespace
+
+namespace IsoDate {
+
+bool parse(QStringView text, qint64* msecs) {
+    return parseImpl(text.utf16(), text.size(), msecs);
+}
+
+bool parse(QLatin1StringView text, qint64* msecs) {
+    return parseImpl(text.data(), text.size(), msecs);
+}
+
+int format(qint64 msecs, char16_t* out) {
+    return formatImpl(msecs, out);
+}
+
+int format(qint64 msecs, char* out) {
+    return formatImpl(msecs, out);
+}
+
+QString format(qint64 msecs) {
+    char16_t buffer[kFormattedLength];
+    const int length = formatImpl(msecs, buffer);
+    if (length == 0)
+        return QDateTime::fromMSecsSinceEpoch(msecs).toString(Qt::ISODate);
+    return QString(reinterpret_cast<const QChar*>(buffer), length);
+}
+
+} // namespace IsoDate
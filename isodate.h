@@ -0,0 +1,31 @@
+#ifndef ISODATE_H
+#define ISODATE_H
+
+#include <QString>
+#include <QStringView>
+
+// Conversión rápida entre fechas ISO-8601 y milisegundos desde epoch, sin
+// reservar memoria. Entiende lo que genera QDateTime::toString(Qt::ISODate):
+//
+//   yyyy-MM-dd[Thh:mm[:ss[.zzz]]][Z|±hh[:]mm]
+//
+// Sin zona se interpreta como hora local, igual que QDateTime. El desfase
+// local se cachea por mes; los meses con cambio de horario se resuelven con
+// QDateTime.
+namespace IsoDate {
+
+// "yyyy-MM-ddThh:mm:ss"
+constexpr int kFormattedLength = 19;
+
+bool parse(QStringView text, qint64* msecs);
+bool parse(QLatin1StringView text, qint64* msecs);
+
+// Escribe la fecha local en out (al menos kFormattedLength caracteres) y
+// devuelve la longitud escrita
+int format(qint64 msecs, char16_t* out);
+int format(qint64 msecs, char* out);
+QString format(qint64 msecs);
+
+} // namespace IsoDate
+
+#endif // ISODATE_H
@@ -0,0 +1,7 @@
+#include "logging.h"
+
+Q_LOGGING_CATEGORY(lcData, "gymweights.data")
+Q_LOGGING_CATEGORY(lcPersistence, "gymweights.persistence")
+Q_LOGGING_CATEGORY(lcModel, "gymweights.model")
+Q_LOGGING_CATEGORY(lcCatalog, "gymweights.catalog")
+Q_LOGGING_CATEGORY(lcStartup, "gymweights.startup")
@@ -0,0 +1,16 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+
+// Categorías de log de la app. Los qCDebug desaparecen en las compilaciones
+// que no son Debug (QT_NO_DEBUG_OUTPUT, ver CMakeLists.txt); qCWarning se
+// mantiene siempre. En Debug se pueden filtrar con QT_LOGGING_RULES, p.ej.
+// "gymweights.model.debug=false".
+Q_DECLARE_LOGGING_CATEGORY(lcData)
+Q_DECLARE_LOGGING_CATEGORY(lcPersistence)
+Q_DECLARE_LOGGING_CATEGORY(lcModel)
+Q_DECLARE_LOGGING_CATEGORY(lcCatalog)
+Q_DECLARE_LOGGING_CATEGORY(lcStartup)
+
+#endif // LOGGING_H
@@ -1,8 +1,15 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include "datacenter.h"
+#include "diagnostics.h"
+#include "exercisefiltermodel.h"
 #include "exercisemodel.h"
 #include "exerciseprovider.h"
+#include "exercisesearchmodel.h"
+#include "historyseriesmodel.h"
+#include "progresschart.h"
+#include "startupprofiler.h"
+#include <QQuickWindow>
 #include <QTimer>
 #ifdef Q_OS_ANDROID
 #include <QJniObject>
@@ -11,7 +18,10 @@
 
 int main(int argc, char *argv[])
 {
+    // Se crea antes que nada para medir el arranque completo
+    StartupProfiler startupProfiler;
     QGuiApplication app(argc, argv);
+    Diagnostics::instance(); // se crea en el hilo principal
 
 #ifdef Q_OS_ANDROID
     QTimer::singleShot(300, []() {
@@ -38,11 +48,28 @@ int main(int argc, char *argv[])
 
     // Registra los tipos para poder crearlos desde QML
     qmlRegisterType<ExerciseModel>("gymWeights", 1, 0, "ExerciseModel");
+    qmlRegisterType<ExerciseFilterModel>("gymWeights", 1, 0, "ExerciseFilterModel");
     qmlRegisterType<DataCenter>("gymWeights", 1, 0, "DataCenter");
     qmlRegisterType<ExerciseProvider>("gymWeights", 1, 0, "ExerciseProvider");
+    qmlRegisterType<ExerciseSearchModel>("gymWeights", 1, 0, "ExerciseSearchModel");
+    qmlRegisterType<HistorySeriesModel>("gymWeights", 1, 0, "HistorySeriesModel");
+    qmlRegisterType<ProgressChart>("gymWeights", 1, 0, "ProgressChart");
+    qmlRegisterSingletonInstance("gymWeights", 1, 0, "StartupProfiler", &startupProfiler);
+    qmlRegisterSingletonInstance("gymWeights", 1, 0, "Diagnostics", Diagnostics::instance());
 
     QQmlApplicationEngine engine;
+    startupProfiler.mark("engineCreated");
+
     engine.loadFromModule("gymWeights", "Main");
+    startupProfiler.mark("qmlLoaded");
+
+    if (!engine.rootObjects().isEmpty()) {
+        if (auto* window = qobject_cast<QQuickWindow*>(engine.rootObjects().constFirst())) {
+            QObject::connect(window, &QQuickWindow::frameSwapped, &startupProfiler, [&startupProfiler]() {
+                startupProfiler.mark("firstFrame");
+            }, Qt::SingleShotConnection);
+        }
+    }
 
     return app.exec();
 }
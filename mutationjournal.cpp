@@ -0,0 +1,209 @@
+#include "mutationjournal.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include "logging.h"
+#include <array>
+#ifdef Q_OS_WIN
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Tabla CRC-32 (polinomio IEEE 802.3), generada en tiempo de compilación
+constexpr std::array<quint32, 256> makeCrcTable() {
+    std::array<quint32, 256> table {};
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 c = i;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[i] = c;
+    }
+    return table;
+}
+
+constexpr auto kCrcTable = makeCrcTable();
+
+QByteArray encodeRecord(const QJsonObject& record) {
+    const QByteArray payload = QJsonDocument(record).toJson(QJsonDocument::Compact);
+    return QByteArray::number(MutationJournal::checksum(payload), 16).rightJustified(8, '0')
+           + ' ' + payload + '\n';
+}
+
+// QFile::flush() sólo pasa los datos al sistema operativo
+bool syncToDisk(QFile& file) {
+#ifdef Q_OS_WIN
+    return FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(file.handle())));
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+} // namespace
+
+MutationJournal::MutationJournal(const QString& filePath)
+    : m_filePath(filePath), m_file(filePath) {}
+
+quint32 MutationJournal::checksum(const QByteArray& data) {
+    quint32 crc = 0xFFFFFFFFu;
+    for (const char byte : data)
+        crc = kCrcTable[(crc ^ static_cast<quint8>(byte)) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+qint64 MutationJournal::size() const {
+    return QFileInfo(m_filePath).size();
+}
+
+bool MutationJournal::ensureOpen() {
+    if (m_file.isOpen())
+        return true;
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(lcPersistence) << "MutationJournal: no se pudo abrir" << m_filePath << m_file.errorString();
+        return false;
+    }
+    if (m_file.size() == 0) {
+        m_entries.clear();
+        m_tracked = true;
+    }
+    return true;
+}
+
+bool MutationJournal::append(const QJsonObject& record) {
+    if (!ensureOpen())
+        return false;
+
+    const QByteArray line = encodeRecord(record);
+    if (m_file.write(line) != line.size()) {
+        qCWarning(lcPersistence) << "MutationJournal: escritura incompleta en" << m_filePath;
+        return false;
+    }
+    if (!m_file.flush() || !syncToDisk(m_file)) {
+        qCWarning(lcPersistence) << "MutationJournal: no se pudo sincronizar" << m_filePath;
+        return false;
+    }
+    m_entries.append({record["seq"].toInteger(), m_file.size()});
+    return true;
+}
+
+QList<QJsonObject> MutationJournal::readAll(qint64 afterSequence) const {
+    QList<QJsonObject> records;
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return records;
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+
+        // Una línea sin '\n' final es una escritura interrumpida
+        if (!line.endsWith('\n') || line.size() < 10 || line.at(8) != ' ') {
+            qCWarning(lcPersistence) << "MutationJournal: registro incompleto, se descarta el resto del diario";
+            break;
+        }
+
+        bool ok = false;
+        const quint32 expected = line.left(8).toUInt(&ok, 16);
+        const QByteArray payload = line.mid(9, line.size() - 10);
+        if (!ok || checksum(payload) != expected) {
+            qCWarning(lcPersistence) << "MutationJournal: checksum incorrecto, se descarta el resto del diario";
+            break;
+        }
+
+        const QJsonDocument doc = QJsonDocument::fromJson(payload);
+        if (!doc.isObject())
+            break;
+
+        const QJsonObject record = doc.object();
+        if (record["seq"].toInteger() > afterSequence)
+            records.append(record);
+    }
+
+    return records;
+}
+
+bool MutationJournal::discardUpTo(qint64 sequence) {
+    // Registros de una sesión anterior: se leen y se reescriben una vez
+    if (!m_tracked)
+        return rewriteAfter(sequence);
+
+    int first = 0;
+    while (first < m_entries.size() && m_entries.at(first).sequence <= sequence)
+        ++first;
+    if (first == 0)
+        return true;
+    if (first == m_entries.size())
+        return truncate();
+    if (m_entries.at(first - 1).end < kCompactSize)
+        return true;
+    return compactFrom(first);
+}
+
+bool MutationJournal::truncate() {
+    if (!ensureOpen() || !m_file.resize(0) || !syncToDisk(m_file))
+        return false;
+    m_entries.clear();
+    m_tracked = true;
+    return true;
+}
+
+bool MutationJournal::rewriteAfter(qint64 sequence) {
+    const QList<QJsonObject> remaining = readAll(sequence);
+    if (remaining.isEmpty())
+        return truncate();
+
+    m_file.close();
+
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QList<Entry> entries;
+    qint64 end = 0;
+    for (const QJsonObject& record : remaining) {
+        const QByteArray line = encodeRecord(record);
+        file.write(line);
+        end += line.size();
+        entries.append({record["seq"].toInteger(), end});
+    }
+    if (!file.commit())
+        return false;
+
+    m_entries = entries;
+    m_tracked = true;
+    return true;
+}
+
+bool MutationJournal::compactFrom(int first) {
+    // Sólo se copia la cola, sin interpretarla: son los registros que llegaron
+    // mientras se escribía el snapshot
+    const qint64 offset = m_entries.at(first - 1).end;
+    QFile source(m_filePath);
+    if (!source.open(QIODevice::ReadOnly) || !source.seek(offset))
+        return false;
+    const QByteArray tail = source.readAll();
+    source.close();
+
+    m_file.close();
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(tail) != tail.size() || !file.commit())
+        return false;
+
+    m_entries.remove(0, first);
+    for (Entry& entry : m_entries)
+        entry.end -= offset;
+    return true;
+}
+
+void MutationJournal::clear() {
+    m_file.close();
+    QFile::remove(m_filePath);
+    m_entries.clear();
+    m_tracked = true;
+}
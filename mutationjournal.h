@@ -0,0 +1,54 @@
+#ifndef MUTATIONJOURNAL_H
+#define MUTATIONJOURNAL_H
+
+#include <QFile>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+// Diario de mutaciones (write-ahead log) que acompaña al snapshot de datos.
+// Cada línea es "<crc32 hex> <json compacto>\n"; al leer se descarta la cola
+// a partir del primer registro corrupto o incompleto (escritura cortada).
+// append() no vuelve hasta que el registro está en disco (fsync), así que un
+// cambio confirmado sobrevive a un corte de corriente.
+class MutationJournal
+{
+public:
+    explicit MutationJournal(const QString& filePath);
+
+    QString filePath() const { return m_filePath; }
+    qint64 size() const;
+
+    bool append(const QJsonObject& record);
+    QList<QJsonObject> readAll(qint64 afterSequence = 0) const;
+
+    // Descarta los registros hasta sequence. Lo normal es que no quede ninguno
+    // y el fichero se trunca; si quedan se dejan (readAll filtra por secuencia)
+    // hasta que lo descartable pasa de kCompactSize y se copia sólo la cola
+    bool discardUpTo(qint64 sequence);
+    void clear();
+
+    static quint32 checksum(const QByteArray& data);
+
+    static constexpr qint64 kCompactSize = 1 << 20;
+
+private:
+    struct Entry {
+        qint64 sequence;
+        qint64 end;     // posición tras el registro
+    };
+
+    QString m_filePath;
+    QFile m_file;
+    // Registros escritos desde que el fichero se vació; si tiene registros de
+    // una sesión anterior no se sabe dónde acaba cada uno (m_tracked = false)
+    QList<Entry> m_entries;
+    bool m_tracked = false;
+
+    bool ensureOpen();
+    bool truncate();
+    bool rewriteAfter(qint64 sequence);
+    bool compactFrom(int first);
+};
+
+#endif // MUTATIONJOURNAL_H
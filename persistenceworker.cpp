@@ -0,0 +1,142 @@
+#include "persistenceworker.h"
+#include "diagnostics.h"
+#include "logging.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <utility>
+
+PersistenceWorker::PersistenceWorker(StorageBackend::Kind kind, const QString& directory)
+    : m_directory(directory), m_backend(StorageBackend::create(kind, directory)) {}
+
+PersistenceWorker::LoadResult PersistenceWorker::load(const QString& legacyPath) {
+    ScopedTimer timer("persistence.load");
+    emit loadProgress(0.1);
+
+    LoadResult result = m_backend->load();
+    const bool found = result.snapshotFound || !result.journal.isEmpty();
+
+    // Sin datos en el motor elegido se buscan en los demás. Si los tiene, los
+    // otros no se tocan: la elección (QSettings) puede ir por detrás de la
+    // última migración, que ya borró el motor del que venía
+    for (const StorageBackend::Kind kind : StorageBackend::kinds()) {
+        if (found)
+            break;
+        if (kind == m_backend->kind())
+            continue;
+        std::unique_ptr<StorageBackend> other = StorageBackend::create(kind, m_directory);
+        if (!other->exists())
+            continue;
+
+        // Se cambió de motor (o se eligió antes de que existieran sus datos): se migra
+        const LoadResult previous = other->load();
+        if (!previous.snapshotFound && previous.journal.isEmpty())
+            continue;
+        result = previous;
+        if (adopt(previous)) {
+            qCDebug(lcPersistence) << "load() - datos migrados de" << StorageBackend::kindName(kind)
+                                   << "a" << StorageBackend::kindName(m_backend->kind());
+        } else {
+            qCWarning(lcPersistence) << "load() - no se pudo migrar a" << StorageBackend::kindName(m_backend->kind())
+                                     << "; se sigue usando" << StorageBackend::kindName(kind);
+            m_backend = std::move(other);
+        }
+        break;
+    }
+
+    if (!result.snapshotFound && result.journal.isEmpty() && migrateLegacyJson(legacyPath, &result))
+        qCDebug(lcPersistence) << "load() -" << result.store.count() << "ejercicios migrados desde exercises.json";
+    emit backendChanged(m_backend->kind());
+    emit loadProgress(0.9);
+
+    return result;
+}
+
+bool PersistenceWorker::adopt(const LoadResult& result) {
+    if (!m_backend->writeSnapshot(result.store, result.sequence))
+        return false;
+
+    // DataCenter reproduce después los mismos registros sobre el almacén
+    for (const QJsonObject& record : result.journal) {
+        if (!m_backend->append(record))
+            return false;
+    }
+    return true;
+}
+
+bool PersistenceWorker::migrateLegacyJson(const QString& legacyPath, LoadResult* result) {
+    QFile file(legacyPath);
+    if (!file.exists() || !file.open(QIODevice::ReadOnly))
+        return false;
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+
+    if (doc.isNull() || !doc.isObject() || !doc.object()["exercises"].isObject())
+        return false;
+
+    // Se ordena el historial y se recalculan los valores actuales de cada ejercicio
+    result->store = ExerciseStore::fromJson(doc.object());
+    result->sequence = result->store.metadata().value("journalSequence").toInteger();
+    result->store.removeMetadata("journalSequence");
+
+    // El diario se aplica después sobre este estado, así que el snapshot
+    // conserva la secuencia del JSON. El JSON original se guarda como copia.
+    if (m_backend->writeSnapshot(result->store, result->sequence)) {
+        result->snapshotFound = true;
+        QFile::remove(legacyPath + ".bak");
+        QFile::rename(legacyPath, legacyPath + ".bak");
+    }
+
+    return true;
+}
+
+void PersistenceWorker::appendMutation(const QJsonObject& record) {
+    ScopedTimer timer("persistence.journalAppend");
+    // Sin diario no hay garantía de persistencia: DataCenter adelantará el snapshot
+    if (!m_backend->append(record))
+        emit journalAppendFailed();
+}
+
+bool PersistenceWorker::writeSnapshot(const ExerciseStore& store, qint64 sequence) {
+    ScopedTimer scopedTimer("persistence.snapshot");
+    QElapsedTimer timer;
+    timer.start();
+
+    const bool ok = m_backend->writeSnapshot(store, sequence);
+    if (!ok)
+        qCWarning(lcPersistence) << "PersistenceWorker: no se pudo escribir el snapshot";
+
+    emit snapshotWritten(sequence, timer.elapsed(), ok);
+    return ok;
+}
+
+bool PersistenceWorker::clear() {
+    return m_backend->clear();
+}
+
+bool PersistenceWorker::migrate(StorageBackend::Kind kind, const ExerciseStore& store, qint64 sequence) {
+    if (kind == m_backend->kind())
+        return true;
+
+    ScopedTimer timer("persistence.migrate");
+    std::unique_ptr<StorageBackend> backend = StorageBackend::create(kind, m_directory);
+    // Lo que hubiera de una migración anterior se sustituye entero
+    if (!backend->clear() || !backend->writeSnapshot(store, sequence)) {
+        qCWarning(lcPersistence) << "PersistenceWorker: no se pudo migrar a" << StorageBackend::kindName(kind);
+        return false;
+    }
+
+    // El anterior se borra ya: si no, una elección sin guardar en QSettings
+    // haría cargar al arrancar unos datos viejos en lugar de estos
+    std::unique_ptr<StorageBackend> previous = std::exchange(m_backend, std::move(backend));
+    if (!previous->clear())
+        qCWarning(lcPersistence) << "PersistenceWorker: no se pudieron borrar los datos de"
+                                 << StorageBackend::kindName(previous->kind());
+    emit backendChanged(kind);
+    return true;
+}
+
+void PersistenceWorker::mapSnapshot() {
+    emit snapshotMapped(m_backend->mapSnapshot());
+}
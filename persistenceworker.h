@@ -0,0 +1,51 @@
+#ifndef PERSISTENCEWORKER_H
+#define PERSISTENCEWORKER_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <memory>
+#include "exercisestore.h"
+#include "storagebackend.h"
+
+// Escritura a disco fuera del hilo de la interfaz. Vive en su propio QThread:
+// DataCenter le pasa los registros del diario y copias inmutables del almacén
+// (la copia es inmediata porque las columnas son implícitamente compartidas).
+// Todas las escrituras se serializan en ese hilo y pasan por el mismo
+// StorageBackend, así que un snapshot nunca se cruza con un registro del diario.
+class PersistenceWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Resultado de la carga inicial; DataCenter lo adopta en el hilo de la interfaz
+    using LoadResult = StorageBackend::LoadResult;
+
+    PersistenceWorker(StorageBackend::Kind kind, const QString& directory);
+
+    // Se ejecutan en el hilo del worker; m_backend sólo se toca desde ahí
+    LoadResult load(const QString& legacyPath);
+    void appendMutation(const QJsonObject& record);
+    bool writeSnapshot(const ExerciseStore& store, qint64 sequence);
+    bool clear();
+    // Escribe el almacén en otro motor, pasa a usarlo y borra los datos del anterior
+    bool migrate(StorageBackend::Kind kind, const ExerciseStore& store, qint64 sequence);
+    // Snapshot mapeable del motor en uso (nulo si no tiene); llega por snapshotMapped
+    void mapSnapshot();
+
+signals:
+    void loadProgress(double progress);
+    void snapshotWritten(qint64 sequence, qint64 durationMs, bool ok);
+    void journalAppendFailed();
+    // Motor en uso: puede no ser el pedido si no se pudo migrar a él al cargar
+    void backendChanged(StorageBackend::Kind kind);
+    void snapshotMapped(QSharedPointer<const BinarySnapshot> snapshot);
+
+private:
+    QString m_directory;
+    std::unique_ptr<StorageBackend> m_backend;
+
+    bool adopt(const LoadResult& result);
+    bool migrateLegacyJson(const QString& legacyPath, LoadResult* result);
+};
+
+#endif // PERSISTENCEWORKER_H
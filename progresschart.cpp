@@ -0,0 +1,420 @@
+#include "progresschart.h"
+#include <QDateTime>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QVarLengthArray>
+#include <QtMath>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+
+constexpr double kHeadroom = 1.2;  // 20% de margen sobre el máximo
+constexpr qreal kLineWidth = 3;
+constexpr qreal kPointRadius = 6;
+constexpr qreal kSelectedRadius = 7;
+constexpr qreal kSelectedBorderRadius = 9;
+constexpr qreal kDropLineWidth = 2;
+constexpr qreal kDashLength = 3;
+constexpr qreal kHitRadius = 30;
+constexpr qreal kMinTickSpacing = 16;
+constexpr int kCircleSegments = 16;
+
+// Todos los nodos del gráfico; se crean una vez y sólo cambian sus vértices
+class ChartNode : public QSGNode
+{
+public:
+    QSGGeometryNode* bands = nullptr;
+    QSGGeometryNode* alternateBands = nullptr;
+    QSGGeometryNode* grid = nullptr;
+    QSGGeometryNode* line = nullptr;
+    QSGGeometryNode* highlightLine = nullptr;
+    QSGGeometryNode* points = nullptr;
+    QSGGeometryNode* dropLine = nullptr;
+    QSGGeometryNode* selectedBorder = nullptr;
+    QSGGeometryNode* selected = nullptr;
+};
+
+QSGGeometryNode* createNode(QSGNode* parent, QSGGeometry::DrawingMode mode) {
+    auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+    geometry->setDrawingMode(mode);
+    geometry->setLineWidth(1);
+
+    auto* node = new QSGGeometryNode;
+    node->setGeometry(geometry);
+    node->setFlag(QSGNode::OwnsGeometry);
+    node->setMaterial(new QSGFlatColorMaterial);
+    node->setFlag(QSGNode::OwnsMaterial);
+    parent->appendChildNode(node);
+    return node;
+}
+
+void setColor(QSGGeometryNode* node, const QColor& color) {
+    auto* material = static_cast<QSGFlatColorMaterial*>(node->material());
+    if (material->color() == color)
+        return;
+    material->setColor(color);
+    node->markDirty(QSGNode::DirtyMaterial);
+}
+
+void upload(QSGGeometryNode* node, const QList<QPointF>& vertices) {
+    QSGGeometry* geometry = node->geometry();
+    geometry->allocate(int(vertices.size()));
+    QSGGeometry::Point2D* out = geometry->vertexDataAsPoint2D();
+    for (const QPointF& vertex : vertices)
+        (out++)->set(float(vertex.x()), float(vertex.y()));
+    node->markDirty(QSGNode::DirtyGeometry);
+}
+
+// Las líneas gruesas se dibujan como rectángulos (dos triángulos): el ancho
+// de línea de QSGGeometry no está garantizado fuera de OpenGL
+void appendSegment(QList<QPointF>* out, const QPointF& a, const QPointF& b, qreal width) {
+    const QPointF delta = b - a;
+    const qreal length = std::hypot(delta.x(), delta.y());
+    if (length <= 0)
+        return;
+    const QPointF normal(-delta.y() / length * width / 2, delta.x() / length * width / 2);
+    *out << a + normal << a - normal << b + normal
+         << b + normal << a - normal << b - normal;
+}
+
+void appendCircle(QList<QPointF>* out, const QPointF& center, qreal radius) {
+    static const std::array<QPointF, kCircleSegments + 1> unit = []() {
+        std::array<QPointF, kCircleSegments + 1> points;
+        for (int i = 0; i <= kCircleSegments; ++i) {
+            const qreal angle = 2 * M_PI * i / kCircleSegments;
+            points[i] = QPointF(std::cos(angle), std::sin(angle));
+        }
+        return points;
+    }();
+    for (int i = 0; i < kCircleSegments; ++i)
+        *out << center << center + unit[i] * radius << center + unit[i + 1] * radius;
+}
+
+void appendRect(QList<QPointF>* out, qreal left, qreal top, qreal right, qreal bottom) {
+    *out << QPointF(left, top) << QPointF(right, top) << QPointF(left, bottom)
+         << QPointF(left, bottom) << QPointF(right, top) << QPointF(right, bottom);
+}
+
+} // namespace
+
+ProgressChart::ProgressChart(QQuickItem *parent) : QQuickItem(parent) {
+    setFlag(ItemHasContents, true);
+}
+
+void ProgressChart::setSeries(HistorySeriesModel* series) {
+    if (m_series == series)
+        return;
+
+    if (m_series)
+        disconnect(m_series, nullptr, this, nullptr);
+
+    m_series = series;
+
+    // Cada cambio de la serie recalcula la muestra, y sampleChanged sólo llega
+    // si cambió: seriesChanged volvería a montar la misma geometría
+    if (m_series)
+        connect(m_series, &HistorySeriesModel::sampleChanged, this, &ProgressChart::relayout);
+
+    relayout();
+    emit seriesChanged();
+}
+
+void ProgressChart::setHighlightedRow(int row) {
+    if (m_highlightedRow == row)
+        return;
+    m_highlightedRow = row;
+    updateSelection();
+    emit highlightedRowChanged();
+}
+
+void ProgressChart::setLineColor(const QColor& color) {
+    if (m_lineColor == color)
+        return;
+    m_lineColor = color;
+    markDirty(ColorsDirty);
+    emit colorsChanged();
+}
+
+void ProgressChart::setAccentColor(const QColor& color) {
+    if (m_accentColor == color)
+        return;
+    m_accentColor = color;
+    markDirty(ColorsDirty);
+    emit colorsChanged();
+}
+
+void ProgressChart::setBorderColor(const QColor& color) {
+    if (m_borderColor == color)
+        return;
+    m_borderColor = color;
+    markDirty(ColorsDirty);
+    emit colorsChanged();
+}
+
+void ProgressChart::setGridColor(const QColor& color) {
+    if (m_gridColor == color)
+        return;
+    m_gridColor = color;
+    markDirty(ColorsDirty);
+    emit colorsChanged();
+}
+
+void ProgressChart::setBandColor(const QColor& color) {
+    if (m_bandColor == color)
+        return;
+    m_bandColor = color;
+    markDirty(ColorsDirty);
+    emit colorsChanged();
+}
+
+void ProgressChart::setAlternateBandColor(const QColor& color) {
+    if (m_alternateBandColor == color)
+        return;
+    m_alternateBandColor = color;
+    markDirty(ColorsDirty);
+    emit colorsChanged();
+}
+
+void ProgressChart::setTopMargin(qreal margin) {
+    if (qFuzzyCompare(m_topMargin, margin))
+        return;
+    m_topMargin = margin;
+    relayout();
+    emit marginsChanged();
+}
+
+void ProgressChart::setBottomMargin(qreal margin) {
+    if (qFuzzyCompare(m_bottomMargin, margin))
+        return;
+    m_bottomMargin = margin;
+    relayout();
+    emit marginsChanged();
+}
+
+void ProgressChart::setSideMargin(qreal margin) {
+    if (qFuzzyCompare(m_sideMargin, margin))
+        return;
+    m_sideMargin = margin;
+    relayout();
+    emit marginsChanged();
+}
+
+void ProgressChart::setGridLines(int lines) {
+    if (m_gridLines == lines)
+        return;
+    m_gridLines = lines;
+    markDirty(DataDirty);
+    emit marginsChanged();
+}
+
+void ProgressChart::geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry) {
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+        relayout();
+}
+
+qreal ProgressChart::yForValue(double value) const {
+    if (m_axisMaximum <= 0)
+        return plotBottom();
+    const qreal plotHeight = height() - m_topMargin - m_bottomMargin;
+    return plotBottom() - value / m_axisMaximum * plotHeight;
+}
+
+void ProgressChart::relayout() {
+    m_points.clear();
+    m_rows.clear();
+    m_bands.clear();
+    m_months.clear();
+    m_dayTicks.clear();
+    m_axisMaximum = 0;
+
+    if (m_series && m_series->count() > 0 && width() > 0) {
+        m_rows = m_series->sampleRows();
+        const QList<double> timestamps = m_series->sampleTimestamps();
+        const QList<double> values = m_series->sampleValues();
+        m_axisMaximum = m_series->maxValue() > 0 ? m_series->maxValue() * kHeadroom : 1;
+
+        const double first = timestamps.first();
+        const double span = timestamps.last() - first;
+        const qreal plotWidth = width() - 2 * m_sideMargin;
+        auto xFor = [&](double timestamp) {
+            return span > 0 ? m_sideMargin + (timestamp - first) / span * plotWidth : m_sideMargin;
+        };
+
+        m_points.reserve(timestamps.size());
+        for (int i = 0; i < timestamps.size(); ++i)
+            m_points.append(QPointF(xFor(timestamps.at(i)), yForValue(values.at(i))));
+
+        // Fondos de los meses con registros (búsqueda binaria en la ventana completa)
+        const QDate firstDate = QDateTime::fromMSecsSinceEpoch(qint64(first)).date();
+        const QDate lastDate = QDateTime::fromMSecsSinceEpoch(qint64(timestamps.last())).date();
+        int previousMonth = -1;
+        qreal previousRight = -1;
+        for (QDate month(firstDate.year(), firstDate.month(), 1); month <= lastDate; month = month.addMonths(1)) {
+            const double start = double(QDateTime(month, QTime(0, 0)).toMSecsSinceEpoch());
+            const double end = double(QDateTime(month.addMonths(1), QTime(0, 0)).toMSecsSinceEpoch());
+            if (m_series->lowerBound(start) >= m_series->lowerBound(end))
+                continue;
+
+            const qreal left = span > 0 ? std::max<qreal>(0, xFor(start)) : 0;
+            const qreal right = span > 0 ? std::min<qreal>(width(), xFor(end)) : width();
+            const int monthIndex = month.year() * 12 + month.month() - 1;
+            const bool gap = previousMonth >= 0 && monthIndex - previousMonth > 1;
+
+            m_bands.append({left, right, month.month() % 2 == 0});
+            m_months.append(QVariantMap{
+                {"x", left},
+                {"width", right - left},
+                {"month", month.month() - 1},
+                {"year", month.year()},
+                {"gapX", gap ? (previousRight + left) / 2 : -1}
+            });
+            previousMonth = monthIndex;
+            previousRight = right;
+        }
+
+        // Días bajo el eje, saltando los que no caben
+        int previousDay = 0;
+        qreal lastTickX = -kMinTickSpacing;
+        for (int i = 0; i < m_points.size(); ++i) {
+            const int day = QDateTime::fromMSecsSinceEpoch(qint64(timestamps.at(i))).date().day();
+            const qreal x = m_points.at(i).x();
+            if (day != previousDay && x - lastTickX >= kMinTickSpacing) {
+                m_dayTicks.append(QVariantMap{{"x", x}, {"day", day}});
+                lastTickX = x;
+            }
+            previousDay = day;
+        }
+    }
+
+    markDirty(DataDirty);
+    emit layoutChanged();
+    updateSelection();
+}
+
+void ProgressChart::updateSelection() {
+    m_selected = m_highlightedRow >= 0 ? int(m_rows.indexOf(m_highlightedRow)) : -1;
+    markDirty(HighlightDirty);
+    emit highlightChanged();
+}
+
+void ProgressChart::markDirty(int flags) {
+    m_dirty |= flags;
+    update();
+}
+
+int ProgressChart::rowAt(const QPointF& position) const {
+    // Los puntos están ordenados por x: sólo se miran los de la franja del toque
+    auto it = std::lower_bound(m_points.cbegin(), m_points.cend(), position.x() - kHitRadius,
+                               [](const QPointF& point, qreal x) { return point.x() < x; });
+
+    QVarLengthArray<int, 8> near;
+    for (; it != m_points.cend() && it->x() <= position.x() + kHitRadius; ++it) {
+        const QPointF delta = *it - position;
+        if (QPointF::dotProduct(delta, delta) < kHitRadius * kHitRadius)
+            near.append(int(it - m_points.cbegin()));
+    }
+
+    if (near.isEmpty())
+        return -1;
+    if (near.size() == 1)
+        return m_rows.at(near.first()) == m_highlightedRow ? -1 : m_rows.at(near.first());
+
+    // Varios puntos cerca: cada toque pasa al siguiente
+    const qsizetype current = near.indexOf(m_selected);
+    const int next = current >= 0 ? near.at((current + 1) % near.size()) : near.first();
+    return m_rows.at(next);
+}
+
+QSGNode* ProgressChart::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*) {
+    auto* root = static_cast<ChartNode*>(oldNode);
+    if (!root) {
+        root = new ChartNode;
+        root->bands = createNode(root, QSGGeometry::DrawTriangles);
+        root->alternateBands = createNode(root, QSGGeometry::DrawTriangles);
+        root->grid = createNode(root, QSGGeometry::DrawLines);
+        root->line = createNode(root, QSGGeometry::DrawTriangles);
+        root->highlightLine = createNode(root, QSGGeometry::DrawTriangles);
+        root->points = createNode(root, QSGGeometry::DrawTriangles);
+        root->dropLine = createNode(root, QSGGeometry::DrawTriangles);
+        root->selectedBorder = createNode(root, QSGGeometry::DrawTriangles);
+        root->selected = createNode(root, QSGGeometry::DrawTriangles);
+        m_dirty = DataDirty | HighlightDirty | ColorsDirty;
+    }
+
+    if (m_dirty & ColorsDirty) {
+        setColor(root->bands, m_bandColor);
+        setColor(root->alternateBands, m_alternateBandColor);
+        setColor(root->grid, m_gridColor);
+        setColor(root->line, m_lineColor);
+        setColor(root->highlightLine, m_accentColor);
+        setColor(root->points, m_accentColor);
+        setColor(root->dropLine, m_accentColor);
+        setColor(root->selectedBorder, m_borderColor);
+        setColor(root->selected, m_accentColor.darker(130));
+    }
+
+    QList<QPointF> vertices;
+
+    if (m_dirty & DataDirty) {
+        const qreal top = m_topMargin;
+        const qreal bottom = plotBottom();
+
+        QList<QPointF> alternate;
+        for (const Band& band : std::as_const(m_bands))
+            appendRect(band.alternate ? &alternate : &vertices, band.left, top, band.right, bottom);
+        upload(root->bands, vertices);
+        upload(root->alternateBands, alternate);
+
+        // Eje X y líneas horizontales de la cuadrícula
+        vertices.clear();
+        const qreal plotHeight = bottom - top;
+        for (int i = 0; i < m_gridLines; ++i) {
+            const qreal y = bottom - plotHeight * i / std::max(1, m_gridLines);
+            vertices << QPointF(0, y) << QPointF(width(), y);
+        }
+        upload(root->grid, vertices);
+
+        vertices.clear();
+        for (int i = 1; i < m_points.size(); ++i)
+            appendSegment(&vertices, m_points.at(i - 1), m_points.at(i), kLineWidth);
+        upload(root->line, vertices);
+
+        vertices.clear();
+        for (const QPointF& point : std::as_const(m_points))
+            appendCircle(&vertices, point, kPointRadius);
+        upload(root->points, vertices);
+    }
+
+    if (m_dirty & (DataDirty | HighlightDirty)) {
+        // Tramo de línea hasta el punto resaltado y línea discontinua al eje
+        vertices.clear();
+        for (int i = 1; i <= m_selected; ++i)
+            appendSegment(&vertices, m_points.at(i - 1), m_points.at(i), kLineWidth);
+        upload(root->highlightLine, vertices);
+
+        vertices.clear();
+        if (m_selected >= 0) {
+            const QPointF point = m_points.at(m_selected);
+            for (qreal y = point.y(); y < plotBottom(); y += 2 * kDashLength)
+                appendSegment(&vertices, QPointF(point.x(), y),
+                              QPointF(point.x(), std::min(y + kDashLength, plotBottom())), kDropLineWidth);
+        }
+        upload(root->dropLine, vertices);
+
+        vertices.clear();
+        if (m_selected >= 0)
+            appendCircle(&vertices, m_points.at(m_selected), kSelectedBorderRadius);
+        upload(root->selectedBorder, vertices);
+
+        vertices.clear();
+        if (m_selected >= 0)
+            appendCircle(&vertices, m_points.at(m_selected), kSelectedRadius);
+        upload(root->selected, vertices);
+    }
+
+    m_dirty = 0;
+    return root;
+}
@@ -0,0 +1,136 @@
+#ifndef PROGRESSCHART_H
+#define PROGRESSCHART_H
+
+#include <QColor>
+#include <QPointer>
+#include <QQuickItem>
+#include <QVariantList>
+#include "historyseriesmodel.h"
+
+// Gráfico de progreso de GraphPage dibujado con el scene graph: fondos de
+// mes, líneas de cuadrícula, la línea de la serie y los puntos son buffers de
+// vértices que sólo se reconstruyen cuando cambian los datos o el tamaño. Al
+// resaltar un punto sólo se rehacen los nodos del resaltado, y el scroll no
+// repinta nada (el item se mueve dentro del ScrollView).
+//
+// Los textos (meses, días, eje Y) los pone QML a partir de months, dayTicks y
+// axisMaximum. Los toques se resuelven aquí con rowAt().
+class ProgressChart : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(HistorySeriesModel* series READ series WRITE setSeries NOTIFY seriesChanged)
+    Q_PROPERTY(int highlightedRow READ highlightedRow WRITE setHighlightedRow NOTIFY highlightedRowChanged)
+
+    Q_PROPERTY(QColor lineColor READ lineColor WRITE setLineColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor accentColor READ accentColor WRITE setAccentColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor borderColor READ borderColor WRITE setBorderColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor gridColor READ gridColor WRITE setGridColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor bandColor READ bandColor WRITE setBandColor NOTIFY colorsChanged)
+    Q_PROPERTY(QColor alternateBandColor READ alternateBandColor WRITE setAlternateBandColor NOTIFY colorsChanged)
+
+    Q_PROPERTY(qreal topMargin READ topMargin WRITE setTopMargin NOTIFY marginsChanged)
+    Q_PROPERTY(qreal bottomMargin READ bottomMargin WRITE setBottomMargin NOTIFY marginsChanged)
+    Q_PROPERTY(qreal sideMargin READ sideMargin WRITE setSideMargin NOTIFY marginsChanged)
+    Q_PROPERTY(int gridLines READ gridLines WRITE setGridLines NOTIFY marginsChanged)
+
+    // Resultado del último cálculo, para las etiquetas de QML
+    Q_PROPERTY(double axisMaximum READ axisMaximum NOTIFY layoutChanged)
+    Q_PROPERTY(QVariantList months READ months NOTIFY layoutChanged)
+    Q_PROPERTY(QVariantList dayTicks READ dayTicks NOTIFY layoutChanged)
+    Q_PROPERTY(qreal highlightX READ highlightX NOTIFY highlightChanged)
+    Q_PROPERTY(qreal highlightY READ highlightY NOTIFY highlightChanged)
+
+public:
+    explicit ProgressChart(QQuickItem *parent = nullptr);
+
+    HistorySeriesModel* series() const { return m_series; }
+    void setSeries(HistorySeriesModel* series);
+    int highlightedRow() const { return m_highlightedRow; }
+    void setHighlightedRow(int row);
+
+    QColor lineColor() const { return m_lineColor; }
+    void setLineColor(const QColor& color);
+    QColor accentColor() const { return m_accentColor; }
+    void setAccentColor(const QColor& color);
+    QColor borderColor() const { return m_borderColor; }
+    void setBorderColor(const QColor& color);
+    QColor gridColor() const { return m_gridColor; }
+    void setGridColor(const QColor& color);
+    QColor bandColor() const { return m_bandColor; }
+    void setBandColor(const QColor& color);
+    QColor alternateBandColor() const { return m_alternateBandColor; }
+    void setAlternateBandColor(const QColor& color);
+
+    qreal topMargin() const { return m_topMargin; }
+    void setTopMargin(qreal margin);
+    qreal bottomMargin() const { return m_bottomMargin; }
+    void setBottomMargin(qreal margin);
+    qreal sideMargin() const { return m_sideMargin; }
+    void setSideMargin(qreal margin);
+    int gridLines() const { return m_gridLines; }
+    void setGridLines(int lines);
+
+    double axisMaximum() const { return m_axisMaximum; }
+    QVariantList months() const { return m_months; }
+    QVariantList dayTicks() const { return m_dayTicks; }
+    qreal highlightX() const { return m_selected >= 0 ? m_points.at(m_selected).x() : 0; }
+    qreal highlightY() const { return m_selected >= 0 ? m_points.at(m_selected).y() : 0; }
+
+    // Fila que resaltar tras un toque en position: -1 si no hay puntos cerca o
+    // se toca el ya resaltado; con varios puntos cerca se van alternando
+    Q_INVOKABLE int rowAt(const QPointF& position) const;
+    Q_INVOKABLE qreal yForValue(double value) const;
+
+signals:
+    void seriesChanged();
+    void highlightedRowChanged();
+    void colorsChanged();
+    void marginsChanged();
+    void layoutChanged();
+    void highlightChanged();
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+    void geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry) override;
+
+private:
+    enum Dirty {
+        DataDirty = 0x1,      // bandas, cuadrícula, línea y puntos
+        HighlightDirty = 0x2, // sólo los nodos del resaltado
+        ColorsDirty = 0x4
+    };
+
+    QPointer<HistorySeriesModel> m_series;
+    int m_highlightedRow = -1;
+
+    QColor m_lineColor = Qt::darkGray;
+    QColor m_accentColor = Qt::blue;
+    QColor m_borderColor = Qt::black;
+    QColor m_gridColor = Qt::lightGray;
+    QColor m_bandColor = QColor(0, 0, 0, 0);
+    QColor m_alternateBandColor = QColor(0, 0, 0, 0);
+
+    qreal m_topMargin = 25;
+    qreal m_bottomMargin = 35;
+    qreal m_sideMargin = 20;
+    int m_gridLines = 8;
+
+    // Puntos dibujados (muestra de la serie) ya en coordenadas del item
+    QList<QPointF> m_points;
+    QList<int> m_rows;
+    int m_selected = -1; // posición de highlightedRow en m_points
+    double m_axisMaximum = 0;
+    struct Band { qreal left; qreal right; bool alternate; };
+    QList<Band> m_bands;
+    QVariantList m_months;
+    QVariantList m_dayTicks;
+
+    int m_dirty = DataDirty | HighlightDirty | ColorsDirty;
+
+    void relayout();
+    void updateSelection();
+    void markDirty(int flags);
+    qreal plotBottom() const { return height() - m_bottomMargin; }
+};
+
+#endif // PROGRESSCHART_H
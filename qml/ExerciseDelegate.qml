@@ -14,7 +14,6 @@ Item {
     required property string unit
     required property int repetitions
     required property int sets
-    required property var history
     required property int index
 
     property bool dragged: false
@@ -1,6 +1,7 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
+import gymWeights 1.0
 
 Page {
     id: graph
@@ -13,8 +14,7 @@ Page {
 
     property string exerciseName: ""
     property string muscleGroup: ""
-    property var exerciseData: []
-    property bool noData: exerciseData.length === 0
+    property bool noData: filteredModel.totalCount === 0
     property int highlightedIndex: -1
     property int selectedPeriod: 0
 
@@ -24,6 +24,7 @@ Page {
     property int marginBottom: 35
     property int innerMargin: 20
     property int minPointSpacing: 35
+    property int maxScrollScreens: 4 // el gráfico mide como mucho 4 pantallas de ancho
     property point tooltipPos: Qt.point(0, 0)
 
     property var monthNames: settings.language === "es" ? spanishMonthNames : englishMonthNames
@@ -43,50 +44,21 @@ Page {
         }
     }
 
-    ListModel {
+    // Historial del ejercicio en C++: fechas y valores en columnas contiguas,
+    // ventana del periodo por búsqueda binaria y extremos ya calculados
+    HistorySeriesModel {
         id: filteredModel
-    }
-
-    function filterData() {
-        console.log("Filtrando datos. Período seleccionado:", selectedPeriod, " exerciseData.length: " + exerciseData.length);
-        filteredModel.clear();
-
-        if (selectedPeriod === 0) {
-            exerciseData.forEach(item => filteredModel.append(item));
-        } else {
-            var cutoffDate = new Date();
-            cutoffDate.setMonth(cutoffDate.getMonth() - selectedPeriod);
-            exerciseData.forEach(item => {
-                if (new Date(item.date) >= cutoffDate) {
-                    filteredModel.append(item);
-                }
-            });
-        }
-
-        console.log("Modelo después de filtrar. Count:", filteredModel.count);
-        if (filteredModel.count > 0) {
-            console.log("Primer elemento:", JSON.stringify(filteredModel.get(0)));
-        } else {
-            console.log("filteredModel.count es 0");
-            historyDialog.close()
+        exerciseName: graph.exerciseName
+        period: selectedPeriod
+        // Historiales largos: sólo los puntos que caben con minPointSpacing
+        sampleBudget: Math.max(2, Math.floor(scrollView.width * maxScrollScreens / minPointSpacing))
+        highlightedRow: highlightedIndex
+        onSeriesChanged: {
+            if (count === 0) historyDialog.close()
+            highlightedIndex = -1
         }
     }
 
-    // Verificar si hay datos para un período determinado
-    function hasDataForPeriod(months) {
-        if (months === 0) return true // Siempre hay datos para "Todo"
-        if (exerciseData.length === 0) return false // No hay datos
-
-        var cutoffDate = new Date()
-        cutoffDate.setMonth(cutoffDate.getMonth() - months)
-        return exerciseData.some(item => new Date(item.date) >= cutoffDate)
-    }
-
-    // Calcular posición Y en el gráfico para un valor dado
-    function getY(value, minVal, maxVal, plotHeight) {
-        return (chartCanvas.height - marginBottom) - ((value - minVal) / (maxVal - minVal)) * plotHeight
-    }
-
     // Formatear fecha completa (dd MMM YY)
     function formatDate(dateStr) {
         var date = new Date(dateStr)
@@ -131,34 +103,18 @@ Page {
     }
 
     // Cargar datos del ejercicio desde el DataCenter
+    // El historial lo mantiene filteredModel; aquí sólo unidad y grupo
     function loadData() {
         console.log("Cargando datos para:", exerciseName);
-        exerciseData = [];
-        filteredModel.clear();
-        exerciseData = dataCenter.getExerciseHistoryDetailed(exerciseName);
-        console.log("Datos crudos recibidos:", JSON.stringify(exerciseData));
         graph.unit = dataCenter.getUnit(exerciseName) === "-" ? "Reps" : dataCenter.getUnit(exerciseName);
         isWeightGraph = unit !== "Reps";
         graph.muscleGroup = dataCenter.getMuscleGroup(exerciseName);
-
-        if (exerciseData.length > 0) {
-            // Ordenar datos por fecha (más antiguo primero)
-            exerciseData.sort((a, b) => new Date(a.date) - new Date(b.date));
-            filterData();
-        }
-    }
-
-    // Volver a pintar el gráfico
-    function repaint() {
-        filterData()
-        highlightedIndex = -1
-        chartCanvas.requestPaint()
-        yAxisCanvas.requestPaint()
     }
 
     // Al cargar el componente, cargar los datos iniciales
     Component.onCompleted: {
         console.log("Cargamos datos en GraphPage.qml para " + exerciseName)
+        filteredModel.dataCenter = dataCenter
         loadData()
     }
 
@@ -168,10 +124,7 @@ Page {
         function onDataChanged() {
             console.log("--- onDataChanged triggered ---");
             console.log("ExerciseName:", exerciseName);
-            console.log("Current dataCenter data:", JSON.stringify(dataCenter.data));
             loadData();
-            console.log("ExerciseData after load:", JSON.stringify(exerciseData));
-            repaint();
         }
     }
 
@@ -244,7 +197,8 @@ Page {
                 width: (periodButtons.width - (periodButtons.spacing * 4)) / 5
                 height: periodButtons.height
                 text: settings.language === "es" ? modelData.text : modelData.textEng
-                enabled: hasDataForPeriod(modelData.months) // Deshabilitar si no hay datos
+                // Deshabilitar si no hay datos (totalCount reevalúa al cambiar el historial)
+                enabled: filteredModel.totalCount >= 0 && filteredModel.hasDataForPeriod(modelData.months)
                 opacity: enabled ? 1.0 : 0.4
 
                 background: Rectangle {
@@ -266,8 +220,7 @@ Page {
                 onClicked: {
                     if (selectedPeriod !== modelData.months) {
                         highlightedIndex = -1 // Resetear selección
-                        selectedPeriod = modelData.months
-                        repaint() // Volver a pintar con nuevos datos
+                        selectedPeriod = modelData.months // filteredModel avisa y se repinta
                     }
                 }
             }
@@ -285,7 +238,7 @@ Page {
         isWeight: isWeightGraph
         unitText: unit
         muscleGroup: graph.muscleGroup
-        currentModel: filteredModel
+        series: filteredModel
     }
 
     // Contenedor principal del gráfico
@@ -310,59 +263,30 @@ Page {
             width: marginLeft
             z: 2
 
-            // Canvas para dibujar el eje Y
-            Canvas {
-                id: yAxisCanvas
-                anchors.fill: parent
-                antialiasing: true
-
-                onPaint: {
-                    var ctx = getContext("2d")
-                    ctx.clearRect(0, 0, width, height)
-
-                    if (filteredModel.count === 0) return // No pintar si no hay datos
-
-                    var mt = marginTop
-                    var mb = marginBottom
-                    var plotHeight = height - mt - mb
+            // Línea del eje Y
+            Rectangle {
+                anchors.right: parent.right
+                y: marginTop
+                width: 1
+                height: parent.height - marginTop - marginBottom
+                color: Style.divider
+                visible: filteredModel.count > 0
+            }
 
-                    // Obtener valores para el eje Y
-                    var values = []
-                    for (var i = 0; i < filteredModel.count; i++) {
-                        values.push(isWeightGraph ? filteredModel.get(i).weight : filteredModel.get(i).reps)
-                    }
-                    var maxVal = Math.max(...values) * 1.2 // Añadir 20% de margen
-                    var minVal = 0
-
-                    // Dibujar línea del eje Y
-                    ctx.strokeStyle = Style.divider
-                    ctx.lineWidth = 1
-                    ctx.beginPath()
-                    ctx.moveTo(width, mt)
-                    ctx.lineTo(width, height - mb)
-                    ctx.stroke()
-
-                    // Dibujar marcas y valores del eje Y
-                    var numYTicks = 8
-                    ctx.font = Style.caption + "px " + Style.interFont.name
-                    ctx.fillStyle = Style.textSecondary
-
-                    for (var i = 0; i <= numYTicks - 1; i++) {
-                        var v = minVal + (i/numYTicks) * (maxVal - minVal)
-                        var y = (height - mb) - (i/numYTicks) * plotHeight
-
-                        // Marca pequeña
-                        /*ctx.beginPath()
-                        ctx.moveTo(width - 5, y)
-                        ctx.lineTo(width, y)
-                        ctx.stroke()*/
-
-                        // Texto del valor
-                        ctx.textAlign = "right"
-                        ctx.textBaseline = "middle"
-                        ctx.fillText(Math.round(v), width - 10, y);
-                        //ctx.fillText(v.toFixed(isWeightGraph ? 1 : 0), width - 10, y)
-                    }
+            // Valores del eje Y, a la altura de las líneas de la cuadrícula
+            Repeater {
+                model: filteredModel.count > 0 ? chart.gridLines : 0
+
+                Text {
+                    required property int index
+                    readonly property real value: index / chart.gridLines * chart.axisMaximum
+                    anchors.right: parent.right
+                    anchors.rightMargin: 10
+                    y: chart.yForValue(value) - height / 2
+                    text: Math.round(value)
+                    font.family: Style.interFont.name
+                    font.pixelSize: Style.caption
+                    color: Style.textSecondary
                 }
             }
         }
@@ -385,394 +309,123 @@ Page {
             Item {
                 id: contentItem
                 width: {
-                    if (filteredModel.count <= 1) return scrollView.width
-                    // Calcular ancho necesario basado en número de puntos
-                    var requiredWidth = marginRight + (filteredModel.count - 1) * minPointSpacing
+                    var points = filteredModel.sampleRows.length
+                    if (points <= 1) return scrollView.width
+                    // Calcular ancho necesario basado en número de puntos dibujados
+                    var requiredWidth = marginRight + (points - 1) * minPointSpacing
                     return Math.max(requiredWidth, scrollView.width)
                 }
-                height: chartCanvas.height
+                height: chart.height
 
-                // Canvas principal del gráfico
-                Canvas {
-                    id: chartCanvas
+                // Gráfico nativo (scene graph): líneas, puntos y fondos en C++
+                ProgressChart {
+                    id: chart
                     width: contentItem.width
                     height: chartContainer.height
-                    antialiasing: true
-
-                    onPaint: {
-                        var ctx = getContext("2d")
-                        ctx.clearRect(0, 0, width, height)
-                        if (filteredModel.count === 0) return // No dibujar si no hay datos
-
-                        var mt = marginTop
-                        var mb = marginBottom
-                        var plotWidth = width
-                        var plotHeight = height - mt - mb
-
-                        // Obtener rango de fechas
-                        var firstDate = new Date(filteredModel.get(0).date)
-                        var lastDate = new Date(filteredModel.get(filteredModel.count-1).date)
-                        var totalDays = lastDate - firstDate
-
-                        /* ----------------- CALCULAR POSICIONES X ----------------- */
-                        var xPositions = []
-                        if (filteredModel.count <= 1) {
-                            xPositions = [innerMargin] // Solo un punto, centrado
-                        } else {
-                            var availableWidth = plotWidth - 2 * innerMargin
-                            var requiredWidth = (filteredModel.count - 1) * minPointSpacing
-                            var scaleFactor = availableWidth / Math.max(availableWidth, requiredWidth)
-
-                            // Calcular posición X para cada punto
-                            for (var i = 0; i < filteredModel.count; i++) {
-                                var date = new Date(filteredModel.get(i).date)
-                                var daysFromStart = date - firstDate
-                                var x = innerMargin + (daysFromStart / totalDays) * (plotWidth - 2*innerMargin) * scaleFactor
-                                xPositions.push(x)
+                    series: filteredModel
+                    highlightedRow: highlightedIndex
+                    topMargin: marginTop
+                    bottomMargin: marginBottom
+                    sideMargin: innerMargin
+                    lineColor: Qt.lighter(Style.text, 1.3)
+                    accentColor: Style.muscleColor(muscleGroup)
+                    borderColor: Style.text
+                    gridColor: Style.divider
+                    bandColor: Qt.lighter(Style.soft, 1.1)
+                    alternateBandColor: Qt.lighter(Style.soft, 1.3)
+
+                    /* ----------------- MESES ----------------- */
+                    Repeater {
+                        model: chart.months
+
+                        Item {
+                            required property var modelData
+                            x: modelData.x
+                            width: modelData.width
+                            height: chart.height - marginBottom - 5
+
+                            // Etiqueta del mes, sólo si cabe
+                            Text {
+                                anchors.horizontalCenter: parent.horizontalCenter
+                                anchors.bottom: parent.bottom
+                                text: monthNames[modelData.month]
+                                font.family: Style.interFont.name
+                                font.pixelSize: Style.semi
+                                color: Style.textSecondary
+                                visible: parent.width >= implicitWidth
                             }
-                        }
 
-                        // Obtener valores Y
-                        var values = []
-                        for (var i = 0; i < filteredModel.count; i++) {
-                            values.push(isWeightGraph ? filteredModel.get(i).weight : filteredModel.get(i).reps)
-                        }
-                        var maxVal = Math.max(...values) * 1.2
-                        var minVal = 0
-
-                        /* ----------------- FONDOS DE MESES ----------------- */
-                        if (filteredModel.count > 0) {
-                            var currentDate = new Date(firstDate)
-                            currentDate.setDate(1) // Empezar desde el primer día del mes
-                            var prevMonthEndX = -1
-                            var prevMonth = -1
-
-                            // Iterar por cada mes en el rango de fechas
-                            while (currentDate <= lastDate) {
-                                let firstDayOfMonth = new Date(currentDate.getFullYear(), currentDate.getMonth(), 1)
-                                let lastDayOfMonth = new Date(currentDate.getFullYear(), currentDate.getMonth() + 1, 0)
-
-                                // Calcular posiciones X para inicio/fin de mes
-                                let monthStartX = (firstDayOfMonth - firstDate) / totalDays * (plotWidth - 1.5 * innerMargin)
-                                let monthEndX = innerMargin * 2 + ((lastDayOfMonth - firstDate) / totalDays) * (plotWidth)
-
-                                // Ajustar a los límites del gráfico
-                                monthStartX = Math.max(0, monthStartX)
-                                monthEndX = Math.min(width, monthEndX)
-
-                                // Verificar si hay datos en este mes
-                                var hasDataInMonth = false
-                                for (var j = 0; j < filteredModel.count; j++) {
-                                    var itemDate = new Date(filteredModel.get(j).date)
-                                    if (itemDate.getFullYear() === currentDate.getFullYear() &&
-                                        itemDate.getMonth() === currentDate.getMonth()) {
-                                        hasDataInMonth = true
-                                        break
-                                    }
-                                }
-
-                                // Dibujar fondo del mes si tiene datos
-                                if (hasDataInMonth && monthEndX > monthStartX) {
-                                    // Color alternado para mejor legibilidad
-                                    ctx.fillStyle = (currentDate.getMonth() % 2 === 0) ?
-                                        Qt.lighter(Style.soft, 1.1) :
-                                        Qt.lighter(Style.soft, 1.3)
-                                    ctx.fillRect(monthStartX, mt, monthEndX - monthStartX, plotHeight)
-
-                                    // Mostrar "..." si hay un salto temporal grande entre meses
-                                    if (prevMonthEndX >= 0 && (monthStartX - prevMonthEndX) > 30 &&
-                                       (currentDate.getMonth() - prevMonth > 1 || currentDate.getFullYear() > new Date(firstDate).getFullYear())) {
-                                        ctx.save()
-                                        ctx.font = Style.semi + "px " + Style.interFont.name
-                                        ctx.fillStyle = Style.textSecondary
-                                        ctx.textAlign = "center"
-                                        ctx.textBaseline = "bottom"
-                                        var gapCenter = prevMonthEndX + (monthStartX - prevMonthEndX)/2
-                                        var visibleGapCenter = Math.max(prevMonthEndX + 20,
-                                                                      Math.min(gapCenter, monthStartX - 20))
-                                        ctx.fillText(
-                                            "...",
-                                            visibleGapCenter,
-                                            height - mb - 5
-                                        )
-                                        ctx.restore()
-                                    }
-
-                                    // Etiqueta del mes
-                                    ctx.save()
-                                    ctx.font = Style.semi + "px " + Style.interFont.name
-                                    ctx.fillStyle = Style.textSecondary
-                                    ctx.textAlign = "center"
-                                    ctx.textBaseline = "bottom"
-
-                                    var monthLabel = monthNames[currentDate.getMonth()]
-                                    var labelWidth = ctx.measureText(monthLabel).width
-                                    var monthWidth = Math.min(monthEndX - monthStartX, scrollView.width)
-
-                                    // Solo mostrar etiqueta si cabe
-                                    if (monthWidth >= labelWidth) {
-                                        let labelX = monthEndX - monthWidth/2
-                                        console.log("Pintamos " + monthLabel + " en posX: " + labelX + " con endMonthX = " + monthEndX + " monthWidth: " + monthWidth + " y labelWidth: " + labelWidth)
-                                        ctx.fillText(
-                                            monthLabel,
-                                            labelX,
-                                            height - mb - 5
-                                        )
-                                    } else {
-                                        console.log("No pintamos la etiqueta " + monthLabel + " porque mide " + labelWidth + " y no cabe en " + monthWidth)
-                                    }
-
-                                    ctx.restore()
-
-                                    prevMonthEndX = monthEndX
-                                    prevMonth = currentDate.getMonth()
-                                }
-
-                                // Pasar al siguiente mes
-                                currentDate = new Date(currentDate.getFullYear(), currentDate.getMonth() + 1, 1)
+                            // "..." si hay meses sin registros antes de este
+                            Text {
+                                x: modelData.gapX - parent.x - width / 2
+                                anchors.bottom: parent.bottom
+                                text: "..."
+                                font.family: Style.interFont.name
+                                font.pixelSize: Style.semi
+                                color: Style.textSecondary
+                                visible: modelData.gapX >= 0
                             }
                         }
+                    }
 
-                        /* ----------------- EJE X Y MARCAS ----------------- */
-                        ctx.strokeStyle = Style.divider
-                        ctx.lineWidth = 1
-                        ctx.beginPath()
-                        ctx.moveTo(0, height - mb)
-                        ctx.lineTo(width, height - mb)
-                        ctx.stroke()
-
-                        // Configuración de texto para fechas
-                        ctx.font = (Style.caption - 1) + "px " + Style.interFont.name
-                        ctx.fillStyle = Style.textSecondary
-
-                        // Si hay un punto seleccionado, mostrar su fecha completa
-                        if (highlightedIndex !== -1) {
-                            var selectedDate = new Date(filteredModel.get(highlightedIndex).date)
-                            var selectedDay = selectedDate.getDate()
-                            var selectedMonth = monthNames[selectedDate.getMonth()]
-                            var selectedYear = selectedDate.getFullYear().toString().substr(2)
-
-                            var selectedX = xPositions[highlightedIndex]
-                            var dateText = `${selectedDay} ${selectedMonth} '${selectedYear}`
-                            var textWidth = ctx.measureText(dateText).width
-
-                            // Ajustar posición para que no se salga de los márgenes
-                            var textX = selectedX
-                            var minTextX = textWidth/2 + 10
-                            var maxTextX = width - textWidth/2 - 10
-
-                            if (selectedX < minTextX) {
-                                textX = minTextX
-                            } else if (selectedX > maxTextX) {
-                                textX = maxTextX
-                            }
+                    /* ----------------- DÍAS ----------------- */
+                    Repeater {
+                        model: highlightedIndex === -1 ? chart.dayTicks : []
 
-                            // Marca en el eje X
-                            ctx.beginPath()
-                            ctx.moveTo(selectedX, height - mb)
-                            ctx.lineTo(selectedX, height - mb + 5)
-                            ctx.stroke()
-
-                            // Texto de la fecha
-                            ctx.save()
-                            ctx.fillStyle = Style.text
-                            ctx.textAlign = "center"
-                            ctx.textBaseline = "top"
-                            ctx.fillText(dateText, textX, height - mb + 10)
-                            ctx.restore()
-                        } else {
-                            var previousDay = 0
-                            // Mostrar días clave (1, 3, 6, 9, etc.) si hay espacio
-                            for (var i = 0; i < filteredModel.count; i++) {
-                                var date = new Date(filteredModel.get(i).date)
-                                var day = date.getDate()
-                                var showDay = previousDay !== day
-                                previousDay = day
-                                if (showDay) {
-                                    var x = xPositions[i]
-                                    // Verificar que haya espacio para mostrar este día
-                                    var canShow = true
-                                    if (i > 0) {
-                                        var prevX = xPositions[i-1]
-                                        var spaceNeeded = ctx.measureText(day.toString()).width -5
-                                        canShow = (x - prevX) > spaceNeeded
-                                    }
-
-                                    if (canShow) {
-                                        // Marca pequeña en el eje
-                                        ctx.beginPath()
-                                        ctx.moveTo(x, height - mb)
-                                        ctx.lineTo(x, height - mb + 5)
-                                        ctx.stroke()
-
-                                        // Texto del día
-                                        ctx.save()
-                                        ctx.translate(x, height - mb + 10)
-                                        ctx.textAlign = "center"
-                                        ctx.textBaseline = "top"
-                                        ctx.fillText(day.toString(), 0, 0)
-                                        ctx.restore()
-                                    }
-                                }
+                        Item {
+                            required property var modelData
+                            x: modelData.x
+                            y: chart.height - marginBottom
+
+                            Rectangle {
+                                width: 1
+                                height: 5
+                                color: Style.divider
                             }
-                        }
 
-                        /* ----------------- LÍNEA DEL GRÁFICO ----------------- */
-                        ctx.strokeStyle = Qt.lighter(Style.text, 1.3)
-                        ctx.lineWidth = 3
-                        ctx.beginPath()
-                        for (let i = 0; i < filteredModel.count; i++) {
-                            let x = xPositions[i]
-                            var yVal = isWeightGraph ? filteredModel.get(i).weight : filteredModel.get(i).reps
-                            var y = getY(yVal, minVal, maxVal, plotHeight)
-
-                            if (i === 0) ctx.moveTo(x, y)
-                            else ctx.lineTo(x, y)
-                        }
-                        ctx.stroke()
-
-                        // Línea resaltada hasta el punto seleccionado
-                        if (highlightedIndex !== -1 && highlightedIndex < filteredModel.count) {
-                            ctx.strokeStyle = Style.muscleColor(muscleGroup)
-                            ctx.lineWidth = 3
-                            ctx.beginPath()
-                            for (let i = 0; i <= highlightedIndex; i++) {
-                                let x = xPositions[i]
-                                let yVal = isWeightGraph ? filteredModel.get(i).weight : filteredModel.get(i).reps
-                                let y = getY(yVal, minVal, maxVal, plotHeight)
-
-                                if (i === 0) ctx.moveTo(x, y)
-                                else ctx.lineTo(x, y)
+                            Text {
+                                x: -width / 2
+                                y: 10
+                                text: modelData.day
+                                font.family: Style.interFont.name
+                                font.pixelSize: Style.caption - 1
+                                color: Style.textSecondary
                             }
-                            ctx.stroke()
                         }
+                    }
 
-                        /* ----------------- PUNTOS DEL GRÁFICO ----------------- */
-                        for (let i = 0; i < filteredModel.count; i++) {
-                            let x = xPositions[i]
-                            let yVal = isWeightGraph ? filteredModel.get(i).weight : filteredModel.get(i).reps
-                            let y = getY(yVal, minVal, maxVal, plotHeight)
-
-                            ctx.beginPath()
-                            if (i === highlightedIndex) {
-                                // Punto seleccionado - más grande y con borde
-                                ctx.arc(x, y, 8, 0, Math.PI * 2)
-                                ctx.fillStyle = Qt.darker(Style.muscleColor(muscleGroup), 1.3)
-                                ctx.fill()
-                                ctx.lineWidth = 2
-                                ctx.strokeStyle = Style.text
-                                ctx.stroke()
-                            } else {
-                                // Puntos normales
-                                ctx.arc(x, y, 6, 0, Math.PI * 2)
-                                ctx.fillStyle = Style.muscleColor(muscleGroup)
-                                ctx.fill()
-                            }
+                    // Fecha completa del punto seleccionado
+                    Item {
+                        x: chart.highlightX
+                        y: chart.height - marginBottom
+                        visible: highlightedIndex !== -1
+
+                        Rectangle {
+                            width: 1
+                            height: 5
+                            color: Style.divider
                         }
 
-                        /* ----------------- LÍNEA PUNTEADA AL EJE X ----------------- */
-                        if (highlightedIndex !== -1 && highlightedIndex < filteredModel.count) {
-                            var item = filteredModel.get(highlightedIndex)
-                            let x = xPositions[highlightedIndex]
-                            let yVal = isWeightGraph ? item.weight : item.reps
-                            let y = getY(yVal, minVal, maxVal, plotHeight)
-
-                            ctx.save()
-                            ctx.strokeStyle = Style.muscleColor(muscleGroup)
-                            ctx.lineWidth = 2
-                            ctx.setLineDash([3, 3]) // Línea discontinua
-                            ctx.beginPath()
-                            ctx.moveTo(x, y)
-                            ctx.lineTo(x, height - marginBottom)
-                            ctx.stroke()
-                            ctx.restore()
+                        Text {
+                            property date selectedDate: new Date(highlightedIndex >= 0 ? filteredModel.get(highlightedIndex).timestamp : 0)
+                            // Centrada en el punto sin salirse del gráfico
+                            x: Math.max(10 - parent.x, Math.min(-width / 2, chart.width - 10 - width - parent.x))
+                            y: 10
+                            text: `${selectedDate.getDate()} ${monthNames[selectedDate.getMonth()]} '${selectedDate.getFullYear().toString().substr(2)}`
+                            font.family: Style.interFont.name
+                            font.pixelSize: Style.caption - 1
+                            color: Style.text
                         }
                     }
 
                     /* ----------------- MANEJADOR DE TAPS ----------------- */
+                    // La búsqueda del punto (y el cambio entre puntos cercanos) la hace ProgressChart
                     TapHandler {
-                        property int lastTappedIndex: -1 // Para manejar taps múltiples
-
                         onTapped: function(eventPoint) {
-                            if (filteredModel.count === 0) return
-
-                            var tapPos = eventPoint.position
-                            var closestIndices = [] // Índices de puntos cercanos al tap
-                            var minDistSquaredThreshold = 30 * 30 // Radio de 30px
-
-                            var plotWidth = chartCanvas.width
-                            var plotHeight = chartCanvas.height - marginTop - marginBottom
-                            var xPositions = []
-                            var yPositions = []
-                            var values = []
-                            for (var i = 0; i < filteredModel.count; i++) {
-                                values.push(isWeightGraph ? filteredModel.get(i).weight : filteredModel.get(i).reps)
-                            }
-                            var maxVal = Math.max(...values) * 1.2
-                            var minVal = 0
-
-                            // Calcular posiciones de todos los puntos
-                            if (filteredModel.count <= 1) {
-                                xPositions = [innerMargin]
-                                yPositions = [getY(values[0], minVal, maxVal, plotHeight)]
-                            } else {
-                                var firstDate = new Date(filteredModel.get(0).date)
-                                var lastDate = new Date(filteredModel.get(filteredModel.count-1).date)
-                                var totalDays = lastDate - firstDate
-
-                                for (var i = 0; i < filteredModel.count; i++) {
-                                    var date = new Date(filteredModel.get(i).date)
-                                    var daysFromStart = date - firstDate
-                                    var x = innerMargin + (daysFromStart / totalDays) * (plotWidth - 2*innerMargin)
-                                    xPositions.push(x)
-                                    yPositions.push(getY(values[i], minVal, maxVal, plotHeight))
-                                }
+                            highlightedIndex = chart.rowAt(eventPoint.position)
+                            if (highlightedIndex !== -1) {
+                                tooltipPos = chart.mapToItem(graph, chart.highlightX, chart.highlightY)
                             }
-
-                            // Encontrar puntos cercanos al tap
-                            for (var i = 0; i < filteredModel.count; i++) {
-                                var dx = tapPos.x + scrollView.contentItem.x - xPositions[i]
-                                var dy = tapPos.y - yPositions[i]
-                                var distSquared = dx * dx + dy * dy
-
-                                if (distSquared < minDistSquaredThreshold) {
-                                    closestIndices.push(i)
-                                }
-                            }
-
-                            // Manejar selección
-                            if (closestIndices.length > 0) {
-                                if (closestIndices.length === 1) {
-                                    // Un solo punto cercano: toggle selección
-                                    if (highlightedIndex === closestIndices[0]) {
-                                        highlightedIndex = -1; // Deseleccionar
-                                    } else {
-                                        highlightedIndex = closestIndices[0]; // Seleccionar
-                                        tooltipPos = chartCanvas.mapToItem(graph, xPositions[highlightedIndex], yPositions[highlightedIndex]);
-                                        lastTappedIndex = highlightedIndex;
-                                    }
-                                } else {
-                                    // Múltiples puntos cercanos: rotar selección
-                                    var nextIndex = -1;
-                                    if (lastTappedIndex !== -1 && closestIndices.includes(lastTappedIndex)) {
-                                        var currentIndexInClosest = closestIndices.indexOf(lastTappedIndex);
-                                        nextIndex = closestIndices[(currentIndexInClosest + 1) % closestIndices.length];
-                                    } else {
-                                        nextIndex = closestIndices[0]; // Primero de la lista
-                                    }
-                                    highlightedIndex = nextIndex;
-                                    tooltipPos = chartCanvas.mapToItem(graph, xPositions[highlightedIndex], yPositions[highlightedIndex]);
-                                    lastTappedIndex = highlightedIndex;
-                                }
-                            } else {
-                                // Tap fuera de puntos: deseleccionar
-                                highlightedIndex = -1;
-                                lastTappedIndex = -1;
-                            }
-
-                            // Actualizar gráfico
-                            chartCanvas.requestPaint()
-                            yAxisCanvas.requestPaint()
                         }
                     }
                 }
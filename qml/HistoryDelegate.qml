@@ -13,6 +13,8 @@ Item {
     required property int reps
     required property int sets
     required property int index
+    // Posición en el historial cronológico, la que usa removeHistoryEntry
+    required property int historyIndex
 
     property bool dragged: false
     property bool isOpened: contentItem.x < 0
@@ -178,7 +180,7 @@ Item {
         TapHandler {
             onTapped: {
                 confirmDeleteDialog.show(
-                    index,
+                    historyIndex,
                     exerciseName,
                     date,
                     weight,
@@ -50,48 +50,50 @@ Dialog {
         }
 
         // Lista de registros
-        ListView {
-            id: historyListView
+        Item {
             Layout.fillWidth: true
             Layout.fillHeight: true
-            clip: true
-            model: filteredModel
-            spacing: 2
-            interactive: contentHeight > height
 
-            delegate: HistoryDelegate {
+            ListView {
+                id: historyListView
+                anchors.top: parent.top
+                anchors.left: parent.left
+                anchors.right: parent.right
+                // Pegada arriba aunque haya pocos registros
+                height: Math.min(contentHeight, parent.height)
+                clip: true
+                // Registros del periodo de la gráfica. El modelo va del más reciente
+                // al más antiguo: de abajo arriba se ven en orden cronológico, la
+                // vista empieza por el final y las páginas más antiguas se cargan
+                // (fetchMore) al subir
+                model: dataCenter.historyModel(exerciseName, filteredModel.period)
+                verticalLayoutDirection: ListView.BottomToTop
+                spacing: 2
+                interactive: contentHeight > height
 
-                width: historyListView.width
-                onCloseAllHistory: {
-                    historyListView.closeAll()
-                }
-                Component.onCompleted: {
-                    console.log("Elemento " + index)
-                    console.log("date: " + date + " - weight: " + weight + " - unit: " + unit )
-                    console.log("reps: " + reps + " - sets: " + sets)
-                }
-            }
+                delegate: HistoryDelegate {
 
-            Component.onCompleted: {
-                if (historyListView.count > 0) {
-                    historyListView.positionViewAtEnd()
+                    width: historyListView.width
+                    onCloseAllHistory: {
+                        historyListView.closeAll()
+                    }
                 }
-            }
 
-            // Cerrar todos los ítems deslizables
-            function closeAll() {
-                for (let i = 0; i < contentItem.children.length; ++i) {
-                    let item = contentItem.children[i];
-                    if (item && item.index !== undefined) {
-                        if (typeof item.close === "function") {
-                            item.close();
+                // Cerrar todos los ítems deslizables
+                function closeAll() {
+                    for (let i = 0; i < contentItem.children.length; ++i) {
+                        let item = contentItem.children[i];
+                        if (item && item.index !== undefined) {
+                            if (typeof item.close === "function") {
+                                item.close();
+                            }
                         }
                     }
                 }
-            }
 
-            ScrollBar.vertical: ScrollBar {
-                policy: ScrollBar.AsNeeded
+                ScrollBar.vertical: ScrollBar {
+                    policy: ScrollBar.AsNeeded
+                }
             }
         }
 
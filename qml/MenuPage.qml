@@ -13,8 +13,6 @@ Page {
     property string searchQuery: searchBox.text
     property bool showDeleteButton: true
     property bool allOpened: false
-    property var groupsSelected: groupFilter.selectedGroups
-    property bool noneSelected: groupFilter.noneSelected
 
     property bool backPressedOnce: false
     property int backPressInterval: 2000
@@ -116,6 +114,7 @@ Page {
             id: groupFilter
             Layout.fillWidth: true
             Layout.topMargin: 5
+            groupCounts: filterModel.groupCounts
         }
 
         // Separador
@@ -126,23 +125,27 @@ Page {
             color: "white"
         }
 
+        // Filtro y orden en C++: los delegados ocultos no llegan a crearse
+        ExerciseFilterModel {
+            id: filterModel
+            exerciseModel: root.exerciseModel
+            searchText: root.searchQuery
+            selectedGroups: groupFilter.selectedGroups
+        }
+
         // Lista de ejercicios
         ListView {
             id: listView
             Layout.fillWidth: true
             Layout.fillHeight: true
             clip: true
-            model: exerciseModel
+            model: filterModel
             currentIndex: -1
             flickableDirection: Flickable.VerticalFlick
             interactive: contentHeight > height
 
             delegate: ExerciseDelegate {
-                property bool noGroupSelected: root.searchQuery === "" && noneSelected
-                property bool groupSelected: root.searchQuery === "" && groupsSelected.indexOf(muscleGroup) !== -1
-                property bool queryMatch: root.searchQuery !== "" && name.toLowerCase().indexOf(root.searchQuery.toLowerCase()) !== -1
-                height: (noGroupSelected || groupSelected || queryMatch) ? 60 : 0
-                visible: height > 1
+                height: 60
                 Component.onCompleted: {
                     console.log("Tenemos " + name + " e índice: " + index)
                     if (root.allOpened) {
@@ -165,7 +168,7 @@ Page {
 
             Label {
                 anchors.centerIn: parent
-                visible: listView.count === 0
+                visible: exerciseModel.count === 0
                 width: parent.width * 0.6
                 text: settings.language === "es"
                       ? "Agrega ejercicios a tu lista de ejercicios pulsando el botón 'Nuevo Ejercicio'."
@@ -286,6 +289,9 @@ Page {
         onlyExercise: true
         onConfirmedExercise: function(name) {
             dataCenter.removeExercise(name)
+            showToast(settings.language === "es"
+                ? "Ejercicio borrado · Toca para deshacer"
+                : "Exercise deleted · Tap to undo", true)
         }
     }
 
@@ -303,6 +309,8 @@ Page {
         opacity: 0
         visible: opacity > 0
 
+        property bool undoable: false
+
         Label {
             anchors.centerIn: parent
             text: ""
@@ -311,30 +319,40 @@ Page {
             font.family: Style.interFont.name
         }
 
+        // Deshacer el último cambio tocando el aviso
+        MouseArea {
+            anchors.fill: parent
+            enabled: toast.undoable && dataCenter.canUndo
+            onClicked: {
+                dataCenter.undo()
+                toast.opacity = 0
+            }
+        }
+
         Behavior on opacity {
             NumberAnimation { duration: 300 }
         }
 
         Timer {
             id: toastTimer
-            interval: 2000
+            interval: toast.undoable ? 4000 : 2000
             onTriggered: toast.opacity = 0
         }
 
-        function show(message) {
+        function show(message, undoable) {
             children[0].text = message;
+            toast.undoable = undoable === true;
             opacity = 1;
-            toastTimer.start();
+            toastTimer.restart();
         }
     }
 
-    function showToast(message) {
-        toast.show(message);
+    function showToast(message, undoable) {
+        toast.show(message, undoable);
     }
 
     Component.onCompleted: {
         console.log("Model count:", exerciseModel.count)
-        console.log("DataCenter data:", JSON.stringify(dataCenter.data))
     }
 
 }
@@ -14,6 +14,7 @@ Item {
     property bool singleSelection: false
     property string selectedGroup: "" // solo con singleSelection = true
     property var selectedGroups: []   // solo con singleSelection = false
+    property var groupCounts: null    // opcional: ejercicios por grupo (ExerciseFilterModel)
 
     ListModel {
         id: groupModel
@@ -66,6 +67,29 @@ Item {
                         }
                     }
 
+                    // Número de ejercicios del grupo
+                    Rectangle {
+                        visible: root.groupCounts !== null
+                        anchors.top: parent.top
+                        anchors.right: parent.right
+                        anchors.margins: 4
+                        width: Math.max(height, countText.implicitWidth + 8)
+                        height: countText.implicitHeight + 2
+                        radius: height / 2
+                        color: Style.muscleColor(name)
+                        opacity: model.selected ? 1.0 : 0.6
+
+                        Text {
+                            id: countText
+                            anchors.centerIn: parent
+                            text: root.groupCounts ? (root.groupCounts[name] || 0) : ""
+                            font.family: Style.interFont.name
+                            font.bold: true
+                            font.pixelSize: Style.caption
+                            color: "white"
+                        }
+                    }
+
                     MouseArea {
                         anchors.fill: parent
                         onClicked: {
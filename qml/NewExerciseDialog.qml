@@ -11,10 +11,13 @@ Dialog {
     anchors.centerIn: Overlay.overlay
     width: Math.min(parent.width * 0.9, 400)
 
-    property var exerciseProvider: ExerciseProvider{}
-    property var exerciseList: []
-    property var filteredExercises: []
-    property bool exercisesLoaded: false
+    // Búsqueda en C++ sobre el catálogo (nombres normalizados y alias es/en)
+    ExerciseSearchModel {
+        id: searchModel
+        query: nameField.text
+        onCountChanged: updatePopup()
+        onReadyChanged: updatePopup()
+    }
 
     signal exerciseSelected(string name, string group)
 
@@ -60,8 +63,8 @@ Dialog {
                 onTapped: {
                     nameField.forceActiveFocus()
 
-                    if (nameField.text === "" && exerciseList.length > 0) {
-                        refreshFilteredExercises()
+                    if (nameField.text === "") {
+                        updatePopup()
                     }
                 }
             }
@@ -80,13 +83,13 @@ Dialog {
                         nameField.forceActiveFocus()
 
                         if (nameField.text === "") {
-                            refreshFilteredExercises()
+                            updatePopup()
                         }
                     }
                 }
 
                 onFocusChanged: {
-                    if (focus && nameField.text !== "" && filteredExercises.length > 0) {
+                    if (focus && nameField.text !== "" && searchModel.count > 0) {
                         popupOpenTimer.start()
                     } else {
                         filteredExercisesPopup.close()
@@ -99,7 +102,7 @@ Dialog {
                     interval: 100
                     repeat: false
                     onTriggered: {
-                        if (nameField.focus && filteredExercises.length > 0) {
+                        if (nameField.focus && searchModel.count > 0) {
                             filteredExercisesPopup.open()
                         }
                     }
@@ -126,7 +129,7 @@ Dialog {
                             nameField.text = ""
                             nameField.forceActiveFocus()
                             newExerciseGroupFilter.deselectAll()
-                            refreshFilteredExercises()
+                            updatePopup()
                         }
                     }
                 }
@@ -140,7 +143,7 @@ Dialog {
             height: Math.min(6 * 42, filteredExercisesList.contentHeight)
             padding: 0
             closePolicy: Popup.CloseOnPressOutside | Popup.CloseOnEscape
-            visible: filteredExercises.length > 0 && nameField.focus && nameField.text.length >= 0
+            visible: searchModel.count > 0 && nameField.focus && nameField.text.length >= 0
 
             property bool hasMoreItems: filteredExercisesList.contentHeight > height
 
@@ -162,7 +165,7 @@ Dialog {
                 id: filteredExercisesList
                 anchors.fill: parent
                 clip: true
-                model: filteredExercises
+                model: searchModel
                 boundsBehavior: Flickable.StopAtBounds
 
                 ScrollBar.vertical: ScrollBar {
@@ -178,7 +181,7 @@ Dialog {
 
                     TapHandler {
                         id: tapArea
-                        onTapped: root.exerciseSelected(modelData.name, modelData.group)
+                        onTapped: root.exerciseSelected(model.name, model.group)
                     }
 
                     RowLayout {
@@ -202,25 +205,14 @@ Dialog {
                                         .replace(/'/g, "&#39;");
                                 }
 
-                                function normalize(str) {
-                                    return str.normalize("NFD").replace(/[\u0300-\u036f]/g, "").toLowerCase()
-                                }
-
-                                let input = nameField.text
-                                let query = normalize(input)
-                                let name = modelData.name
-                                let nameNormalized = normalize(name)
-
-                                let start = nameNormalized.indexOf(query)
-
-                                if (query.length === 0 || start === -1) {
-                                    return escapeHtml(name)
+                                if (model.matchStart < 0) {
+                                    return escapeHtml(model.name)
                                 }
 
-                                let end = start + query.length
-                                let before = escapeHtml(name.slice(0, start))
-                                let match = "<b>" + escapeHtml(name.slice(start, end)) + "</b>"
-                                let after = escapeHtml(name.slice(end))
+                                let end = model.matchStart + model.matchLength
+                                let before = escapeHtml(model.name.slice(0, model.matchStart))
+                                let match = "<b>" + escapeHtml(model.name.slice(model.matchStart, end)) + "</b>"
+                                let after = escapeHtml(model.name.slice(end))
                                 return before + match + after
                             }
                             font.pixelSize: 15
@@ -229,10 +221,10 @@ Dialog {
                         }
 
                         Text {
-                            text: modelData.group
+                            text: model.group
                             font.pixelSize: 12
                             font.weight: Font.Medium
-                            color: Style.muscleColor(modelData.group)
+                            color: Style.muscleColor(model.group)
                             Layout.rightMargin: 0
                         }
                     }
@@ -394,46 +386,8 @@ Dialog {
         filteredExercisesPopup.close()
     }
 
-    function refreshFilteredExercises() {
-        function normalizeText(text) {
-            return text.normalize("NFD").replace(/[\u0300-\u036f]/g, "").toLowerCase()
-        }
-
-        let query = normalizeText(nameField.text)
-        let seen = {}
-        let startsWith = []
-        let contains = []
-
-        if (query === "") {
-            // Si está vacío, mostrar todos ordenados
-            filteredExercises = [...exerciseList]
-                .filter(e => {
-                    let key = (e.name + "|" + e.group).toLowerCase()
-                    if (seen[key]) return false
-                    seen[key] = true
-                    return true
-                })
-                .sort((a, b) => a.name.localeCompare(b.name))
-        } else {
-            for (let i = 0; i < exerciseList.length; i++) {
-                let e = exerciseList[i]
-                let nameNormalized = normalizeText(e.name)
-                let groupNormalized = normalizeText(e.group)
-                let key = nameNormalized + "|" + groupNormalized
-
-                if (seen[key]) continue
-                seen[key] = true
-
-                if (nameNormalized.startsWith(query)) {
-                    startsWith.push(e)
-                } else if (nameNormalized.includes(query)) {
-                    contains.push(e)
-                }
-            }
-            filteredExercises = startsWith.concat(contains)
-        }
-
-        if (filteredExercises.length > 0 && nameField.focus) {
+    function updatePopup() {
+        if (searchModel.count > 0 && nameField.focus) {
             filteredExercisesPopup.open()
         } else {
             filteredExercisesPopup.close()
@@ -443,14 +397,7 @@ Dialog {
     Connections {
         target: nameField
         function onTextChanged() {
-            refreshFilteredExercises()
-        }
-    }
-
-    Connections {
-        target: exerciseProvider
-        function onExercisesChanged() {
-            exerciseList = exerciseProvider.exercises
+            updatePopup()
         }
     }
 
@@ -462,20 +409,4 @@ Dialog {
     }
 
     onOpened: resetForm()
-
-    Component.onCompleted: {
-        if (exerciseProvider) {
-            exerciseList = exerciseProvider.exercises
-
-            let seen = {}
-            for (let i = 0; i < exerciseList.length; i++) {
-                let key = (exerciseList[i].name + "|" + exerciseList[i].group).toLowerCase()
-                if (seen[key]) {
-                    console.warn("⚠️ Duplicado encontrado:", key)
-                } else {
-                    seen[key] = true
-                }
-            }
-        }
-    }
 }
@@ -3,6 +3,7 @@ import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
 import QtQuick.Dialogs
 import QtCore
+import gymWeights 1.0
 
 Page {
     id: root
@@ -56,6 +57,24 @@ Page {
             color: Style.text
             font.pixelSize: Style.heading1
             font.bold: true
+
+            // Siete toques seguidos muestran el panel oculto de diagnóstico
+            property int tapCount: 0
+            TapHandler {
+                onTapped: {
+                    parent.tapCount++
+                    tapReset.restart()
+                    if (parent.tapCount >= 7) {
+                        parent.tapCount = 0
+                        root.showDiagnostics()
+                    }
+                }
+            }
+            Timer {
+                id: tapReset
+                interval: 1500
+                onTriggered: parent.tapCount = 0
+            }
         }
     }
 
@@ -312,6 +331,7 @@ Page {
                         case "import": return importData;
                         case "test": return testData;
                         case "about": return aboutMe;
+                        case "diagnostics": return diagnosticsPanel;
                         default: return null;
                         }
                     }
@@ -638,8 +658,8 @@ Page {
 
             Label {
                 text: settings.language === "es"
-                      ? "Descarga un archivo con todos tus datos de ejercicios para hacer una copia de seguridad."
-                      : "Download a file with all your exercise data for backup."
+                      ? "Descarga un archivo con todos tus datos de ejercicios para hacer una copia de seguridad. Puede ser JSON, CSV o comprimido (.gz)."
+                      : "Download a file with all your exercise data for backup. It can be JSON, CSV or compressed (.gz)."
                 font.family: Style.interFont.name
                 font.pixelSize: Style.semi
                 color: Style.textSecondary
@@ -650,6 +670,17 @@ Page {
                 Layout.topMargin: Style.smallMargin
             }
 
+            CheckBox {
+                id: incrementalExport
+                text: settings.language === "es"
+                      ? "Sólo los cambios desde la última exportación (tras importar datos se exporta todo)"
+                      : "Only changes since the last export (everything is exported after an import)"
+                font.family: Style.interFont.name
+                font.pixelSize: Style.semi
+                Layout.leftMargin: Style.smallMargin
+                Layout.rightMargin: Style.smallMargin
+            }
+
             FloatButton {
                 Layout.alignment: Qt.AlignHCenter
                 Layout.topMargin: Style.smallSpace
@@ -659,7 +690,7 @@ Page {
                 font.pixelSize: Style.body
                 buttonText: settings.language === "es" ? "⬇️ Descargar archivo" : "⬇️ Download file"
                 onClicked: {
-                    fileDialog.setExportDataValues()
+                    fileDialog.setExportDataValues({ incremental: incrementalExport.checked })
                     fileDialog.open()
                 }
             }
@@ -676,8 +707,8 @@ Page {
 
             Label {
                 text: settings.language === "es"
-                      ? "Importa datos de ejercicios desde un archivo previamente exportado."
-                      : "Imports exercise data from a previously exported file."
+                      ? "Importa datos de ejercicios desde un archivo previamente exportado o un CSV de otra app. Se añaden a los actuales sin duplicar registros."
+                      : "Imports exercise data from a previously exported file or a CSV from another app. It is merged with your current data without duplicating records."
                 font.family: Style.interFont.name
                 font.pixelSize: Style.semi
                 color: Style.textSecondary
@@ -695,11 +726,20 @@ Page {
                 buttonColor: Style.buttonNeutral
                 font.pixelSize: Style.body
                 buttonText: settings.language === "es" ? "📂 Seleccionar archivo" : "📂 Select file"
+                enabled: !dataCenter.importing
                 onClicked: {
                     fileDialog.setImportaDataValues()
                     fileDialog.open()
                 }
             }
+
+            ProgressBar {
+                visible: dataCenter.importing
+                value: dataCenter.importProgress
+                Layout.fillWidth: true
+                Layout.leftMargin: Style.smallMargin
+                Layout.rightMargin: Style.smallMargin
+            }
         }
     }
 
@@ -811,6 +851,117 @@ Page {
     }
 
 
+    function showDiagnostics() {
+        for (let i = 0; i < settingsList.model.count; ++i) {
+            if (settingsList.model.get(i).type === "diagnostics")
+                return
+        }
+        settingsList.model.append({ name: "Diagnóstico", englishName: "Diagnostics", type: "diagnostics" })
+        settingsList.positionViewAtEnd()
+    }
+
+    // Panel oculto de diagnóstico: tiempos, contadores y volcado de la traza
+    Component {
+        id: diagnosticsPanel
+
+        ColumnLayout {
+            width: parent.width
+            spacing: Style.smallSpace
+
+            Label {
+                text: (settings.language === "es" ? "Escrituras pendientes: " : "Pending writes: ") + dataCenter.pendingWrites
+                      + "\n" + (settings.language === "es" ? "Último guardado: " : "Last save: ")
+                      + (dataCenter.lastSaveDuration >= 0 ? dataCenter.lastSaveDuration + " ms" : "-")
+                      + "\n" + (settings.language === "es" ? "Almacenamiento: " : "Storage: ") + dataCenter.storageBackend
+                font.family: Style.interFont.name
+                font.pixelSize: Style.semi
+                color: Style.textSecondary
+                Layout.fillWidth: true
+                Layout.leftMargin: Style.smallMargin
+                Layout.topMargin: Style.smallMargin
+            }
+
+            // Migra los datos al otro motor (ver StorageBackend)
+            FloatButton {
+                Layout.alignment: Qt.AlignHCenter
+                Layout.preferredHeight: implicitHeight
+                buttonColor: Style.buttonNeutral
+                font.pixelSize: Style.body
+                property string target: dataCenter.storageBackend === "sqlite" ? "binary" : "sqlite"
+                buttonText: (settings.language === "es" ? "Pasar a " : "Switch to ") + target
+                onClicked: dataCenter.storageBackend = target
+            }
+
+            Repeater {
+                model: StartupProfiler.phases
+                Label {
+                    required property var modelData
+                    text: "startup." + modelData.phase + ": " + modelData.elapsed + " ms"
+                    font.family: Style.interFont.name
+                    font.pixelSize: Style.caption
+                    color: Style.textSecondary
+                    Layout.fillWidth: true
+                    Layout.leftMargin: Style.smallMargin
+                }
+            }
+
+            Repeater {
+                model: Diagnostics.timers
+                Label {
+                    required property var modelData
+                    text: modelData.name + "  n=" + modelData.count
+                          + "  media " + modelData.meanMs.toFixed(2)
+                          + "  p95 " + modelData.p95Ms.toFixed(2)
+                          + "  máx " + modelData.maxMs.toFixed(2) + " ms"
+                    font.family: Style.interFont.name
+                    font.pixelSize: Style.caption
+                    color: Style.textSecondary
+                    wrapMode: Text.WrapAnywhere
+                    Layout.fillWidth: true
+                    Layout.leftMargin: Style.smallMargin
+                }
+            }
+
+            Repeater {
+                model: Diagnostics.counters
+                Label {
+                    required property var modelData
+                    text: modelData.name + ": " + modelData.value
+                    font.family: Style.interFont.name
+                    font.pixelSize: Style.caption
+                    color: Style.textSecondary
+                    Layout.fillWidth: true
+                    Layout.leftMargin: Style.smallMargin
+                }
+            }
+
+            RowLayout {
+                Layout.alignment: Qt.AlignHCenter
+                Layout.bottomMargin: Style.smallSpace
+                spacing: Style.smallSpace
+
+                FloatButton {
+                    Layout.preferredHeight: implicitHeight
+                    buttonColor: Style.buttonNeutral
+                    font.pixelSize: Style.body
+                    buttonText: settings.language === "es" ? "Guardar traza" : "Save trace"
+                    onClicked: {
+                        let path = Diagnostics.dumpTrace()
+                        globalMessage.show(settings.language === "es" ? "Traza" : "Trace", path, "info")
+                    }
+                }
+
+                FloatButton {
+                    Layout.preferredHeight: implicitHeight
+                    buttonColor: Style.buttonNeutral
+                    font.pixelSize: Style.body
+                    buttonText: settings.language === "es" ? "Reiniciar" : "Reset"
+                    onClicked: Diagnostics.reset()
+                }
+            }
+        }
+    }
+
     // Diálogo de confirmación para borrar datos
     ConfirmActionDialog {
         id: confirmDeleteAllDataDialog
@@ -847,6 +998,7 @@ Page {
 
         property string espText
         property string engText
+        property var exportOptions: ({})
 
         onAccepted: {
             console.log("Intentamos con file: " + file)
@@ -855,20 +1007,21 @@ Page {
             } else {
                 var filePath = file.toString().replace("file://", "")
                 console.log("Intentamos exportar con filePath: " + filePath)
-                dataCenter.exportData(filePath) //export Data
+                dataCenter.exportData(filePath, exportOptions) //export Data
             }
         }
 
         function setImportaDataValues() {
             fileDialog.fileMode = FileDialog.OpenFile
-            fileDialog.nameFilters = ["JSON files (*.json)"]
+            fileDialog.nameFilters = ["JSON files (*.json)", "CSV files (*.csv)", "Compressed files (*.gz)"]
             fileDialog.espText = "Selecciona un archivo desde el que importar los datos."
             fileDialog.engText = "Select a file to import data from."
         }
 
-        function setExportDataValues() {
+        function setExportDataValues(options) {
             fileDialog.fileMode = FileDialog.SaveFile
-            fileDialog.nameFilters = []
+            fileDialog.nameFilters = ["JSON files (*.json)", "CSV files (*.csv)", "Compressed files (*.gz)"]
+            fileDialog.exportOptions = options
             fileDialog.espText = "Selecciona una localización para guardar los datos en disco."
             fileDialog.engText = "Select a location to save the data on disk."
         }
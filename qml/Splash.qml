@@ -8,6 +8,17 @@ Rectangle {
 
     color: Style.background
 
+    // La splash no se retira hasta que los datos estén cargados
+    property bool ready: true
+    property bool minimumTimeElapsed: false
+
+    onReadyChanged: tryFinish()
+
+    function tryFinish() {
+        if (ready && minimumTimeElapsed && !fadeOutAnimation.running)
+            fadeOutAnimation.start()
+    }
+
     Image {
         id: splashImage
         source: "qrc:/icons/logoDresoft.png"
@@ -34,7 +45,10 @@ Rectangle {
         id: splashTimer
         interval: 1500  // 2 segundos de visualización
         running: fadeInAnimation.running ? false : true  // Espera a que termine el fade-in
-        onTriggered: fadeOutAnimation.start()
+        onTriggered: {
+            root.minimumTimeElapsed = true
+            root.tryFinish()
+        }
     }
 
     // Animación de salida (fade-out)
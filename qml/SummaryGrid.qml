@@ -8,77 +8,39 @@ Item {
     height: 90
     z: 1
 
-    property ListModel currentModel: ListModel {}
+    // HistorySeriesModel de GraphPage: valores y extremos de la ventana ya calculados
+    property var series: null
     property bool isWeight: true
     property string unitText: ""
     property string muscleGroup: ""
 
-    property var initialValue: calculateInitialValue()
-    property var recordValue: calculateRecordValue()
-    property var evolution: calculateEvolution()
-
-    function calculateInitialValue() {
-        if (currentModel.count === 0) return { value: 0, date: "" }
-        var first = currentModel.get(0)
-        return {
-            value: isWeight ? first.weight : first.reps,
-            date: first.date
-        }
-    }
+    readonly property bool hasData: series !== null && series.count > 0
 
-    function calculateRecordValue() {
-        if (currentModel.count === 0) return { value: 0, date: "" }
-
-        var record = currentModel.get(0)
-        for (var i = 1; i < currentModel.count; i++) {
-            var current = currentModel.get(i)
-            var currentVal = isWeight ? current.weight : current.reps
-            var recordVal = isWeight ? record.weight : record.reps
-
-            if (currentVal > recordVal) {
-                record = current
-            }
-        }
-
-        return {
-            value: isWeight ? record.weight : record.reps,
-            date: record.date
-        }
-    }
+    property var initialValue: ({
+        value: hasData ? series.firstValue : 0,
+        date: hasData ? series.firstTimestamp : ""
+    })
+    property var recordValue: ({
+        value: hasData ? series.maxValue : 0,
+        date: hasData ? series.recordTimestamp : ""
+    })
+    property var evolution: calculateEvolution()
 
     function calculateEvolution() {
-        if (currentModel.count < 2) return { value: 0, percent: 0, startDate: "", endDate: "" }
-
-        var first = currentModel.get(0)
-        var last = currentModel.get(currentModel.count-1)
-
-        var firstVal = isWeight ? first.weight : first.reps
-        var lastVal = isWeight ? last.weight : last.reps
+        if (!series || series.count < 2) return { value: 0, percent: 0, startDate: "", endDate: "" }
 
-        var diff = lastVal - firstVal
+        var firstVal = series.firstValue
+        var diff = series.lastValue - firstVal
         var percent = firstVal !== 0 ? (diff / firstVal) * 100 : 0
 
         return {
             value: diff,
             percent: percent,
-            startDate: first.date,
-            endDate: last.date
+            startDate: series.firstTimestamp,
+            endDate: series.lastTimestamp
         }
     }
 
-    Connections {
-        target: currentModel
-        function onCountChanged() { updateValues() }
-    }
-
-    onIsWeightChanged: updateValues()
-
-    function updateValues() {
-        initialValue = calculateInitialValue()
-        recordValue = calculateRecordValue()
-        evolution = calculateEvolution()
-    }
-
     Rectangle {
         anchors.fill: parent
         color: Style.background
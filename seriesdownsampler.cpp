@@ -0,0 +1,126 @@
+#include "seriesdownsampler.h"
+#include <algorithm>
+#include <numeric>
+
+void SeriesDownsampler::append(const QList<double>& values) {
+    const int index = int(values.size()) - 1;
+    const double value = values.at(index);
+
+    for (auto it = m_levels.begin(); it != m_levels.end(); ++it) {
+        Level& level = it.value();
+        if (level.size != index) {
+            // Nivel desfasado: se rehará la próxima vez que se pida
+            level.size = -1;
+            continue;
+        }
+
+        const int bucket = index / level.bucketSize;
+        if (bucket == level.minIndex.size()) {
+            level.minIndex.append(index);
+            level.maxIndex.append(index);
+        } else {
+            if (value < values.at(level.minIndex.at(bucket)))
+                level.minIndex[bucket] = index;
+            if (value > values.at(level.maxIndex.at(bucket)))
+                level.maxIndex[bucket] = index;
+        }
+        level.size = index + 1;
+    }
+}
+
+const SeriesDownsampler::Level& SeriesDownsampler::level(const QList<double>& values, int bucketSize) {
+    const int size = int(values.size());
+    Level& level = m_levels[bucketSize];
+    if (level.size == size && level.bucketSize == bucketSize)
+        return level;
+
+    level.bucketSize = bucketSize;
+    level.size = size;
+    const int buckets = (size + bucketSize - 1) / bucketSize;
+    level.minIndex.resize(buckets);
+    level.maxIndex.resize(buckets);
+
+    // Si el nivel más fino está al día, cada tramo sale de juntar dos suyos
+    const auto finer = m_levels.constFind(bucketSize / 2);
+    if (bucketSize > 1 && finer != m_levels.constEnd() && finer->size == size) {
+        for (int b = 0; b < buckets; ++b) {
+            const int left = 2 * b;
+            const int right = std::min(left + 1, int(finer->minIndex.size()) - 1);
+            const int minLeft = finer->minIndex.at(left), minRight = finer->minIndex.at(right);
+            const int maxLeft = finer->maxIndex.at(left), maxRight = finer->maxIndex.at(right);
+            level.minIndex[b] = values.at(minRight) < values.at(minLeft) ? minRight : minLeft;
+            level.maxIndex[b] = values.at(maxRight) > values.at(maxLeft) ? maxRight : maxLeft;
+        }
+        return level;
+    }
+
+    for (int b = 0; b < buckets; ++b) {
+        const int begin = b * bucketSize;
+        const int end = std::min(size, begin + bucketSize);
+        int minIndex = begin, maxIndex = begin;
+        for (int i = begin + 1; i < end; ++i) {
+            if (values.at(i) < values.at(minIndex)) minIndex = i;
+            if (values.at(i) > values.at(maxIndex)) maxIndex = i;
+        }
+        level.minIndex[b] = minIndex;
+        level.maxIndex[b] = maxIndex;
+    }
+    return level;
+}
+
+void SeriesDownsampler::appendBucket(const QList<double>& values, int begin, int end, QList<int>* result) {
+    int minIndex = begin, maxIndex = begin;
+    for (int i = begin + 1; i < end; ++i) {
+        if (values.at(i) < values.at(minIndex)) minIndex = i;
+        if (values.at(i) > values.at(maxIndex)) maxIndex = i;
+    }
+    result->append(std::min(minIndex, maxIndex));
+    result->append(std::max(minIndex, maxIndex));
+}
+
+QList<int> SeriesDownsampler::sample(const QList<double>& values, int first, int maxPoints, const QList<int>& keep) {
+    const int size = int(values.size());
+    const int length = size - first;
+    QList<int> result;
+    if (length <= 0)
+        return result;
+
+    if (maxPoints <= 0 || length <= maxPoints) {
+        result.resize(length);
+        std::iota(result.begin(), result.end(), first);
+        return result;
+    }
+
+    // Dos puntos por tramo. Se cuentan los tramos que toca la ventana, incluido
+    // el primero aunque empiece a mitad; con un tramo que cubra toda la serie
+    // siempre se cumple, así que el bucle termina para cualquier presupuesto
+    const int buckets = std::max(1, maxPoints / 2 - 1);
+    int bucketSize = 2;
+    while ((size - 1) / bucketSize - first / bucketSize + 1 > buckets)
+        bucketSize *= 2;
+
+    result.reserve(2 * (buckets + 2) + keep.size());
+    result.append(first);
+
+    int bucket = first / bucketSize;
+    if (first % bucketSize != 0) {
+        appendBucket(values, first, std::min(size, (bucket + 1) * bucketSize), &result);
+        ++bucket;
+    }
+
+    const Level& cached = level(values, bucketSize);
+    for (; bucket < cached.minIndex.size(); ++bucket) {
+        result.append(std::min(cached.minIndex.at(bucket), cached.maxIndex.at(bucket)));
+        result.append(std::max(cached.minIndex.at(bucket), cached.maxIndex.at(bucket)));
+    }
+
+    result.append(size - 1);
+    for (int index : keep) {
+        if (index >= first && index < size)
+            result.append(index);
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
@@ -0,0 +1,42 @@
+#ifndef SERIESDOWNSAMPLER_H
+#define SERIESDOWNSAMPLER_H
+
+#include <QHash>
+#include <QList>
+
+// Reduce una serie larga a los puntos que caben en pantalla. El historial se
+// divide en tramos de un tamaño potencia de dos y de cada tramo se conservan
+// el mínimo y el máximo en su orden, así que los picos no se pierden y lo que
+// se dibuja son registros reales, no promedios.
+//
+// Los tramos se alinean con el principio del historial y cada nivel (tamaño
+// de tramo) se guarda en caché: cambiar de periodo o de ancho reutiliza los
+// niveles ya calculados, y añadir un registro al final sólo toca el último
+// tramo de cada nivel.
+class SeriesDownsampler
+{
+public:
+    void invalidate() { m_levels.clear(); }
+    // values ya incluye el registro nuevo en la última posición
+    void append(const QList<double>& values);
+
+    // Índices (absolutos y crecientes) que dibujar de [first, values.size())
+    // con unos maxPoints puntos como mucho (0: todos). Siempre incluye los
+    // extremos de la ventana y los índices de keep que caigan dentro.
+    QList<int> sample(const QList<double>& values, int first, int maxPoints, const QList<int>& keep);
+
+private:
+    struct Level {
+        int bucketSize = 0;
+        int size = 0; // registros cubiertos
+        QList<int> minIndex;
+        QList<int> maxIndex;
+    };
+
+    QHash<int, Level> m_levels; // por tamaño de tramo
+
+    const Level& level(const QList<double>& values, int bucketSize);
+    static void appendBucket(const QList<double>& values, int begin, int end, QList<int>* result);
+};
+
+#endif // SERIESDOWNSAMPLER_H
@@ -0,0 +1,512 @@
+#include "sqlitestorage.h"
+#include "logging.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <utility>
+
+namespace {
+constexpr auto kSequenceKey = "journalSequence";
+
+const char* const kSchema[] = {
+    "CREATE TABLE IF NOT EXISTS exercises ("
+    " id INTEGER PRIMARY KEY,"
+    " name TEXT NOT NULL UNIQUE,"
+    " muscle_group TEXT NOT NULL)",
+    "CREATE TABLE IF NOT EXISTS history ("
+    " exercise_id INTEGER NOT NULL,"
+    " timestamp INTEGER NOT NULL,"
+    " value REAL NOT NULL,"
+    " sets INTEGER NOT NULL,"
+    " repetitions INTEGER NOT NULL,"
+    " unit TEXT NOT NULL)",
+    "CREATE INDEX IF NOT EXISTS history_exercise_timestamp ON history (exercise_id, timestamp)",
+    "CREATE TABLE IF NOT EXISTS metadata (key TEXT PRIMARY KEY, value TEXT NOT NULL)",
+    "CREATE TABLE IF NOT EXISTS journal (sequence INTEGER PRIMARY KEY, record TEXT NOT NULL)",
+    "CREATE TABLE IF NOT EXISTS rollup ("
+    " id INTEGER PRIMARY KEY CHECK (id = 0),"
+    " sequence INTEGER NOT NULL,"
+    " data BLOB NOT NULL)"
+};
+
+// Un valor JSON suelto como texto ("3", "\"kg\"", "{...}")
+QString encodeValue(const QJsonValue& value) {
+    const QByteArray json = QJsonDocument(QJsonArray{value}).toJson(QJsonDocument::Compact);
+    return QString::fromUtf8(json.mid(1, json.size() - 2));
+}
+
+QJsonValue decodeValue(const QString& text) {
+    return QJsonDocument::fromJson("[" + text.toUtf8() + "]").array().at(0);
+}
+}
+
+SqliteStorage::SqliteStorage(const QString& filePath)
+    : m_filePath(filePath),
+      m_connectionName(QStringLiteral("storage-%1").arg(quintptr(this), 0, 16)) {}
+
+SqliteStorage::~SqliteStorage() {
+    close();
+}
+
+void SqliteStorage::close() {
+    if (!m_open)
+        return;
+    database().close();
+    QSqlDatabase::removeDatabase(m_connectionName);
+    m_open = false;
+}
+
+bool SqliteStorage::exists() const {
+    return QFile::exists(m_filePath);
+}
+
+QSqlDatabase SqliteStorage::database() const {
+    return QSqlDatabase::database(m_connectionName, false);
+}
+
+bool SqliteStorage::open() {
+    if (m_open)
+        return true;
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), m_connectionName);
+        db.setDatabaseName(m_filePath);
+        if (!db.open()) {
+            qCWarning(lcPersistence) << "SqliteStorage: no se pudo abrir" << m_filePath << db.lastError().text();
+            db = QSqlDatabase();
+            QSqlDatabase::removeDatabase(m_connectionName);
+            return false;
+        }
+    }
+    m_open = true;
+
+    // WAL: una transacción confirmada es un añadido al final del -wal; con
+    // synchronous=NORMAL sólo se sincroniza al volcarlo a la base de datos
+    exec(QStringLiteral("PRAGMA journal_mode=WAL"));
+    exec(QStringLiteral("PRAGMA synchronous=NORMAL"));
+    for (const char* statement : kSchema) {
+        if (!exec(QString::fromLatin1(statement)))
+            return false;
+    }
+
+    QSqlQuery query(database());
+    query.prepare(QStringLiteral("SELECT value FROM metadata WHERE key = ?"));
+    query.addBindValue(QString::fromLatin1(kSequenceKey));
+    m_sequence = exec(query) && query.next() ? query.value(0).toLongLong() : -1;
+
+    QSqlQuery journal(database());
+    m_pendingJournal = journal.exec(QStringLiteral("SELECT 1 FROM journal LIMIT 1")) && journal.next();
+
+    QSqlQuery rollup(database());
+    m_rollupSequence = rollup.exec(QStringLiteral("SELECT sequence FROM rollup")) && rollup.next()
+                       ? rollup.value(0).toLongLong() : -1;
+    return true;
+}
+
+bool SqliteStorage::exec(QSqlQuery& query) const {
+    if (!query.exec()) {
+        qCWarning(lcPersistence) << "SqliteStorage:" << query.lastError().text() << query.lastQuery();
+        return false;
+    }
+    return true;
+}
+
+bool SqliteStorage::exec(const QString& statement) const {
+    QSqlQuery query(database());
+    if (!query.exec(statement)) {
+        qCWarning(lcPersistence) << "SqliteStorage:" << query.lastError().text() << statement;
+        return false;
+    }
+    return true;
+}
+
+bool SqliteStorage::transaction(const std::function<bool()>& body) {
+    QSqlDatabase db = database();
+    if (!db.transaction())
+        return false;
+    if (!body()) {
+        db.rollback();
+        return false;
+    }
+    return db.commit();
+}
+
+StorageBackend::LoadResult SqliteStorage::load() {
+    LoadResult result;
+    if (!exists() || !open() || m_sequence < 0)
+        return result;
+
+    ExerciseStore& store = result.store;
+
+    QSqlQuery exercises(database());
+    exercises.setForwardOnly(true);
+    if (!exercises.exec(QStringLiteral("SELECT id, name, muscle_group FROM exercises ORDER BY name")))
+        return result;
+
+    QList<ExerciseStore::Exercise> loaded;
+    QHash<qint64, int> rows;
+    while (exercises.next()) {
+        ExerciseStore::Exercise exercise;
+        exercise.name = exercises.value(1).toString();
+        exercise.muscleGroupId = store.internMuscleGroup(exercises.value(2).toString());
+        rows.insert(exercises.value(0).toLongLong(), int(loaded.size()));
+        loaded.append(exercise);
+    }
+
+    // Un solo recorrido del índice (exercise_id, timestamp): cada historial
+    // llega ya en orden cronológico y en orden de llegada si coinciden las fechas
+    QSqlQuery history(database());
+    history.setForwardOnly(true);
+    if (!history.exec(QStringLiteral("SELECT exercise_id, timestamp, value, sets, repetitions, unit"
+                                     " FROM history ORDER BY exercise_id, timestamp, rowid")))
+        return result;
+
+    qint64 currentId = -1;
+    ExerciseStore::History* current = nullptr;
+    int rejected = 0;
+    while (history.next()) {
+        const qint64 id = history.value(0).toLongLong();
+        if (id != currentId) {
+            currentId = id;
+            const int row = rows.value(id, -1);
+            current = row >= 0 ? &loaded[row].history : nullptr;
+        }
+        if (!current)
+            continue;
+
+        // La base de datos no limita los enteros: lo que no cabe en las
+        // columnas del historial se descarta en vez de truncarse
+        ExerciseStore::Record record;
+        record.sets = history.value(3).toInt();
+        record.repetitions = history.value(4).toInt();
+        record.unitId = store.internUnit(history.value(5).toString());
+        if (!record.fits()) {
+            ++rejected;
+            continue;
+        }
+        current->timestamps.append(history.value(1).toLongLong());
+        current->values.append(history.value(2).toDouble());
+        current->sets.append(qint16(record.sets));
+        current->repetitions.append(qint16(record.repetitions));
+        current->unitIds.append(quint8(record.unitId));
+    }
+    if (rejected > 0)
+        qCWarning(lcPersistence) << "SqliteStorage:" << rejected << "registros fuera de rango descartados";
+
+    // Los resúmenes guardados sólo valen si reflejan las mismas filas
+    QByteArray rollup;
+    QSqlQuery rollupQuery(database());
+    if (m_rollupSequence == m_sequence && rejected == 0
+        && rollupQuery.exec(QStringLiteral("SELECT data FROM rollup")) && rollupQuery.next())
+        rollup = rollupQuery.value(0).toByteArray();
+    if (rollup.isEmpty())
+        qCDebug(lcPersistence) << "SqliteStorage: resúmenes desactualizados, se rehacen";
+    store.adoptExercises(std::move(loaded), rollup);
+
+    QSqlQuery metadata(database());
+    if (metadata.exec(QStringLiteral("SELECT key, value FROM metadata"))) {
+        while (metadata.next()) {
+            const QString key = metadata.value(0).toString();
+            if (key != QLatin1String(kSequenceKey))
+                store.setMetadata(key, decodeValue(metadata.value(1).toString()));
+        }
+    }
+
+    QSqlQuery journal(database());
+    journal.prepare(QStringLiteral("SELECT record FROM journal WHERE sequence > ? ORDER BY sequence"));
+    journal.addBindValue(m_sequence);
+    if (exec(journal)) {
+        while (journal.next())
+            result.journal.append(QJsonDocument::fromJson(journal.value(0).toString().toUtf8()).object());
+    }
+
+    result.sequence = m_sequence;
+    result.snapshotFound = true;
+    qCDebug(lcPersistence) << "SqliteStorage:" << store.count() << "ejercicios cargados";
+    return result;
+}
+
+bool SqliteStorage::append(const QJsonObject& record) {
+    if (!open())
+        return false;
+
+    const qint64 sequence = record["seq"].toInteger();
+    if (!m_pendingJournal) {
+        const bool applied = transaction([&]() {
+            return applyRecord(record) && setMetadata(QString::fromLatin1(kSequenceKey), sequence);
+        });
+        if (applied) {
+            m_sequence = sequence;
+            return true;
+        }
+    }
+
+    // A partir de aquí todo va al diario, en orden, hasta el próximo snapshot
+    QSqlQuery query(database());
+    query.prepare(QStringLiteral("INSERT OR REPLACE INTO journal (sequence, record) VALUES (?, ?)"));
+    query.addBindValue(sequence);
+    query.addBindValue(QString::fromUtf8(QJsonDocument(record).toJson(QJsonDocument::Compact)));
+    if (!exec(query))
+        return false;
+
+    if (!m_pendingJournal)
+        qCDebug(lcPersistence) << "SqliteStorage:" << record["op"].toString() << "se guarda en el diario";
+    m_pendingJournal = true;
+    return true;
+}
+
+bool SqliteStorage::applyRecord(const QJsonObject& record) {
+    const QString op = record["op"].toString();
+    const QString name = record["name"].toString();
+
+    if (op == "addExercise") {
+        // Sustituye por completo al ejercicio del mismo nombre
+        qint64 id = exerciseId(name);
+        if (id >= 0) {
+            QSqlQuery query(database());
+            query.prepare(QStringLiteral("UPDATE exercises SET muscle_group = ? WHERE id = ?"));
+            query.addBindValue(record["muscleGroup"].toString());
+            query.addBindValue(id);
+            QSqlQuery history(database());
+            history.prepare(QStringLiteral("DELETE FROM history WHERE exercise_id = ?"));
+            history.addBindValue(id);
+            if (!exec(query) || !exec(history))
+                return false;
+        } else {
+            id = insertExercise(name, record["muscleGroup"].toString());
+            if (id < 0)
+                return false;
+        }
+
+        const bool onlyExerciseName = record["value"].toDouble() == 0 && record["sets"].toInt() == 0
+                                      && record["repetitions"].toInt() == 0;
+        return onlyExerciseName || insertRecord(id, record);
+    } else if (op == "updateExercise") {
+        const qint64 id = exerciseId(name);
+        return id >= 0 && insertRecord(id, record);
+    } else if (op == "removeExercise") {
+        const qint64 id = exerciseId(name);
+        return id < 0 || removeExercise(id);
+    } else if (op == "removeHistoryEntry") {
+        // Posición en el historial cronológico: se resuelve sobre el índice
+        QSqlQuery query(database());
+        query.prepare(QStringLiteral("DELETE FROM history WHERE rowid = ("
+                                     " SELECT rowid FROM history WHERE exercise_id = ?"
+                                     " ORDER BY timestamp, rowid LIMIT 1 OFFSET ?)"));
+        query.addBindValue(exerciseId(name));
+        query.addBindValue(record["index"].toInt());
+        return exec(query) && query.numRowsAffected() == 1;
+    } else if (op == "setMetadata") {
+        return setMetadata(record["key"].toString(), record["value"]);
+    } else if (op == "batch") {
+        const QJsonArray mutations = record["mutations"].toArray();
+        for (const QJsonValue& value : mutations) {
+            if (!applyRecord(value.toObject()))
+                return false;
+        }
+        return true;
+    } else if (op == "changes") {
+        const QJsonArray changes = record["changes"].toArray();
+        for (const QJsonValue& value : changes) {
+            if (!applyChange(value.toObject()))
+                return false;
+        }
+        return true;
+    }
+
+    // "import" y lo que venga: se resuelve al reescribir las tablas
+    return false;
+}
+
+bool SqliteStorage::applyChange(const QJsonObject& change) {
+    // Mismo criterio que DataCenter::applyChanges: lo que no aplica se salta
+    const QString type = change["type"].toString();
+    const qint64 id = exerciseId(change["name"].toString());
+
+    if (type == "addRecord") {
+        return id < 0 || insertRecord(id, change["record"].toObject());
+    } else if (type == "removeRecord") {
+        const QJsonObject record = change["record"].toObject();
+        QSqlQuery query(database());
+        query.prepare(QStringLiteral("DELETE FROM history WHERE rowid = ("
+                                     " SELECT rowid FROM history WHERE exercise_id = ? AND timestamp = ?"
+                                     " AND value = ? AND sets = ? AND repetitions = ? AND unit = ?"
+                                     " ORDER BY rowid LIMIT 1)"));
+        query.addBindValue(id);
+        query.addBindValue(ExerciseStore::parseTimestamp(record["timestamp"].toString()));
+        query.addBindValue(record["value"].toDouble());
+        query.addBindValue(record["sets"].toInt());
+        query.addBindValue(record["repetitions"].toInt());
+        query.addBindValue(record["unit"].toString());
+        return exec(query);
+    } else if (type == "addExercise") {
+        if (id >= 0)
+            return true;
+        const QJsonObject exercise = change["exercise"].toObject();
+        const qint64 inserted = insertExercise(change["name"].toString(), exercise["muscleGroup"].toString());
+        if (inserted < 0)
+            return false;
+        const QJsonArray history = exercise["history"].toArray();
+        for (const QJsonValue& entry : history) {
+            if (!insertRecord(inserted, entry.toObject()))
+                return false;
+        }
+        return true;
+    } else if (type == "removeExercise") {
+        return id < 0 || removeExercise(id);
+    }
+
+    return false;
+}
+
+bool SqliteStorage::writeSnapshot(const ExerciseStore& store, qint64 sequence) {
+    if (!open())
+        return false;
+
+    // Las mutaciones ya se escribieron fila a fila: sólo quedan los resúmenes
+    if (!m_pendingJournal && m_sequence >= sequence) {
+        if (m_sequence > sequence || m_rollupSequence == sequence)
+            return true;
+        return writeRollup(store, sequence);
+    }
+
+    if (!transaction([&]() { return writeTables(store, sequence) && writeRollup(store, sequence); }))
+        return false;
+    m_sequence = sequence;
+
+    // Los registros posteriores a la copia (seq > sequence) se conservan
+    QSqlQuery journal(database());
+    m_pendingJournal = journal.exec(QStringLiteral("SELECT 1 FROM journal LIMIT 1")) && journal.next();
+
+    // Tras reescribirlo todo se vuelca el -wal para que no crezca sin límite
+    exec(QStringLiteral("PRAGMA wal_checkpoint(TRUNCATE)"));
+    return true;
+}
+
+bool SqliteStorage::writeTables(const ExerciseStore& store, qint64 sequence) {
+    QSqlQuery journal(database());
+    journal.prepare(QStringLiteral("DELETE FROM journal WHERE sequence <= ?"));
+    journal.addBindValue(sequence);
+    if (!exec(QStringLiteral("DELETE FROM history")) || !exec(QStringLiteral("DELETE FROM exercises"))
+        || !exec(QStringLiteral("DELETE FROM metadata")) || !exec(journal))
+        return false;
+
+    QSqlQuery exercise(database());
+    exercise.prepare(QStringLiteral("INSERT INTO exercises (id, name, muscle_group) VALUES (?, ?, ?)"));
+    QSqlQuery record(database());
+    record.prepare(QStringLiteral("INSERT INTO history (exercise_id, timestamp, value, sets, repetitions, unit)"
+                                  " VALUES (?, ?, ?, ?, ?, ?)"));
+
+    // Los registros se insertan en orden: el rowid conserva el orden de llegada
+    const QStringList units = store.units();
+    for (int row = 0; row < store.count(); ++row) {
+        const ExerciseStore::Exercise& current = store.at(row);
+        exercise.bindValue(0, row + 1);
+        exercise.bindValue(1, current.name);
+        exercise.bindValue(2, store.muscleGroup(current));
+        if (!exec(exercise))
+            return false;
+
+        const ExerciseStore::History& history = current.history;
+        for (int i = 0; i < history.size(); ++i) {
+            record.bindValue(0, row + 1);
+            record.bindValue(1, history.timestampAt(i));
+            record.bindValue(2, history.valueAt(i));
+            record.bindValue(3, history.setsAt(i));
+            record.bindValue(4, history.repetitionsAt(i));
+            record.bindValue(5, units.value(history.unitIdAt(i)));
+            if (!exec(record))
+                return false;
+        }
+    }
+
+    const QJsonObject metadata = store.metadata();
+    for (auto it = metadata.constBegin(); it != metadata.constEnd(); ++it) {
+        if (!setMetadata(it.key(), it.value()))
+            return false;
+    }
+    return setMetadata(QString::fromLatin1(kSequenceKey), sequence);
+}
+
+bool SqliteStorage::writeRollup(const ExerciseStore& store, qint64 sequence) {
+    // Un blob con TrainingRollup::serialize, como la sección del snapshot binario
+    QSqlQuery query(database());
+    query.prepare(QStringLiteral("INSERT OR REPLACE INTO rollup (id, sequence, data) VALUES (0, ?, ?)"));
+    query.addBindValue(sequence);
+    query.addBindValue(store.rollup().serialize(store.muscleGroups()));
+    if (!exec(query))
+        return false;
+    m_rollupSequence = sequence;
+    return true;
+}
+
+bool SqliteStorage::clear() {
+    // Se borran los ficheros: así exists() deja de verlo y la siguiente carga
+    // no abre una base de datos vacía. El siguiente uso la vuelve a crear
+    close();
+    m_sequence = -1;
+    m_rollupSequence = -1;
+    m_pendingJournal = false;
+
+    bool ok = true;
+    for (const QString& suffix : {QString(), QStringLiteral("-wal"), QStringLiteral("-shm")}) {
+        const QString path = m_filePath + suffix;
+        if (QFile::exists(path) && !QFile::remove(path)) {
+            qCWarning(lcPersistence) << "SqliteStorage: no se pudo borrar" << path;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool SqliteStorage::setMetadata(const QString& key, const QJsonValue& value) {
+    QSqlQuery query(database());
+    query.prepare(QStringLiteral("INSERT OR REPLACE INTO metadata (key, value) VALUES (?, ?)"));
+    query.addBindValue(key);
+    query.addBindValue(encodeValue(value));
+    return exec(query);
+}
+
+qint64 SqliteStorage::exerciseId(const QString& name) const {
+    QSqlQuery query(database());
+    query.prepare(QStringLiteral("SELECT id FROM exercises WHERE name = ?"));
+    query.addBindValue(name);
+    return exec(query) && query.next() ? query.value(0).toLongLong() : -1;
+}
+
+qint64 SqliteStorage::insertExercise(const QString& name, const QString& muscleGroup) {
+    QSqlQuery query(database());
+    query.prepare(QStringLiteral("INSERT INTO exercises (name, muscle_group) VALUES (?, ?)"));
+    query.addBindValue(name);
+    query.addBindValue(muscleGroup);
+    return exec(query) ? query.lastInsertId().toLongLong() : -1;
+}
+
+bool SqliteStorage::removeExercise(qint64 id) {
+    QSqlQuery history(database());
+    history.prepare(QStringLiteral("DELETE FROM history WHERE exercise_id = ?"));
+    history.addBindValue(id);
+    QSqlQuery exercise(database());
+    exercise.prepare(QStringLiteral("DELETE FROM exercises WHERE id = ?"));
+    exercise.addBindValue(id);
+    return exec(history) && exec(exercise);
+}
+
+bool SqliteStorage::insertRecord(qint64 exerciseId, const QJsonObject& record) {
+    // Un registro es una fila; el índice lo coloca junto al resto del historial
+    QSqlQuery query(database());
+    query.prepare(QStringLiteral("INSERT INTO history (exercise_id, timestamp, value, sets, repetitions, unit)"
+                                 " VALUES (?, ?, ?, ?, ?, ?)"));
+    query.addBindValue(exerciseId);
+    query.addBindValue(ExerciseStore::parseTimestamp(record["timestamp"].toString()));
+    query.addBindValue(record["value"].toDouble());
+    query.addBindValue(record["sets"].toInt());
+    query.addBindValue(record["repetitions"].toInt());
+    query.addBindValue(record["unit"].toString());
+    return exec(query);
+}
@@ -0,0 +1,68 @@
+#ifndef SQLITESTORAGE_H
+#define SQLITESTORAGE_H
+
+#include <QSqlDatabase>
+#include <functional>
+#include "storagebackend.h"
+
+class QSqlQuery;
+
+// Motor SQLite (driver QSQLITE incluido en Qt) en modo WAL:
+//
+//   exercises(id, name, muscle_group)
+//   history(exercise_id, timestamp, value, sets, repetitions, unit)
+//       índice (exercise_id, timestamp): el historial de un ejercicio se lee
+//       ya ordenado y un registro se localiza por posición sin ordenar nada
+//   metadata(key, value)  valores JSON; "journalSequence" es la secuencia guardada
+//   journal(sequence, record)
+//   rollup(sequence, data)  resúmenes (TrainingRollup::serialize) a esa secuencia;
+//       se cargan si coincide con la de las tablas y si no se rehacen
+//
+// Cada mutación se traduce a escrituras de filas en una transacción (añadir
+// un registro es un INSERT), así que si las tablas ya están al día
+// writeSnapshot() sólo guarda los resúmenes. Lo que no se traduce a filas
+// (importar) va a la tabla journal y el siguiente snapshot reescribe las tablas.
+//
+// La conexión se abre en el primer uso y sólo se usa desde el hilo del worker.
+class SqliteStorage : public StorageBackend
+{
+public:
+    explicit SqliteStorage(const QString& filePath);
+    ~SqliteStorage() override;
+
+    Kind kind() const override { return Sqlite; }
+    bool exists() const override;
+
+    LoadResult load() override;
+    bool append(const QJsonObject& record) override;
+    bool writeSnapshot(const ExerciseStore& store, qint64 sequence) override;
+    bool clear() override;
+
+private:
+    QString m_filePath;
+    QString m_connectionName;
+    bool m_open = false;
+    qint64 m_sequence = -1;         // secuencia que reflejan las tablas; -1 sin datos
+    bool m_pendingJournal = false;  // hay registros en journal: las tablas van por detrás
+    qint64 m_rollupSequence = -1;   // secuencia de los resúmenes guardados
+
+    QSqlDatabase database() const;
+    bool open();
+    void close();
+    bool exec(QSqlQuery& query) const;
+    bool exec(const QString& statement) const;
+    bool transaction(const std::function<bool()>& body);
+
+    bool applyRecord(const QJsonObject& record);
+    bool applyChange(const QJsonObject& change);
+    bool writeTables(const ExerciseStore& store, qint64 sequence);
+    bool writeRollup(const ExerciseStore& store, qint64 sequence);
+    bool setMetadata(const QString& key, const QJsonValue& value);
+
+    qint64 exerciseId(const QString& name) const;
+    qint64 insertExercise(const QString& name, const QString& muscleGroup);
+    bool removeExercise(qint64 id);
+    bool insertRecord(qint64 exerciseId, const QJsonObject& record);
+};
+
+#endif // SQLITESTORAGE_H
@@ -0,0 +1,29 @@
+#include "startupprofiler.h"
+#include "logging.h"
+#include <QVariantMap>
+
+StartupProfiler::StartupProfiler(QObject *parent) : QObject(parent) {
+    m_timer.start();
+}
+
+void StartupProfiler::mark(const QString& phase) {
+    // Cada fase se registra una sola vez (p.ej. dataReady tras recargar no cuenta)
+    for (const auto& entry : std::as_const(m_phases)) {
+        if (entry.first == phase)
+            return;
+    }
+
+    const qint64 elapsed = m_timer.elapsed();
+    const qint64 previous = m_phases.isEmpty() ? 0 : m_phases.constLast().second;
+    m_phases.append({phase, elapsed});
+
+    qCDebug(lcStartup).noquote() << QString("Arranque: %1 en %2 ms (+%3 ms)").arg(phase).arg(elapsed).arg(elapsed - previous);
+    emit phasesChanged();
+}
+
+QVariantList StartupProfiler::phases() const {
+    QVariantList result;
+    for (const auto& [phase, elapsed] : m_phases)
+        result.append(QVariantMap{{"phase", phase}, {"elapsed", elapsed}});
+    return result;
+}
@@ -0,0 +1,32 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <QVariantList>
+
+// Tiempos de cada fase del arranque (motor QML, carga de Main.qml, datos
+// listos, primer frame) medidos desde el inicio de main(). Se registra como
+// singleton para que QML pueda marcar fases.
+class StartupProfiler : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariantList phases READ phases NOTIFY phasesChanged)
+
+public:
+    explicit StartupProfiler(QObject *parent = nullptr);
+
+    Q_INVOKABLE void mark(const QString& phase);
+    QVariantList phases() const;
+
+signals:
+    void phasesChanged();
+
+private:
+    QElapsedTimer m_timer;
+    QList<QPair<QString, qint64>> m_phases;
+};
+
+#endif // STARTUPPROFILER_H
@@ -0,0 +1,25 @@
+#include "storagebackend.h"
+#include "binarystorage.h"
+#include "sqlitestorage.h"
+
+std::unique_ptr<StorageBackend> StorageBackend::create(Kind kind, const QString& directory) {
+    switch (kind) {
+    case Sqlite:
+        return std::make_unique<SqliteStorage>(directory + "/exercises.sqlite");
+    case Binary:
+        break;
+    }
+    return std::make_unique<BinaryStorage>(directory + "/exercises.wsdb", directory + "/exercises.journal");
+}
+
+QString StorageBackend::kindName(Kind kind) {
+    return kind == Sqlite ? QStringLiteral("sqlite") : QStringLiteral("binary");
+}
+
+StorageBackend::Kind StorageBackend::kindFromName(const QString& name, Kind fallback) {
+    if (name == QLatin1String("sqlite"))
+        return Sqlite;
+    if (name == QLatin1String("binary"))
+        return Binary;
+    return fallback;
+}
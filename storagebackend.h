@@ -0,0 +1,56 @@
+#ifndef STORAGEBACKEND_H
+#define STORAGEBACKEND_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+#include <memory>
+#include "exercisestore.h"
+
+// Dónde se guardan los ejercicios. PersistenceWorker usa una implementación
+// desde su hilo: cada mutación confirmada llega a append() y, pasado el
+// periodo sin cambios de DataCenter, el almacén completo a writeSnapshot().
+// Tras una carga, el almacén refleja la secuencia devuelta y los registros de
+// journal se aplican encima.
+//
+//   Binary  snapshot mapeable (BinarySnapshot) + diario de mutaciones
+//   Sqlite  base de datos SQLite en modo WAL; cada mutación se escribe fila a fila
+class StorageBackend
+{
+public:
+    enum Kind { Binary, Sqlite };
+
+    // Clave de QSettings con el motor elegido (kindName)
+    static constexpr auto kSettingsKey = "storage/backend";
+
+    struct LoadResult {
+        ExerciseStore store;
+        qint64 sequence = 0;
+        QList<QJsonObject> journal;
+        bool snapshotFound = false;
+    };
+
+    virtual ~StorageBackend() = default;
+
+    virtual Kind kind() const = 0;
+    // Hay datos de este motor en disco (no se abre ni se crea nada)
+    virtual bool exists() const = 0;
+
+    virtual LoadResult load() = 0;
+    virtual bool append(const QJsonObject& record) = 0;
+    virtual bool writeSnapshot(const ExerciseStore& store, qint64 sequence) = 0;
+    // Borra todo lo guardado
+    virtual bool clear() = 0;
+
+    // Snapshot mapeable con el último estado escrito, si el motor lo tiene.
+    // Sólo abre el fichero; el mapeo resultante se puede usar desde cualquier hilo
+    virtual QSharedPointer<const BinarySnapshot> mapSnapshot() const { return {}; }
+
+    static std::unique_ptr<StorageBackend> create(Kind kind, const QString& directory);
+    static QString kindName(Kind kind);
+    static Kind kindFromName(const QString& name, Kind fallback = Binary);
+    static QList<Kind> kinds() { return {Binary, Sqlite}; }
+};
+
+#endif // STORAGEBACKEND_H
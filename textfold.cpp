@@ -0,0 +1,28 @@
+#include "textfold.h"
+
+namespace TextFold {
+
+bool isAscii(QStringView text) {
+    for (QChar ch : text) {
+        if (ch.unicode() >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+QString fold(QStringView text) {
+    if (isAscii(text))
+        return text.toString().toLower();
+
+    // NFD separa la letra base de sus marcas (á -> a + ´); las marcas se descartan
+    const QString decomposed = text.toString().normalized(QString::NormalizationForm_D);
+    QString folded;
+    folded.reserve(decomposed.size());
+    for (QChar ch : decomposed) {
+        if (ch.category() != QChar::Mark_NonSpacing)
+            folded.append(ch.toCaseFolded());
+    }
+    return folded;
+}
+
+} // namespace TextFold
@@ -0,0 +1,18 @@
+#ifndef TEXTFOLD_H
+#define TEXTFOLD_H
+
+#include <QString>
+#include <QStringView>
+
+// Normalización de texto para búsquedas: minúsculas y sin diacríticos, de
+// modo que "Press de HOMBRO" y "press de hombro" coinciden, y lo mismo
+// "Elevación" y "elevacion". Las cadenas ASCII (casi todo el catálogo) no
+// pasan por la normalización Unicode.
+namespace TextFold {
+
+QString fold(QStringView text);
+bool isAscii(QStringView text);
+
+} // namespace TextFold
+
+#endif // TEXTFOLD_H
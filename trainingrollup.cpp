@@ -0,0 +1,238 @@
+#include "trainingrollup.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QtAlgorithms>
+#include <algorithm>
+
+namespace {
+// Cambia si cambia lo que se guarda en serialize()
+constexpr quint32 kFormat = 1;
+constexpr int kWordBits = 64;
+}
+
+int TrainingRollup::periodKey(Period period, const QDate& date) {
+    // El día juliano 0 es lunes: las semanas empiezan en lunes
+    if (period == Week)
+        return int(date.toJulianDay() / 7);
+    return date.year() * 12 + date.month() - 1;
+}
+
+QDate TrainingRollup::periodStart(Period period, int key) {
+    if (period == Week)
+        return QDate::fromJulianDay(qint64(key) * 7);
+    return QDate(key / 12, key % 12 + 1, 1);
+}
+
+void TrainingRollup::add(qint64 timestamp, int muscleGroupId, int sets, int repetitions, double volume) {
+    const qint64 day = QDateTime::fromMSecsSinceEpoch(timestamp).date().toJulianDay();
+    apply(day, muscleGroupId, sets, repetitions, volume, 1);
+}
+
+void TrainingRollup::remove(qint64 timestamp, int muscleGroupId, int sets, int repetitions, double volume) {
+    const qint64 day = QDateTime::fromMSecsSinceEpoch(timestamp).date().toJulianDay();
+    apply(day, muscleGroupId, sets, repetitions, volume, -1);
+}
+
+void TrainingRollup::apply(qint64 day, int muscleGroupId, int sets, int repetitions, double volume, int sign) {
+    const quint64 key = dayGroupKey(day, muscleGroupId);
+    auto dayGroup = m_dayGroups.find(key);
+    if (sign < 0 && dayGroup == m_dayGroups.end())
+        return;
+    if (dayGroup == m_dayGroups.end())
+        dayGroup = m_dayGroups.insert(key, 0);
+
+    // Una sesión es un día con algún registro del grupo
+    int sessionDelta = 0;
+    dayGroup.value() += sign;
+    if (dayGroup.value() == 1 && sign > 0)
+        sessionDelta = 1;
+    if (dayGroup.value() == 0) {
+        sessionDelta = -1;
+        m_dayGroups.erase(dayGroup);
+    }
+
+    int& records = m_days[day];
+    records += sign;
+    if (records == 1 && sign > 0)
+        setDayBit(day, true);
+    if (records <= 0) {
+        m_days.remove(day);
+        setDayBit(day, false);
+    }
+
+    const QDate date = QDate::fromJulianDay(day);
+    applyBucket(m_weeks, periodKey(Week, date), muscleGroupId, sets, repetitions, volume, sign, sessionDelta);
+    applyBucket(m_months, periodKey(Month, date), muscleGroupId, sets, repetitions, volume, sign, sessionDelta);
+}
+
+void TrainingRollup::applyBucket(QMap<int, QList<Bucket>>& map, int key, int muscleGroupId, int sets,
+                                 int repetitions, double volume, int sign, int sessionDelta) {
+    QList<Bucket>& groups = map[key];
+    if (groups.size() <= muscleGroupId)
+        groups.resize(muscleGroupId + 1);
+
+    Bucket& bucket = groups[muscleGroupId];
+    bucket.records += sign;
+    bucket.sets += sign * sets;
+    bucket.repetitions += sign * repetitions;
+    bucket.sessions += sessionDelta;
+    // Vacío se deja a cero para no arrastrar errores de redondeo
+    bucket.volume = bucket.records > 0 ? bucket.volume + sign * volume : 0;
+
+    if (bucket.records == 0
+        && std::all_of(groups.cbegin(), groups.cend(), [](const Bucket& b) { return b.records == 0; }))
+        map.remove(key);
+}
+
+void TrainingRollup::setDayBit(qint64 day, bool on) {
+    if (!on) {
+        const qint64 index = day - m_firstDay;
+        if (index >= 0 && index / kWordBits < m_dayBits.size())
+            m_dayBits[index / kWordBits] &= ~(quint64(1) << (index % kWordBits));
+        return;
+    }
+
+    const qint64 aligned = day - day % kWordBits;
+    if (m_dayBits.isEmpty()) {
+        m_firstDay = aligned;
+    } else if (aligned < m_firstDay) {
+        m_dayBits.insert(0, (m_firstDay - aligned) / kWordBits, 0);
+        m_firstDay = aligned;
+    }
+
+    const qint64 index = day - m_firstDay;
+    if (index / kWordBits >= m_dayBits.size())
+        m_dayBits.resize(index / kWordBits + 1);
+    m_dayBits[index / kWordBits] |= quint64(1) << (index % kWordBits);
+}
+
+int TrainingRollup::trainingDays(const QDate& from, const QDate& to) const {
+    if (m_dayBits.isEmpty() || !from.isValid() || !to.isValid())
+        return 0;
+
+    const qint64 lastBit = m_firstDay + qint64(m_dayBits.size()) * kWordBits - 1;
+    const qint64 first = std::max(from.toJulianDay(), m_firstDay) - m_firstDay;
+    const qint64 last = std::min(to.toJulianDay(), lastBit) - m_firstDay;
+    if (first > last)
+        return 0;
+
+    int days = 0;
+    for (qint64 word = first / kWordBits; word <= last / kWordBits; ++word) {
+        quint64 bits = m_dayBits.at(word);
+        if (word == first / kWordBits)
+            bits &= ~quint64(0) << (first % kWordBits);
+        if (word == last / kWordBits && last % kWordBits != kWordBits - 1)
+            bits &= (quint64(1) << (last % kWordBits + 1)) - 1;
+        days += qPopulationCount(bits);
+    }
+    return days;
+}
+
+QList<int> TrainingRollup::dailyActivity(const QDate& from, const QDate& to) const {
+    QList<int> activity;
+    if (!from.isValid() || !to.isValid() || from > to)
+        return activity;
+
+    activity.reserve(from.daysTo(to) + 1);
+    for (qint64 day = from.toJulianDay(); day <= to.toJulianDay(); ++day)
+        activity.append(m_days.value(day));
+    return activity;
+}
+
+QMap<int, QList<TrainingRollup::Bucket>> TrainingRollup::buckets(Period period, const QDate& from,
+                                                                 const QDate& to) const {
+    QMap<int, QList<Bucket>> result;
+    if (!from.isValid() || !to.isValid())
+        return result;
+
+    const QMap<int, QList<Bucket>>& map = period == Week ? m_weeks : m_months;
+    const int last = periodKey(period, to);
+    for (auto it = map.lowerBound(periodKey(period, from)); it != map.cend() && it.key() <= last; ++it)
+        result.insert(it.key(), it.value());
+    return result;
+}
+
+QByteArray TrainingRollup::serialize(const QStringList& groups) const {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_5);
+    out << kFormat << groups;
+
+    out << quint32(m_dayGroups.size());
+    for (auto it = m_dayGroups.cbegin(); it != m_dayGroups.cend(); ++it)
+        out << qint64(it.key() >> 16) << qint32(it.key() & 0xffff) << qint32(it.value());
+
+    for (const QMap<int, QList<Bucket>>* map : {&m_weeks, &m_months}) {
+        out << quint32(map->size());
+        for (auto it = map->cbegin(); it != map->cend(); ++it) {
+            out << qint32(it.key()) << quint32(it.value().size());
+            for (const Bucket& bucket : it.value())
+                out << bucket.sets << bucket.repetitions << bucket.volume << qint32(bucket.sessions) << qint32(bucket.records);
+        }
+    }
+    return data;
+}
+
+bool TrainingRollup::deserialize(const QByteArray& data, const std::function<int(const QString&)>& intern,
+                                 TrainingRollup* rollup) {
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_5);
+
+    quint32 format = 0;
+    QStringList groups;
+    in >> format >> groups;
+    if (in.status() != QDataStream::Ok || format != kFormat)
+        return false;
+
+    QList<int> ids;
+    ids.reserve(groups.size());
+    for (const QString& group : groups)
+        ids.append(intern(group));
+    auto remap = [&ids](qint32 id) { return id >= 0 && id < ids.size() ? ids.at(id) : -1; };
+
+    TrainingRollup result;
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        qint64 day = 0;
+        qint32 group = 0, records = 0;
+        in >> day >> group >> records;
+        const int id = remap(group);
+        if (id < 0 || records <= 0)
+            return false;
+        result.m_dayGroups[dayGroupKey(day, id)] += records;
+        if ((result.m_days[day] += records) == records)
+            result.setDayBit(day, true);
+    }
+
+    for (QMap<int, QList<Bucket>>* map : {&result.m_weeks, &result.m_months}) {
+        in >> count;
+        for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+            qint32 key = 0;
+            quint32 size = 0;
+            in >> key >> size;
+            QList<Bucket>& target = (*map)[key];
+            for (quint32 g = 0; g < size && in.status() == QDataStream::Ok; ++g) {
+                Bucket bucket;
+                qint32 sessions = 0, records = 0;
+                in >> bucket.sets >> bucket.repetitions >> bucket.volume >> sessions >> records;
+                bucket.sessions = sessions;
+                bucket.records = records;
+                const int id = remap(qint32(g));
+                if (records == 0)
+                    continue;
+                if (id < 0)
+                    return false;
+                if (target.size() <= id)
+                    target.resize(id + 1);
+                target[id] = bucket;
+            }
+        }
+    }
+
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    *rollup = result;
+    return true;
+}
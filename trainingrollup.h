@@ -0,0 +1,68 @@
+#ifndef TRAININGROLLUP_H
+#define TRAININGROLLUP_H
+
+#include <QByteArray>
+#include <QDate>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QStringList>
+#include <functional>
+
+// Resúmenes por tiempo de todo el historial: un bitset con los días con algún
+// registro y, por semana y por mes, un tramo por grupo muscular con series,
+// repeticiones, volumen y sesiones (días distintos). Se actualiza con cada
+// registro añadido o borrado, así que las consultas por rango recorren sólo los
+// tramos del rango. Va guardado en el snapshot para no rehacerlo al arrancar.
+class TrainingRollup
+{
+public:
+    enum Period { Week, Month };
+
+    struct Bucket {
+        qint64 sets = 0;
+        qint64 repetitions = 0;
+        double volume = 0;   // en kg si hay peso
+        int sessions = 0;
+        int records = 0;
+    };
+
+    // Volumen ya calculado por el almacén (valor normalizado × series × repeticiones)
+    void add(qint64 timestamp, int muscleGroupId, int sets, int repetitions, double volume);
+    void remove(qint64 timestamp, int muscleGroupId, int sets, int repetitions, double volume);
+    bool isEmpty() const { return m_dayGroups.isEmpty(); }
+
+    // Días con algún registro en [from, to]: O(días / 64)
+    int trainingDays(const QDate& from, const QDate& to) const;
+    // Registros de cada día de [from, to], para el calendario
+    QList<int> dailyActivity(const QDate& from, const QDate& to) const;
+    // Tramos de [from, to] (inclusive) indexados por grupo muscular
+    QMap<int, QList<Bucket>> buckets(Period period, const QDate& from, const QDate& to) const;
+    static QDate periodStart(Period period, int key);
+    static int periodKey(Period period, const QDate& date);
+
+    // groups traduce los ids de grupo a nombres al guardar; intern los vuelve
+    // a traducir al cargar, porque el almacén que lee puede tener otros ids
+    QByteArray serialize(const QStringList& groups) const;
+    static bool deserialize(const QByteArray& data, const std::function<int(const QString&)>& intern,
+                            TrainingRollup* rollup);
+
+private:
+    // Registros por (día juliano, grupo): saber cuándo un día deja de contar
+    QHash<quint64, int> m_dayGroups;
+    QHash<qint64, int> m_days;
+    QMap<int, QList<Bucket>> m_weeks;
+    QMap<int, QList<Bucket>> m_months;
+
+    // Bitset de días con actividad a partir de m_firstDay (múltiplo de 64)
+    qint64 m_firstDay = 0;
+    QList<quint64> m_dayBits;
+
+    static quint64 dayGroupKey(qint64 day, int muscleGroupId) { return (quint64(day) << 16) | quint16(muscleGroupId); }
+    void apply(qint64 day, int muscleGroupId, int sets, int repetitions, double volume, int sign);
+    void setDayBit(qint64 day, bool on);
+    static void applyBucket(QMap<int, QList<Bucket>>& map, int key, int muscleGroupId, int sets,
+                            int repetitions, double volume, int sign, int sessionDelta);
+};
+
+#endif // TRAININGROLLUP_H
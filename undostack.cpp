@@ -0,0 +1,122 @@
+#include "undostack.h"
+#include "logging.h"
+#include <algorithm>
+
+namespace {
+// Columnas de un registro materializado: fecha, valor, series, repeticiones y unidad
+constexpr qint64 kRecordBytes = sizeof(qint64) + sizeof(double) + 2 * sizeof(qint16) + sizeof(quint8);
+
+qint64 exerciseCost(const ExerciseStore::Exercise& exercise) {
+    const qint64 records = exercise.history.isMapped() ? 0 : exercise.history.size();
+    return qint64(sizeof(ExerciseStore::Exercise)) + records * kRecordBytes;
+}
+}
+
+void UndoStack::Step::addRecord(Change::Type type, const QString& name, const ExerciseStore::Record& record) {
+    Change change;
+    change.type = type;
+    change.name = name;
+    change.record = record;
+    changes.append(change);
+}
+
+void UndoStack::Step::addExercise(Change::Type type, const ExerciseStore::Exercise& exercise) {
+    Change change;
+    change.type = type;
+    change.name = exercise.name;
+    change.exercise = int(exercises.size());
+    changes.append(change);
+    exercises.append(capture(exercise));
+}
+
+void UndoStack::Step::invert() {
+    std::reverse(changes.begin(), changes.end());
+    for (Change& change : changes) {
+        switch (change.type) {
+        case Change::AddRecord: change.type = Change::RemoveRecord; break;
+        case Change::RemoveRecord: change.type = Change::AddRecord; break;
+        case Change::AddExercise: change.type = Change::RemoveExercise; break;
+        case Change::RemoveExercise: change.type = Change::AddExercise; break;
+        }
+    }
+}
+
+ExerciseStore::Exercise UndoStack::capture(const ExerciseStore::Exercise& exercise) {
+    ExerciseStore::Exercise copy = exercise;
+    copy.history.materialize();
+    copy.stats.invalidate();
+    return copy;
+}
+
+qint64 UndoStack::estimateCost(const Step& step) {
+    // Cota superior: no tiene en cuenta lo que se comparte con el almacén
+    qint64 cost = qint64(sizeof(Step)) + step.changes.size() * qint64(sizeof(Change));
+    for (const ExerciseStore::Exercise& exercise : step.exercises)
+        cost += exerciseCost(exercise);
+    if (step.store) {
+        for (int row = 0; row < step.store->count(); ++row)
+            cost += exerciseCost(step.store->at(row));
+    }
+    return cost;
+}
+
+void UndoStack::setBudget(qint64 bytes) {
+    m_budget = qMax<qint64>(0, bytes);
+    trim();
+}
+
+void UndoStack::push(Step step) {
+    for (const Step& redo : std::as_const(m_redo))
+        m_usage -= redo.cost;
+    m_redo.clear();
+    pushUndo(std::move(step));
+}
+
+UndoStack::Step UndoStack::takeUndo() {
+    Step step = m_undo.takeLast();
+    m_usage -= step.cost;
+    return step;
+}
+
+UndoStack::Step UndoStack::takeRedo() {
+    Step step = m_redo.takeLast();
+    m_usage -= step.cost;
+    return step;
+}
+
+void UndoStack::pushUndo(Step step) {
+    step.cost = estimateCost(step);
+    m_usage += step.cost;
+    m_undo.append(std::move(step));
+    trim();
+}
+
+void UndoStack::pushRedo(Step step) {
+    step.cost = estimateCost(step);
+    m_usage += step.cost;
+    m_redo.append(std::move(step));
+    trim();
+}
+
+void UndoStack::clear() {
+    m_undo.clear();
+    m_redo.clear();
+    m_usage = 0;
+}
+
+void UndoStack::trim() {
+    // Primero lo más antiguo que se puede deshacer y después lo más lejano que
+    // se puede rehacer: los pasos que quedan siguen siendo aplicables en orden
+    int dropped = 0;
+    while (m_usage > m_budget && !m_undo.isEmpty()) {
+        m_usage -= m_undo.takeFirst().cost;
+        ++dropped;
+    }
+    while (m_usage > m_budget && !m_redo.isEmpty()) {
+        m_usage -= m_redo.takeFirst().cost;
+        ++dropped;
+    }
+
+    if (dropped > 0)
+        qCDebug(lcData) << "UndoStack:" << dropped << "pasos descartados por el presupuesto de memoria";
+}
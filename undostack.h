@@ -0,0 +1,72 @@
+#ifndef UNDOSTACK_H
+#define UNDOSTACK_H
+
+#include <QList>
+#include <optional>
+#include "exercisestore.h"
+
+// Pilas de deshacer y rehacer de DataCenter. Cada paso guarda sólo lo que
+// cambió: los registros añadidos o borrados y, cuando se crea o se borra un
+// ejercicio entero, su Exercise. Las columnas del historial son implícitamente
+// compartidas con el almacén, así que apilar un ejercicio no copia registros
+// hasta que uno de los dos lo modifica. Los reinicios (borrar todo, datos de
+// ejemplo) guardan el almacén anterior completo, que también es una copia
+// compartida.
+//
+// Cada paso tiene un coste estimado en bytes; cuando la suma supera el
+// presupuesto se descartan los pasos más antiguos.
+class UndoStack
+{
+public:
+    static constexpr qint64 kDefaultBudget = 16 * 1024 * 1024;
+
+    struct Change {
+        enum Type { AddRecord, RemoveRecord, AddExercise, RemoveExercise };
+        Type type = AddRecord;
+        QString name;
+        ExerciseStore::Record record; // AddRecord, RemoveRecord
+        int exercise = -1;            // AddExercise, RemoveExercise: índice en Step::exercises
+    };
+
+    struct Step {
+        QList<Change> changes;
+        QList<ExerciseStore::Exercise> exercises;
+        std::optional<ExerciseStore> store; // reinicio: el almacén del otro lado
+        qint64 cost = 0;
+
+        bool isEmpty() const { return changes.isEmpty() && !store; }
+        void addRecord(Change::Type type, const QString& name, const ExerciseStore::Record& record);
+        void addExercise(Change::Type type, const ExerciseStore::Exercise& exercise);
+        // Cambios contrarios en orden inverso: deshace lo que hacía el paso
+        void invert();
+    };
+
+    // Copia para apilar: sin vista mapeada (el snapshot puede cambiar antes
+    // de usarla) ni agregados, que se recalculan si se restaura
+    static ExerciseStore::Exercise capture(const ExerciseStore::Exercise& exercise);
+    static qint64 estimateCost(const Step& step);
+
+    bool canUndo() const { return !m_undo.isEmpty(); }
+    bool canRedo() const { return !m_redo.isEmpty(); }
+    qint64 budget() const { return m_budget; }
+    void setBudget(qint64 bytes);
+    qint64 usage() const { return m_usage; }
+
+    // Un cambio nuevo descarta lo que se podía rehacer
+    void push(Step step);
+    Step takeUndo();
+    Step takeRedo();
+    void pushUndo(Step step);
+    void pushRedo(Step step);
+    void clear();
+
+private:
+    QList<Step> m_undo; // el más reciente al final
+    QList<Step> m_redo;
+    qint64 m_budget = kDefaultBudget;
+    qint64 m_usage = 0;
+
+    void trim();
+};
+
+#endif // UNDOSTACK_H